@@ -0,0 +1,124 @@
+#include "ActiveTiles.h"
+#include "LifeKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+ActiveTileEngine::ActiveTileEngine(int rowsPerTile, int wordsPerTile)
+    : tileRows(rowsPerTile > 0 ? rowsPerTile : 1),
+      tileWords(wordsPerTile > 0 ? wordsPerTile : 1),
+      tilesY(0), tilesX(0), height(0), width(0), nextTile(0), changedTiles(0), gridHash(0) {}
+
+void ActiveTileEngine::reset(int h, int w) {
+    height = h;
+    width = w;
+    int words = (w + 63) / 64;
+    tilesY = (h + tileRows - 1) / tileRows;
+    tilesX = (words + tileWords - 1) / tileWords;
+
+    // Beim ersten Schritt sind beide Puffer noch unabhängig, daher wird alles berechnet.
+    changed.assign(static_cast<size_t>(tilesY) * tilesX, 1);
+    nextChanged.assign(changed.size(), 0);
+    tileHash.assign(changed.size(), 0);
+    tileStats.assign(changed.size(), StepStats());
+    gridHash = 0;
+    active.clear();
+    active.reserve(changed.size());
+    changedTiles = static_cast<int>(changed.size());
+}
+
+void ActiveTileEngine::buildActiveList() {
+    // Eine Kachel ist aktiv, wenn sie oder eine ihrer 8 Nachbarkacheln (toroidal) sich verändert hat.
+    active.clear();
+    for (int ty = 0; ty < tilesY; ++ty) {
+        int up = (ty - 1 + tilesY) % tilesY;
+        int down = (ty + 1) % tilesY;
+        for (int tx = 0; tx < tilesX; ++tx) {
+            int left = (tx - 1 + tilesX) % tilesX;
+            int right = (tx + 1) % tilesX;
+            const int rows[3] = { up, ty, down };
+            bool isActive = false;
+            for (int r : rows) {
+                const uint8_t* line = &changed[static_cast<size_t>(r) * tilesX];
+                if (line[left] | line[tx] | line[right]) {
+                    isActive = true;
+                    break;
+                }
+            }
+            if (isActive) {
+                active.push_back(ty * tilesX + tx);
+            }
+        }
+    }
+}
+
+StepStats ActiveTileEngine::evolveTile(const BitGrid &src, BitGrid &dst, int tile) {
+    int ty = tile / tilesX;
+    int tx = tile % tilesX;
+    int rowBegin = ty * tileRows;
+    int rowEnd = rowBegin + tileRows < height ? rowBegin + tileRows : height;
+    int n = src.getWordsPerRow();
+    int wordBegin = tx * tileWords;
+    int wordEnd = wordBegin + tileWords < n ? wordBegin + tileWords : n;
+
+    // Neue Werte berechnen und gleichzeitig veränderte Zellen und Hash der Kachel bestimmen.
+    StepStats stats;
+    for (int x = rowBegin; x < rowEnd; ++x) {
+        const uint64_t* up = src.row((x - 1 + height) % height);
+        const uint64_t* mid = src.row(x);
+        const uint64_t* down = src.row((x + 1) % height);
+        uint64_t* out = dst.row(x);
+        evolveRowRange(up, mid, down, out, n, width, wordBegin, wordEnd, rule);
+        accumulateWords(mid + wordBegin, out + wordBegin, wordEnd - wordBegin,
+                        static_cast<uint64_t>(x) * n + wordBegin, stats);
+    }
+    return stats;
+}
+
+StepStats ActiveTileEngine::step(const BitGrid &src, BitGrid &dst, ThreadPool *pool) {
+    if (src.getHeight() != height || src.getWidth() != width) {
+        reset(src.getHeight(), src.getWidth());
+    }
+    if (height == 0 || width == 0) {
+        return StepStats();
+    }
+
+    buildActiveList();
+    std::fill(nextChanged.begin(), nextChanged.end(), 0);
+    nextTile.store(0, std::memory_order_relaxed);
+
+    // Jeder Thread holt sich so lange Pakete von Kacheln, bis die Liste abgearbeitet ist.
+    int total = static_cast<int>(active.size());
+    auto worker = [&](int) {
+        while (true) {
+            int first = nextTile.fetch_add(CHUNK_TILES, std::memory_order_relaxed);
+            if (first >= total) {
+                break;
+            }
+            int last = first + CHUNK_TILES < total ? first + CHUNK_TILES : total;
+            for (int i = first; i < last; ++i) {
+                int tile = active[i];
+                tileStats[tile] = evolveTile(src, dst, tile);
+                nextChanged[tile] = tileStats[tile].changed != 0 ? 1 : 0;
+            }
+        }
+    };
+
+    if (pool != nullptr && pool->size() > 1 && total > CHUNK_TILES) {
+        pool->run(worker);
+    } else {
+        worker(0);
+    }
+
+    // Nur aktive Kacheln können sich verändert haben; der Hash wird um ihre Differenz fortgeschrieben.
+    StepStats stats;
+    changedTiles = 0;
+    for (int tile : active) {
+        changedTiles += nextChanged[tile];
+        stats.changed += tileStats[tile].changed;
+        gridHash += tileStats[tile].hash - tileHash[tile];
+        tileHash[tile] = tileStats[tile].hash;
+    }
+    changed.swap(nextChanged);
+    stats.hash = gridHash;
+    return stats;
+}
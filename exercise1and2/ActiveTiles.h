@@ -0,0 +1,59 @@
+#ifndef ACTIVETILES_H
+#define ACTIVETILES_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "BitGrid.h"
+#include "LifeKernels.h"
+
+class ThreadPool;
+
+// Kachelbasierte CPU-Engine, die ruhende Bereiche überspringt.
+// Das Gitter wird in Kacheln aus tileRows Zeilen x tileWords Wörtern zerlegt. Zu jeder Kachel wird
+// gemerkt, ob sie sich in der letzten Generation verändert hat; neu berechnet werden nur Kacheln,
+// die selbst oder deren 8 Nachbarkacheln sich verändert haben. Für übersprungene Kacheln enthalten
+// beide Generationspuffer bereits denselben Inhalt, sie kosten also nur die Prüfung ihres Bits.
+// Die aktiven Kacheln werden dynamisch über einen gemeinsamen Zähler an die Threads verteilt,
+// da sich die Aktivität meist an wenigen Stellen häuft.
+// Der Hash des Gitters wird aus den Hashes der Kacheln fortgeschrieben: nur aktive Kacheln können
+// ihren Beitrag ändern, übersprungene Kacheln kosten also auch hier nichts.
+class ActiveTileEngine {
+    private:
+        int tileRows, tileWords;
+        int tilesY, tilesX;
+        int height, width;
+        Rule rule;
+        std::vector<uint8_t> changed;      // Kachel hat sich in der letzten Generation verändert
+        std::vector<uint8_t> nextChanged;  // wird während der aktuellen Generation gefüllt
+        std::vector<int> active;           // Liste der zu berechnenden Kacheln
+        std::vector<uint64_t> tileHash;    // Hash-Beitrag jeder Kachel zur aktuellen Generation
+        std::vector<StepStats> tileStats;  // Ergebnis der aktiven Kacheln im aktuellen Schritt
+        std::atomic<int> nextTile;
+        int changedTiles;                  // Anzahl veränderter Kacheln im letzten Schritt
+        uint64_t gridHash;                 // Summe aller Kachel-Hashes
+
+        void buildActiveList();
+        StepStats evolveTile(const BitGrid &src, BitGrid &dst, int tile);
+
+    public:
+        static const int CHUNK_TILES = 4;  // so viele Kacheln holt sich ein Thread auf einmal
+
+        ActiveTileEngine(int rowsPerTile = 32, int wordsPerTile = 4);
+
+        void setRule(const Rule &newRule) { rule = newRule; }
+
+        // Bereitet die Engine für ein Gitter vor; alle Kacheln gelten danach als verändert.
+        void reset(int h, int w);
+
+        // Berechnet die nächste Generation von src in dst. Ohne Pool wird im aufrufenden Thread gerechnet.
+        // Liefert die veränderten Zellen und den Hash der neuen Generation wie evolveRows().
+        StepStats step(const BitGrid &src, BitGrid &dst, ThreadPool *pool);
+
+        int activeTileCount() const { return static_cast<int>(active.size()); }
+        int tileCount() const { return tilesX * tilesY; }
+        // Ohne veränderte Kachel ist das Gitter stabil; das erspart den Vergleich der ganzen Generation.
+        int changedTileCount() const { return changedTiles; }
+};
+
+#endif // ACTIVETILES_H
@@ -0,0 +1,253 @@
+#include "AutoTuner.h"
+#include "LifeKernels.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <cstdlib>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <winsock2.h>  // gethostname
+#else
+#include <unistd.h>    // gethostname
+#endif
+
+AutoTuner::AutoTuner(const std::string &path) : cachePath(path), budgetMs(60), verbose(true) {}
+
+std::string AutoTuner::defaultCachePath() {
+    const char* path = std::getenv("GOL_TUNE_CACHE");
+    if (path != nullptr && *path != '\0') {
+        return path;
+    }
+    const char* home = std::getenv("HOME");
+    if (home != nullptr && *home != '\0') {
+        return std::string(home) + "/.gol_autotune";
+    }
+    return "gol_autotune.txt";
+}
+
+std::string AutoTuner::machineKey() {
+    char host[256] = "unknown";
+    if (gethostname(host, sizeof(host)) != 0) {
+        std::snprintf(host, sizeof(host), "unknown");
+    }
+    host[sizeof(host) - 1] = '\0';
+
+    std::ostringstream key;
+    key << host << "/" << simdLevelName(detectSimdLevel()) << "/" << std::thread::hardware_concurrency() << "t";
+    // Die Kennung ist das erste Feld einer Zeile der Cache-Datei und darf keine Leerzeichen enthalten.
+    std::string result = key.str();
+    std::replace(result.begin(), result.end(), ' ', '_');
+    return result;
+}
+
+std::vector<AutoTuner::Choice> AutoTuner::candidates(int height, int width, const EngineParams &base) const {
+    // Thread-Anzahlen: Zweierpotenzen bis zur Anzahl der Hardware-Threads und diese selbst.
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    std::vector<int> threads;
+    for (int t = 1; t < hardware; t *= 2) {
+        threads.push_back(t);
+    }
+    threads.push_back(hardware > 0 ? hardware : 1);
+
+    std::vector<Choice> list;
+    auto add = [&](const char* engine, int t, int rows, int words, int generations) {
+        Choice c{engine, base, 0, false};
+        c.params.threads = t;
+        c.params.tileRows = rows;
+        c.params.tileWords = words;
+        c.params.generationsPerPass = generations;
+        list.push_back(c);
+    };
+
+    for (int t : threads) {
+        add("bitwise", t, 0, 0, 1);
+        add("in-place", t, 0, 0, 1);
+        add("lookup-table", t, 0, 0, 1);
+        for (int rows : {16, 32, 64}) {
+            add("active-tiles", t, rows, rows / 8, 1);
+        }
+        for (int generations : {4, 8, 16}) {
+            add("temporal-blocking", t, 128, 32, generations);
+            add("temporal-blocking", t, 64, 16, generations);
+        }
+    }
+    if (EvolveEngine::supports("hashlife", height, width) && EvolveEngine::supports("hashlife", base.rule)) {
+        for (int generations : {1, 8, 64}) {
+            add("hashlife", 1, 0, 0, generations);
+        }
+    }
+
+    // OpenCL: Standard des Geräts und einige typische Gruppengrößen für CPUs und GPUs.
+    const int groups[][3] = { {0, 0, 0}, {16, 8, 4}, {32, 8, 2}, {16, 4, 16}, {64, 4, 1} };
+    for (const int* g : groups) {
+        Choice c{"opencl", base, 0, false};
+        c.params.localX = g[0];
+        c.params.localY = g[1];
+        c.params.cellsPerItem = g[2];
+        list.push_back(c);
+    }
+    return list;
+}
+
+double AutoTuner::measure(const Choice &candidate, BitGrid &current, BitGrid &next) const {
+    std::unique_ptr<EvolveEngine> engine(EvolveEngine::create(candidate.engine, candidate.params));
+    if (!engine) {
+        return 0;
+    }
+    // Jeder Kandidat beginnt mit derselben Belegung. Den zweiten Puffer legt die Engine selbst an
+    // oder gibt ihn frei (in-place), so belegt die Messung nie mehr Speicher als der spätere Lauf.
+    current.fillRandom(0.35, 42);
+    if (!engine->attach(current, next)) {
+        return 0;
+    }
+
+    // Erster Schritt ungemessen: Seiten berühren, Tabellen und Caches füllen.
+    StepStats stats;
+    int perStep = engine->generationsPerStep();
+    if (engine->step(perStep, &stats) == 0 || !engine->finish()) {
+        return 0;
+    }
+
+    // Gemessen wird wie in Grid::run() mit Statistik; mindestens budgetMs und drei Schritte.
+    std::vector<double> samples;
+    auto begin = std::chrono::steady_clock::now();
+    auto budget = std::chrono::milliseconds(budgetMs);
+    while (samples.size() < 3 || std::chrono::steady_clock::now() - begin < budget) {
+        auto stepBegin = std::chrono::steady_clock::now();
+        int advanced = engine->step(perStep, &stats);
+        if (advanced == 0 || !engine->finish()) {
+            return 0;
+        }
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - stepBegin).count());
+        samples.push_back(ns / advanced);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+bool AutoTuner::lookup(int height, int width, const EngineParams &base, Choice &choice) const {
+    if (cachePath.empty()) {
+        return false;
+    }
+    std::ifstream file(cachePath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Eine Zeile pro Maschine und Größe:
+    // Kennung HxW Engine Threads Kachelzeilen Kachelwörter Generationen LocalX LocalY Zellen ns/Generation
+    std::string machine = machineKey();
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string key, engine;
+        int h = 0, w = 0;
+        char separator = 0;
+        Choice c{"", base, 0, true};
+        if (!(fields >> key >> h >> separator >> w >> engine >> c.params.threads >> c.params.tileRows
+                     >> c.params.tileWords >> c.params.generationsPerPass >> c.params.localX
+                     >> c.params.localY >> c.params.cellsPerItem >> c.nsPerGeneration)) {
+            continue;  // unvollständige oder fremde Zeilen werden übersprungen
+        }
+        if (key == machine && h == height && w == width && EvolveEngine::exists(engine)
+            && EvolveEngine::supports(engine, base.rule)) {
+            c.engine = engine;
+            choice = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AutoTuner::store(int height, int width, const Choice &choice) const {
+    if (cachePath.empty()) {
+        return true;
+    }
+    std::string machine = machineKey();
+
+    // Vorhandene Einträge anderer Maschinen und Größen bleiben erhalten.
+    std::vector<std::string> lines;
+    std::ifstream in(cachePath);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        int h = 0, w = 0;
+        char separator = 0;
+        if (fields >> key >> h >> separator >> w && key == machine && h == height && w == width) {
+            continue;
+        }
+        lines.push_back(line);
+    }
+    in.close();
+
+    std::ostringstream entry;
+    const EngineParams &p = choice.params;
+    entry << machine << " " << height << "x" << width << " " << choice.engine << " " << p.threads << " "
+          << p.tileRows << " " << p.tileWords << " " << p.generationsPerPass << " " << p.localX << " "
+          << p.localY << " " << p.cellsPerItem << " " << std::fixed << std::setprecision(0) << choice.nsPerGeneration;
+    lines.push_back(entry.str());
+
+    // Erst in eine temporäre Datei schreiben, damit ein abgebrochener Lauf den Cache nicht zerstört.
+    std::string temporary = cachePath + ".tmp";
+    std::ofstream out(temporary);
+    if (!out.is_open()) {
+        std::cerr << "Error writing tuning cache " << temporary << std::endl;
+        return false;
+    }
+    for (const std::string &l : lines) {
+        out << l << "\n";
+    }
+    out.close();
+    if (!out || std::rename(temporary.c_str(), cachePath.c_str()) != 0) {
+        std::cerr << "Error writing tuning cache " << cachePath << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+AutoTuner::Choice AutoTuner::select(int height, int width, const EngineParams &base, bool remeasure) {
+    Choice best{"bitwise", base, 0, false};
+    if (!remeasure && lookup(height, width, base, best)) {
+        return best;
+    }
+
+    BitGrid current(height, width);
+    BitGrid next;
+
+    bool openclFailed = false;
+    for (const Choice &candidate : candidates(height, width, base)) {
+        if (candidate.engine == "opencl" && openclFailed) {
+            continue;  // ohne Gerät müssen die übrigen Gruppengrößen nicht mehr versucht werden
+        }
+        double ns = measure(candidate, current, next);
+        if (ns <= 0) {
+            openclFailed = openclFailed || candidate.engine == "opencl";
+            continue;
+        }
+        if (verbose) {
+            std::cout << "  " << std::left << std::setw(18) << candidate.engine << std::setw(44)
+                      << candidate.params.describe(candidate.engine) << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(12) << ns / 1e3 << " us/generation\n";
+            std::cout.unsetf(std::ios::fixed);
+            std::cout << std::setprecision(6);
+        }
+        if (best.nsPerGeneration == 0 || ns < best.nsPerGeneration) {
+            best = candidate;
+            best.nsPerGeneration = ns;
+        }
+    }
+
+    if (best.nsPerGeneration > 0) {
+        store(height, width, best);
+    }
+    return best;
+}
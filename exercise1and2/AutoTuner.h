@@ -0,0 +1,49 @@
+#ifndef AUTOTUNER_H
+#define AUTOTUNER_H
+
+#include <string>
+#include <vector>
+#include "EvolveEngine.h"
+
+// Sucht für eine Gittergröße auf dieser Maschine die schnellste Engine samt Parametern (Threads,
+// Kachelgröße, Generationen pro Durchlauf, OpenCL-Gruppengröße). Jeder Kandidat rechnet kurz auf
+// einem zufällig belegten Gitter der tatsächlichen Größe; verglichen wird der Median der Zeit pro
+// Generation. Das Ergebnis wird pro Maschine und Größe in einer Textdatei gespeichert, sodass
+// spätere Läufe ohne Messung sofort die richtige Engine verwenden.
+class AutoTuner {
+    public:
+        struct Choice {
+            std::string engine;
+            EngineParams params;
+            double nsPerGeneration;  // gemessener Median; 0, wenn nichts lief
+            bool cached;             // aus der Cache-Datei übernommen
+        };
+
+        // cachePath leer = ohne Cache-Datei.
+        explicit AutoTuner(const std::string &cachePath = defaultCachePath());
+
+        // Liefert die schnellste Engine für ein height x width Gitter. base liefert Werte, die nicht
+        // abgestimmt werden (z.B. den Kernel-Pfad). Mit remeasure wird ein Cache-Eintrag ignoriert.
+        Choice select(int height, int width, const EngineParams &base, bool remeasure = false);
+
+        // Mindestdauer der Messung pro Kandidat.
+        void setBudgetMilliseconds(int ms) { budgetMs = ms > 0 ? ms : 1; }
+        void setVerbose(bool enabled) { verbose = enabled; }
+
+        // $GOL_TUNE_CACHE, sonst $HOME/.gol_autotune, sonst ./gol_autotune.txt.
+        static std::string defaultCachePath();
+        // Kennung der Maschine: Rechnername, SIMD-Stufe und Anzahl der Hardware-Threads.
+        static std::string machineKey();
+
+    private:
+        std::string cachePath;
+        int budgetMs;
+        bool verbose;
+
+        std::vector<Choice> candidates(int height, int width, const EngineParams &base) const;
+        double measure(const Choice &candidate, BitGrid &current, BitGrid &next) const;
+        bool lookup(int height, int width, const EngineParams &base, Choice &choice) const;
+        bool store(int height, int width, const Choice &choice) const;
+};
+
+#endif // AUTOTUNER_H
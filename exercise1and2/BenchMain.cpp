@@ -0,0 +1,147 @@
+#include "Benchmark.h"
+#include "Ensemble.h"
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+// Zerlegt eine kommagetrennte Liste.
+static std::vector<std::string> splitList(const std::string &list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --engines a,b,...    engines to measure (default: all)\n"
+              << "  --sizes HxW,...      grid sizes (default: 1000x1000,4096x4096)\n"
+              << "  --densities d,...    initial live-cell fractions (default: 0.35)\n"
+              << "  --generations n      measured generations per run (default: 100)\n"
+              << "  --warmup n           unmeasured generations before measuring (default: 10)\n"
+              << "  --threads n          CPU threads, 0 for all cores (default: 0)\n"
+              << "  --seed n             seed for the random start state (default: 42)\n"
+              << "  --kernel path        OpenCL kernel file (default: game_of_life.cl)\n"
+              << "  --rule r             rule in B/S notation or by name (default: B3/S23)\n"
+              << "  --json file          write results as JSON\n"
+              << "  --csv file           write results as CSV\n"
+              << "  --ensemble n         instead: run n small random worlds as one Ensemble and print its results\n"
+              << "  --ensemble-size HxW  size of each ensemble world (default: 32x32)\n"
+              << "  --ensemble-device d  cpu or opencl (default: cpu)\n"
+              << "Engines:";
+    for (const std::string &name : Benchmark::engineNames()) {
+        std::cout << " " << name;
+    }
+    std::cout << "\n";
+}
+
+// Viele kleine Welten in einem Ensemble: gemessen wird der ganze Lauf, danach eine CSV-Zeile pro Welt.
+static int runEnsemble(const Benchmark::Config &config, int count, int height, int width, Ensemble::Device device) {
+    Ensemble ensemble;
+    ensemble.setThreadCount(config.threads);
+    ensemble.setRule(config.rule);
+    ensemble.setKernelPath(config.kernelPath);  // wie die Engines der Messreihe
+    ensemble.addRandom(count, height, width, config.densities.empty() ? 0.35 : config.densities[0], config.seed);
+    long long ms = ensemble.run(config.generations, device);
+    if (ms < 0) {
+        return 1;
+    }
+    std::cout << "Ensemble: " << count << " worlds of " << height << "x" << width << ", " << config.generations
+              << " generations, " << ensemble.stableCount() << " stable, " << ms << " ms\n";
+    return ensemble.writeResults(std::cout) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    Benchmark::Config config;
+    int ensembleCount = 0, ensembleHeight = 32, ensembleWidth = 32;
+    Ensemble::Device ensembleDevice = Ensemble::Device::Cpu;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--help" || option == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: missing value for " << option << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        if (option == "--engines") {
+            config.engines = splitList(value);
+        } else if (option == "--sizes") {
+            config.sizes.clear();
+            for (const std::string &size : splitList(value)) {
+                int h = 0, w = 0;
+                char separator = 0;
+                std::istringstream parser(size);
+                if (!(parser >> h >> separator >> w) || separator != 'x' || h <= 0 || w <= 0) {
+                    std::cerr << "Error: invalid size " << size << " (expected HxW)" << std::endl;
+                    return 1;
+                }
+                config.sizes.push_back({h, w});
+            }
+        } else if (option == "--densities") {
+            config.densities.clear();
+            for (const std::string &density : splitList(value)) {
+                config.densities.push_back(std::atof(density.c_str()));
+            }
+        } else if (option == "--generations") {
+            config.generations = std::atoi(value.c_str());
+        } else if (option == "--warmup") {
+            config.warmup = std::atoi(value.c_str());
+        } else if (option == "--threads") {
+            config.threads = std::atoi(value.c_str());
+        } else if (option == "--seed") {
+            config.seed = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (option == "--kernel") {
+            config.kernelPath = value;
+        } else if (option == "--rule") {
+            if (!Rule::parse(value, config.rule)) {
+                std::cerr << "Error: invalid rule " << value << " (expected B/S notation such as B36/S23)" << std::endl;
+                return 1;
+            }
+        } else if (option == "--ensemble") {
+            ensembleCount = std::atoi(value.c_str());
+        } else if (option == "--ensemble-size") {
+            char separator = 0;
+            std::istringstream parser(value);
+            if (!(parser >> ensembleHeight >> separator >> ensembleWidth) || separator != 'x'
+                || ensembleHeight <= 0 || ensembleWidth <= 0) {
+                std::cerr << "Error: invalid size " << value << " (expected HxW)" << std::endl;
+                return 1;
+            }
+        } else if (option == "--ensemble-device") {
+            if (value != "cpu" && value != "opencl") {
+                std::cerr << "Error: invalid device " << value << " (expected cpu or opencl)" << std::endl;
+                return 1;
+            }
+            ensembleDevice = value == "opencl" ? Ensemble::Device::OpenCL : Ensemble::Device::Cpu;
+        } else if (option == "--json") {
+            config.jsonPath = value;
+        } else if (option == "--csv") {
+            config.csvPath = value;
+        } else {
+            std::cerr << "Error: unknown option " << option << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.generations < 1) {
+        config.generations = 1;
+    }
+
+    if (ensembleCount > 0) {
+        return runEnsemble(config, ensembleCount, ensembleHeight, ensembleWidth, ensembleDevice);
+    }
+
+    Benchmark benchmark(config);
+    return benchmark.run() ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+#include "Benchmark.h"
+#include "BitGrid.h"
+#include "LifeKernels.h"
+#include "ThreadPool.h"
+#include "EvolveEngine.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+Benchmark::Config::Config()
+    : sizes{{1000, 1000}, {4096, 4096}}, densities{0.35}, engines(Benchmark::engineNames()),
+      generations(100), warmup(10), threads(0), seed(42), kernelPath("game_of_life.cl") {}
+
+Benchmark::Benchmark(const Config &c) : config(c) {}
+
+std::vector<std::string> Benchmark::engineNames() {
+    return EvolveEngine::names();
+}
+
+static long long elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+Benchmark::Result Benchmark::measure(const std::string &engine, int height, int width, double density) {
+    Result result{engine, height, width, density, ThreadPool::resolveThreadCount(config.threads),
+                  false, 0, 0, 0, 0, 0, 0};
+
+    if (!EvolveEngine::exists(engine)) {
+        std::cerr << "Error: unknown engine " << engine << std::endl;
+        return result;
+    }
+
+    BitGrid current(height, width);
+    BitGrid next(height, width);
+    current.fillRandom(density, config.seed);
+
+    EngineParams params;
+    params.threads = config.threads;
+    params.kernelPath = config.kernelPath;
+    params.rule = config.rule;
+
+    // Kaltstart: alles von der Erzeugung der Engine bis zur fertigen ersten Generation.
+    // Gemessen wird ohne Statistik, also nur die reine Berechnung der Generationen.
+    auto coldBegin = std::chrono::steady_clock::now();
+    std::unique_ptr<EvolveEngine> bench(EvolveEngine::create(engine, params));
+    int perStep = bench->generationsPerStep();
+    if (!bench->attach(current, next) || bench->step(perStep, nullptr) == 0 || !bench->finish()) {
+        return result;
+    }
+    result.coldStartNs = elapsedNs(coldBegin);
+
+    // Aufwärmen: Caches, Seitentabellen und Taktfrequenz sollen eingeschwungen sein.
+    for (int done = 0; done < config.warmup; ) {
+        int advanced = bench->step(perStep, nullptr);
+        if (advanced == 0 || !bench->finish()) {
+            return result;
+        }
+        done += advanced;
+    }
+
+    // Jeder Schritt wird einzeln gemessen; Schritte über mehrere Generationen zählen anteilig.
+    std::vector<double> samples;
+    long long totalNs = 0;
+    while (result.generations < config.generations) {
+        auto begin = std::chrono::steady_clock::now();
+        int advanced = bench->step(perStep, nullptr);
+        if (advanced == 0 || !bench->finish()) {
+            return result;
+        }
+        long long ns = elapsedNs(begin);
+        totalNs += ns;
+        result.generations += advanced;
+        samples.push_back(static_cast<double>(ns) / advanced);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    size_t count = samples.size();
+    result.medianNs = count % 2 ? samples[count / 2] : 0.5 * (samples[count / 2 - 1] + samples[count / 2]);
+    result.p95Ns = samples[std::min(count - 1, (count * 95 + 99) / 100 - 1)];
+    result.meanNs = static_cast<double>(totalNs) / result.generations;
+    result.cellsPerSecond = totalNs > 0 ? 1e9 * static_cast<double>(height) * width * result.generations / totalNs : 0;
+    result.ok = true;
+    return result;
+}
+
+bool Benchmark::run() {
+    measured.clear();
+    std::cout << std::left << std::setw(18) << "engine" << std::setw(13) << "size" << std::setw(9) << "density"
+              << std::right << std::setw(12) << "cold ms" << std::setw(14) << "median us"
+              << std::setw(14) << "p95 us" << std::setw(14) << "Gcells/s" << "\n";
+
+    for (const std::string &engine : config.engines) {
+        for (const std::pair<int, int> &size : config.sizes) {
+            for (double density : config.densities) {
+                if (EvolveEngine::exists(engine) && (!EvolveEngine::supports(engine, size.first, size.second)
+                                                     || !EvolveEngine::supports(engine, config.rule))) {
+                    continue;  // z.B. braucht Hashlife Zweierpotenzen als Kantenlängen
+                }
+                Result r = measure(engine, size.first, size.second, density);
+                measured.push_back(r);
+
+                std::ostringstream dims;
+                dims << size.first << "x" << size.second;
+                std::cout << std::left << std::setw(18) << engine << std::setw(13) << dims.str()
+                          << std::setw(9) << density << std::right << std::fixed << std::setprecision(3);
+                if (r.ok) {
+                    std::cout << std::setw(12) << r.coldStartNs / 1e6 << std::setw(14) << r.medianNs / 1e3
+                              << std::setw(14) << r.p95Ns / 1e3 << std::setw(14) << r.cellsPerSecond / 1e9 << "\n";
+                } else {
+                    std::cout << std::setw(12) << "failed" << "\n";
+                }
+                std::cout.unsetf(std::ios::fixed);
+                std::cout << std::setprecision(6);
+            }
+        }
+    }
+
+    bool ok = true;
+    if (!config.jsonPath.empty()) {
+        std::ofstream file(config.jsonPath);
+        if (!file.is_open() || !writeJson(file)) {
+            std::cerr << "Error writing " << config.jsonPath << std::endl;
+            ok = false;
+        }
+    }
+    if (!config.csvPath.empty()) {
+        std::ofstream file(config.csvPath);
+        if (!file.is_open() || !writeCsv(file)) {
+            std::cerr << "Error writing " << config.csvPath << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool Benchmark::writeJson(std::ostream &out) const {
+    // Rahmendaten zuerst, damit Messungen verschiedener Maschinen vergleichbar bleiben.
+    out << "{\n"
+        << "  \"simd\": \"" << simdLevelName(activeSimdLevel()) << "\",\n"
+        << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n"
+        << "  \"warmupGenerations\": " << config.warmup << ",\n"
+        << "  \"seed\": " << config.seed << ",\n"
+        << "  \"results\": [";
+    for (size_t i = 0; i < measured.size(); ++i) {
+        const Result &r = measured[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"engine\": \"" << r.engine << "\", \"height\": " << r.height << ", \"width\": " << r.width
+            << ", \"density\": " << r.density << ", \"threads\": " << r.threads
+            << ", \"ok\": " << (r.ok ? "true" : "false")
+            << ", \"coldStartNs\": " << r.coldStartNs << ", \"generations\": " << r.generations
+            << std::fixed << std::setprecision(1)
+            << ", \"medianNs\": " << r.medianNs << ", \"p95Ns\": " << r.p95Ns << ", \"meanNs\": " << r.meanNs
+            << std::setprecision(0) << ", \"cellsPerSecond\": " << r.cellsPerSecond << "}";
+        out.unsetf(std::ios::fixed);
+        out << std::setprecision(6);
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+bool Benchmark::writeCsv(std::ostream &out) const {
+    out << "engine,height,width,density,threads,ok,cold_start_ns,generations,median_ns,p95_ns,mean_ns,cells_per_second\n";
+    for (const Result &r : measured) {
+        out << r.engine << "," << r.height << "," << r.width << "," << r.density << "," << r.threads << ","
+            << (r.ok ? 1 : 0) << "," << r.coldStartNs << "," << r.generations
+            << std::fixed << std::setprecision(1)
+            << "," << r.medianNs << "," << r.p95Ns << "," << r.meanNs
+            << std::setprecision(0) << "," << r.cellsPerSecond << "\n";
+        out.unsetf(std::ios::fixed);
+        out << std::setprecision(6);
+    }
+    return static_cast<bool>(out);
+}
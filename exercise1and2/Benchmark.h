@@ -0,0 +1,65 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+#include "Rule.h"
+
+// Messreihe über Engines, Gittergrößen und Dichten. Für jede Kombination werden getrennt erfasst:
+// - Kaltstart: Anlegen der Engine (Thread-Pool, Tabellen, OpenCL-Kontext und Übersetzen des Kernels,
+//   Hochladen) bis zum Ende der ersten Generation,
+// - eingeschwungener Zustand: nach einigen Aufwärm-Generationen wird jede Generation einzeln in
+//   Nanosekunden gemessen; daraus Median, 95. Perzentil und Zellen pro Sekunde.
+// So lassen sich Engines und Gittergrößen vergleichen, ohne dass das Übersetzen des Kernels oder
+// das erste Berühren der Seiten in die Zeit pro Generation eingeht.
+class Benchmark {
+    public:
+        struct Config {
+            std::vector<std::pair<int, int>> sizes;  // Höhe x Breite
+            std::vector<double> densities;           // Anteil lebender Zellen im Startzustand
+            std::vector<std::string> engines;        // Namen aus engineNames()
+            int generations;                         // gemessene Generationen pro Kombination
+            int warmup;                              // ungemessene Generationen vor der Messung
+            int threads;                             // CPU-Threads, 0 = alle Hardware-Threads
+            unsigned seed;                           // Startwert für die Zufallsbelegung
+            std::string kernelPath;                  // OpenCL-Kernel
+            Rule rule;                               // Regel aller Engines, Standard Conway
+            std::string jsonPath, csvPath;           // leer = keine Datei
+
+            Config();
+        };
+
+        struct Result {
+            std::string engine;
+            int height, width;
+            double density;
+            int threads;
+            bool ok;                    // false, wenn die Engine die Größe nicht unterstützt oder fehlschlug
+            long long coldStartNs;      // Anlegen der Engine bis Ende der ersten Generation
+            long long generations;      // tatsächlich gemessene Generationen
+            double medianNs, p95Ns, meanNs;  // Zeit pro Generation
+            double cellsPerSecond;      // aus der Summe aller gemessenen Generationen
+        };
+
+        explicit Benchmark(const Config &config);
+
+        // Führt alle Kombinationen aus, gibt eine Tabelle aus und schreibt die gewünschten Dateien.
+        bool run();
+        const std::vector<Result> &results() const { return measured; }
+
+        bool writeJson(std::ostream &out) const;
+        bool writeCsv(std::ostream &out) const;
+
+        // Alle messbaren Engines, d.h. alle Einträge von EvolveEngine::names().
+        static std::vector<std::string> engineNames();
+
+    private:
+        Config config;
+        std::vector<Result> measured;
+
+        Result measure(const std::string &engine, int height, int width, double density);
+};
+
+#endif // BENCHMARK_H
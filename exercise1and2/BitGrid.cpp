@@ -0,0 +1,150 @@
+#include "BitGrid.h"
+#include <new>
+#include <cstring>
+#include <utility>
+#include <random>
+
+// Leeres Spielfeld ohne Speicher.
+BitGrid::BitGrid() : height(0), width(0), wordsPerRow(0), stride(0), words(nullptr) {}
+
+// Spielfeld der Größe h x w, alle Zellen tot.
+BitGrid::BitGrid(int h, int w) : height(0), width(0), wordsPerRow(0), stride(0), words(nullptr) {
+    resize(h, w);
+}
+
+BitGrid::BitGrid(const BitGrid &other) : height(0), width(0), wordsPerRow(0), stride(0), words(nullptr) {
+    *this = other;
+}
+
+BitGrid::BitGrid(BitGrid &&other) noexcept : height(0), width(0), wordsPerRow(0), stride(0), words(nullptr) {
+    swap(other);
+}
+
+BitGrid &BitGrid::operator=(const BitGrid &other) {
+    if (this != &other) {
+        // Speicher nur neu anlegen, wenn sich die Größe ändert.
+        if (height != other.height || width != other.width) {
+            resize(other.height, other.width);
+        }
+        if (words != nullptr) {
+            std::memcpy(words, other.words, static_cast<size_t>(height) * stride * sizeof(uint64_t));
+        }
+    }
+    return *this;
+}
+
+BitGrid &BitGrid::operator=(BitGrid &&other) noexcept {
+    swap(other);
+    return *this;
+}
+
+BitGrid::~BitGrid() {
+    release();
+}
+
+int BitGrid::strideForWidth(int w) {
+    // Zeilenlänge auf eine ganze Cache-Line aufrunden, damit jede Zeile ausgerichtet beginnt.
+    int n = (w + 63) / 64;
+    return (n + CACHE_LINE_WORDS - 1) / CACHE_LINE_WORDS * CACHE_LINE_WORDS;
+}
+
+void BitGrid::allocate() {
+    wordsPerRow = (width + 63) / 64;
+    stride = strideForWidth(width);
+
+    size_t count = static_cast<size_t>(height) * stride;
+    if (count == 0) {
+        words = nullptr;
+        return;
+    }
+    words = static_cast<uint64_t*>(::operator new(count * sizeof(uint64_t), std::align_val_t(CACHE_LINE_BYTES)));
+    std::memset(words, 0, count * sizeof(uint64_t));
+}
+
+void BitGrid::release() {
+    if (releaseExternal) {
+        // Fremder Speicher wird von seinem Besitzer freigegeben.
+        std::function<void()> release;
+        release.swap(releaseExternal);
+        release();
+        words = nullptr;
+    } else if (words != nullptr) {
+        ::operator delete(words, std::align_val_t(CACHE_LINE_BYTES));
+        words = nullptr;
+    }
+}
+
+void BitGrid::adopt(int h, int w, uint64_t* storage, std::function<void()> release) {
+    this->release();
+    height = h > 0 ? h : 0;
+    width = w > 0 ? w : 0;
+    wordsPerRow = (width + 63) / 64;
+    stride = strideForWidth(width);
+    words = storage;
+    releaseExternal = std::move(release);
+}
+
+void BitGrid::resize(int h, int w) {
+    // Die Größenänderung verwirft den bisherigen Inhalt, alle Zellen sind danach tot.
+    release();
+    height = h > 0 ? h : 0;
+    width = w > 0 ? w : 0;
+    allocate();
+}
+
+void BitGrid::clear() {
+    if (words != nullptr) {
+        std::memset(words, 0, static_cast<size_t>(height) * stride * sizeof(uint64_t));
+    }
+}
+
+void BitGrid::fillRandom(double density, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    // Eine Zelle lebt, wenn eine gleichverteilte 64-Bit-Zahl unter threshold liegt.
+    uint64_t threshold = density <= 0 ? 0 : density >= 1 ? ~0ULL : static_cast<uint64_t>(density * 18446744073709551616.0);
+    uint64_t tail = tailMask();
+    for (int x = 0; x < height; ++x) {
+        uint64_t* line = row(x);
+        for (int k = 0; k < wordsPerRow; ++k) {
+            uint64_t word = 0;
+            for (int bit = 0; bit < 64; ++bit) {
+                word |= static_cast<uint64_t>(rng() < threshold) << bit;
+            }
+            line[k] = k == wordsPerRow - 1 ? word & tail : word;
+        }
+    }
+}
+
+void BitGrid::swap(BitGrid &other) noexcept {
+    std::swap(height, other.height);
+    std::swap(width, other.width);
+    std::swap(wordsPerRow, other.wordsPerRow);
+    std::swap(stride, other.stride);
+    std::swap(words, other.words);
+    releaseExternal.swap(other.releaseExternal);
+}
+
+size_t BitGrid::population() const {
+    // Zählt die lebenden Zellen wortweise.
+    size_t count = 0;
+    for (int x = 0; x < height; ++x) {
+        const uint64_t* r = row(x);
+        for (int k = 0; k < wordsPerRow; ++k) {
+            count += __builtin_popcountll(r[k]);
+        }
+    }
+    return count;
+}
+
+bool BitGrid::operator==(const BitGrid &other) const {
+    if (height != other.height || width != other.width) {
+        return false;
+    }
+    // Die Auffüllung hinter dem letzten Wort wird nicht verglichen.
+    for (int x = 0; x < height; ++x) {
+        if (std::memcmp(row(x), other.row(x), wordsPerRow * sizeof(uint64_t)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef BITGRID_H
+#define BITGRID_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+// Bitgepacktes, zusammenhängendes Spielfeld.
+// Jedes 64-Bit-Wort enthält 64 Zellen einer Zeile: Bit j von Wort k entspricht der Spalte 64 * k + j.
+// Jede Zeile beginnt auf einer Cache-Line-Grenze (64 Byte), deshalb wird die Zeilenlänge auf
+// ein Vielfaches von 8 Wörtern aufgerundet. Die Bits hinter der letzten Spalte sind immer 0.
+// Der Speicher gehört normalerweise dem Spielfeld; mit adopt() kann auch fremder Speicher im
+// gleichen Layout (z.B. eine eingeblendete Datei) ohne Kopie verwendet werden.
+class BitGrid {
+    private:
+        int height, width;
+        int wordsPerRow;  // Anzahl der genutzten Wörter pro Zeile
+        int stride;       // Anzahl der Wörter pro Zeile inklusive Auffüllung
+        uint64_t* words;
+        std::function<void()> releaseExternal;  // gibt fremden Speicher zurück, leer bei eigenem Speicher
+
+        void allocate();
+        void release();
+
+    public:
+        static const int CACHE_LINE_BYTES = 64;
+        static const int CACHE_LINE_WORDS = CACHE_LINE_BYTES / 8;
+
+        BitGrid();
+        BitGrid(int h, int w);
+        BitGrid(const BitGrid &other);
+        BitGrid(BitGrid &&other) noexcept;
+        BitGrid &operator=(const BitGrid &other);
+        BitGrid &operator=(BitGrid &&other) noexcept;
+        ~BitGrid();
+
+        // Zeilenlänge in Wörtern (inklusive Auffüllung) für ein Gitter der Breite w.
+        static int strideForWidth(int w);
+
+        // Übernimmt fremden Speicher im Layout von BitGrid (Zeilenlänge strideForWidth(w), 64 Byte
+        // ausgerichtet, Auffüllung 0). release wird aufgerufen, sobald der Speicher nicht mehr gebraucht wird.
+        void adopt(int h, int w, uint64_t* storage, std::function<void()> release);
+        bool isExternal() const { return static_cast<bool>(releaseExternal); }
+
+        void resize(int h, int w);
+        void clear();
+        // Belegt das Gitter reproduzierbar zufällig mit dem Anteil density lebender Zellen.
+        void fillRandom(double density, uint64_t seed);
+        void swap(BitGrid &other) noexcept;
+
+        int getHeight() const { return height; }
+        int getWidth() const { return width; }
+        int getWordsPerRow() const { return wordsPerRow; }
+        int getStride() const { return stride; }
+
+        // Maske der gültigen Bits im letzten Wort einer Zeile.
+        uint64_t tailMask() const {
+            int tailBits = width - 64 * (wordsPerRow - 1);
+            return tailBits == 64 ? ~0ULL : ((1ULL << tailBits) - 1);
+        }
+
+        uint64_t* row(int x) { return words + static_cast<size_t>(x) * stride; }
+        const uint64_t* row(int x) const { return words + static_cast<size_t>(x) * stride; }
+
+        bool get(int x, int y) const {
+            return (row(x)[y >> 6] >> (y & 63)) & 1ULL;
+        }
+
+        void set(int x, int y, bool state) {
+            uint64_t bit = 1ULL << (y & 63);
+            uint64_t &word = row(x)[y >> 6];
+            word = state ? (word | bit) : (word & ~bit);
+        }
+
+        size_t population() const;
+        bool operator==(const BitGrid &other) const;
+        bool operator!=(const BitGrid &other) const { return !(*this == other); }
+};
+
+#endif // BITGRID_H
@@ -1,15 +1,32 @@
 #include "CLI.h"
+#include "LifeKernels.h"
+#include "StreamingEvolver.h"
+#include "WorldFile.h"
 #include <iostream>
+#include <chrono>
 
 
 void CLI::run() {
     Grid world;
 
-    std::cout << "Would you like to set up the world from a file or create a new empty one? (1 for file, 0 for empty): ";
+    std::cout << "Would you like to set up the world from a file or create a new empty one? (1 for file, 0 for empty, 2 to resume from a checkpoint, 3 to stream a world larger than memory): ";
     int choice;
     std::cin >> choice;
 
-    if (choice == 1) {
+    if (choice == 3) {
+        runStreaming();
+        return;
+    } else if (choice == 2) {
+        std::string filename;
+        std::cout << "Enter the checkpoint filename: ";
+        std::cin >> filename;
+        world.setCheckpointing(filename, 0);
+        if (!world.resumeFromCheckpoint()) {
+            std::cerr << "Could not resume from " << filename << ", starting with an empty world.\n";
+        } else {
+            std::cout << "Resuming at generation " << world.getGeneration() << ".\n";
+        }
+    } else if (choice == 1) {
         std::string filename;
         std::cout << "Enter the filename: ";
         std::cin >> filename;
@@ -27,21 +44,109 @@ void CLI::run() {
     std::cout << "Enable printing after each generation? (1 for yes, 0 for no): ";
     std::cin >> printEnabled;
     world.setPrintEnabled(printEnabled);
+    if (printEnabled) {
+        std::string display;
+        std::cout << "Choose the display (auto, text, blocks, braille): ";
+        std::cin >> display;
+        if (!world.setDisplayMode(display)) {
+            world.setDisplayMode("auto");
+        }
+    }
 
     int delay_ms;
-    std::cout << "Enter delay in milliseconds between generations: ";
+    std::cout << "Enter minimum milliseconds per generation (0 for full speed): ";
     std::cin >> delay_ms;
 
-    std::cout << "Running scalar version...\n";
-    long long scalar_time = world.run(20, delay_ms);
-    std::cout << "Scalar version time: " << scalar_time << " ms\n";
+    int threads;
+    std::cout << "Enter number of CPU threads (0 for all cores): ";
+    std::cin >> threads;
+    world.setThreadCount(threads);
+
+    int checkpointInterval;
+    std::cout << "Enter checkpoint interval in generations (0 to disable): ";
+    std::cin >> checkpointInterval;
+    if (checkpointInterval > 0) {
+        std::string checkpointFile;
+        std::cout << "Enter the checkpoint filename: ";
+        std::cin >> checkpointFile;
+        world.setCheckpointing(checkpointFile, checkpointInterval);
+    }
+
+    int exportStride;
+    std::cout << "Enter frame export stride in generations (0 to disable): ";
+    std::cin >> exportStride;
+    if (exportStride > 0) {
+        std::string target, format;
+        std::cout << "Enter the frame export target (directory, - for stdout, |command for a pipe): ";
+        std::cin >> std::ws;
+        std::getline(std::cin, target);  // ein Befehl darf Leerzeichen enthalten
+        std::cout << "Choose the frame format (pgm, ppm): ";
+        std::cin >> format;
+        FrameExporter::Options options;
+        if (!FrameExporter::parseFormat(format, options.format)) {
+            std::cerr << "Unknown frame format " << format << ", using pgm.\n";
+        }
+        world.setFrameExport(target, exportStride, options);
+    }
+
+    // Welt-, Sicherungs- und RLE-Dateien bringen ihre Regel mit; sie ist hier der Vorschlag.
+    std::string rule;
+    std::cout << "Enter the rule (B/S notation or name, e.g. B3/S23, highlife; current " << world.getRule().describe() << "): ";
+    std::cin >> std::ws;
+    std::getline(std::cin, rule);  // Namen wie "Day & Night" dürfen Leerzeichen enthalten
+    if (!world.setRule(rule)) {
+        std::cerr << "Keeping " << world.getRule().describe() << ".\n";
+    }
+
+    std::string engine;
+    std::cout << "Choose the engine (";
+    for (const std::string &name : EvolveEngine::names()) {
+        std::cout << name << ", ";
+    }
+    std::cout << "auto): ";
+    std::cin >> engine;
+    if (!world.setEngine(engine)) {
+        world.setEngine("bitwise");
+    }
+    if (world.getEngine() == "temporal-blocking" || world.getEngine() == "hashlife") {
+        int generationsPerPass;
+        std::cout << "Enter number of generations per pass: ";
+        std::cin >> generationsPerPass;
+        world.setGenerationsPerPass(generationsPerPass);
+    }
+    int maxPeriod;
+    std::cout << "Enter the longest oscillator period to detect (0 to disable): ";
+    std::cin >> maxPeriod;
+    world.setCycleDetection(maxPeriod);
+
+    std::cout << "Running " << world.getEngine() << " version (" << world.getRule().describe() << ", " << simdLevelName(activeSimdLevel()) << " kernel, " << world.getThreadCount() << " threads)...\n";
+    long long engine_time = world.run(20, delay_ms);
+    std::cout << world.getEngine() << " version time: " << engine_time << " ms\n";
 
     std::cout << "Running OpenCL version...\n";
     long long opencl_time = world.run_with_opencl(20, delay_ms);
     std::cout << "OpenCL version time: " << opencl_time << " ms\n";
 
+    long long hashlife_generations;
+    std::cout << "Enter number of generations for the Hashlife version (0 to skip, needs power-of-two size): ";
+    std::cin >> hashlife_generations;
+    if (hashlife_generations > 0) {
+        std::cout << "Running Hashlife version...\n";
+        long long hashlife_time = world.run_with_hashlife(hashlife_generations);
+        std::cout << "Hashlife version time: " << hashlife_time << " ms\n";
+    }
+
+    long long unbounded_generations;
+    std::cout << "Enter number of generations on the unbounded plane (0 to skip): ";
+    std::cin >> unbounded_generations;
+    if (unbounded_generations > 0) {
+        std::cout << "Running unbounded version...\n";
+        long long unbounded_time = world.run_unbounded(unbounded_generations);
+        std::cout << "Unbounded version time: " << unbounded_time << " ms\n";
+    }
+
     // long long timeTaken = world.run(20, delay_ms);
-    std::cout << "Time taken for evolution (scalar): " << scalar_time << " ms\n";
+    std::cout << "Time taken for evolution (" << world.getEngine() << "): " << engine_time << " ms\n";
 
     std::cout << "Time taken for evolution (opencl): " << opencl_time << " ms\n";
 
@@ -52,3 +157,46 @@ void CLI::run() {
     loadedWorld.run(10, delay_ms);
     */
 }
+
+void CLI::runStreaming() {
+    // Die Welt bleibt auf der Platte und wird bandweise von Datei zu Datei gerechnet (siehe StreamingEvolver.h).
+    std::string input, output;
+    std::cout << "Enter the binary world file to read (a new random world is created if it does not exist): ";
+    std::cin >> input;
+    if (!WorldFile::isWorldFile(input)) {
+        int height, width;
+        double density;
+        std::cout << "Enter the height and width of the new world: ";
+        std::cin >> height >> width;
+        std::cout << "Enter the initial live-cell fraction (e.g. 0.35): ";
+        std::cin >> density;
+        std::cout << "Writing " << height << "x" << width << " world to " << input << "...\n";
+        if (!StreamingEvolver::createRandom(input, height, width, density, 42)) {
+            return;
+        }
+    }
+    std::cout << "Enter the output world file: ";
+    std::cin >> output;
+
+    long long generations;
+    std::cout << "Enter number of generations: ";
+    std::cin >> generations;
+    size_t memoryMiB;
+    std::cout << "Enter the memory budget in MiB: ";
+    std::cin >> memoryMiB;
+    int threads;
+    std::cout << "Enter number of CPU threads (0 for all cores): ";
+    std::cin >> threads;
+
+    StreamingEvolver evolver(memoryMiB << 20, threads);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    if (!evolver.evolve(input, output, generations)) {
+        return;
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time);
+
+    const StreamingEvolver::Result &result = evolver.getResult();
+    std::cout << "Streamed " << generations << " generations in " << duration.count() << " ms (" << result.bandRows
+              << " rows per band, " << result.windowBytes / 1024 << " KiB window), generation "
+              << result.generation << ", population " << result.population << "\n";
+}
@@ -4,6 +4,9 @@
 #include "Grid.h"
 
 class CLI {
+    private:
+        void runStreaming();
+
     public:
         void run();
 };
@@ -0,0 +1,132 @@
+#include "Checkpointer.h"
+#include "WorldFile.h"
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+Checkpointer::Checkpointer(const std::string &filename, const Rule &worldRule)
+    : path(filename), rule(worldRule), snapshotGeneration{0, 0}, pending(-1), writing(-1), stopping(false),
+      written(0), skipped(0), failed(0), copyNanoseconds(0) {
+    writer = std::thread(&Checkpointer::writerLoop, this);
+}
+
+Checkpointer::~Checkpointer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+bool Checkpointer::submit(const BitGrid &grid, long long generation) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Freien Puffer suchen: weder wartend noch gerade im Schreiben.
+    int target = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < 2; ++i) {
+            if (i != pending && i != writing) {
+                target = i;
+                break;
+            }
+        }
+        if (target < 0) {
+            ++skipped;
+            return false;
+        }
+    }
+
+    // Die Kopie geschieht ohne Sperre; der Hintergrund-Thread greift nur auf wartende Puffer zu.
+    snapshots[target] = grid;
+    snapshotGeneration[target] = generation;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending >= 0) {
+            ++skipped;  // eine noch nicht begonnene ältere Sicherung wird durch die neue ersetzt
+        }
+        pending = target;
+        copyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+    wake.notify_one();
+    return true;
+}
+
+void Checkpointer::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return pending < 0 && writing < 0; });
+}
+
+long long Checkpointer::writtenCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+long long Checkpointer::skippedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return skipped;
+}
+
+long long Checkpointer::simulationNanoseconds() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return copyNanoseconds;
+}
+
+void Checkpointer::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return pending >= 0 || stopping; });
+        if (pending < 0) {
+            return;  // beendet und nichts mehr zu schreiben
+        }
+        writing = pending;
+        pending = -1;
+        int index = writing;
+
+        lock.unlock();
+        bool ok = writeAtomically(snapshots[index], snapshotGeneration[index]);
+        lock.lock();
+
+        writing = -1;
+        if (ok) {
+            ++written;
+        } else {
+            ++failed;
+        }
+        idle.notify_all();
+    }
+}
+
+bool Checkpointer::writeAtomically(const BitGrid &grid, long long generation) {
+    // Erst vollständig in eine temporäre Datei schreiben, dann die alte Sicherung in einem Schritt ersetzen.
+    std::string temporary = path + ".tmp";
+    WorldFile::Info info{generation, rule.birthMask(), rule.survivalMask()};
+    if (!WorldFile::save(temporary, grid, info)) {
+        std::cerr << "Error writing checkpoint " << temporary << std::endl;
+        return false;
+    }
+
+#ifdef _WIN32
+    std::remove(path.c_str());  // rename() ersetzt unter Windows keine bestehende Datei
+#else
+    // Die Daten müssen auf der Platte sein, bevor der Name umgehängt wird.
+    int fd = open(temporary.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error renaming checkpoint to " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef CHECKPOINTER_H
+#define CHECKPOINTER_H
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "BitGrid.h"
+#include "Rule.h"
+
+// Schreibt Sicherungspunkte im binären Weltformat in einem Hintergrund-Thread.
+// Die Simulation kopiert die aktuelle Generation nur in einen von zwei Schnappschuss-Puffern und
+// rechnet sofort weiter; geschrieben wird in eine temporäre Datei, die erst nach vollständigem
+// Schreiben per rename() die letzte Sicherung ersetzt. Eine gefundene Sicherung ist daher immer
+// vollständig. Sind beide Puffer belegt (die Platte ist langsamer als das Intervall), wird der
+// Sicherungspunkt ausgelassen, statt die Simulation aufzuhalten.
+class Checkpointer {
+    private:
+        std::string path;
+        Rule rule;  // wird mit jeder Sicherung gespeichert
+        BitGrid snapshots[2];
+        long long snapshotGeneration[2];
+        int pending;   // Puffer, der auf das Schreiben wartet (-1 = keiner)
+        int writing;   // Puffer, den der Hintergrund-Thread gerade schreibt (-1 = keiner)
+        bool stopping;
+        std::mutex mutex;
+        std::condition_variable wake;  // weckt den Hintergrund-Thread
+        std::condition_variable idle;  // meldet, dass ein Puffer geschrieben wurde
+
+        long long written, skipped, failed;
+        long long copyNanoseconds;  // Zeit, die die Simulation in submit() verbracht hat
+        std::thread writer;
+
+        void writerLoop();
+        bool writeAtomically(const BitGrid &grid, long long generation);
+
+    public:
+        Checkpointer(const std::string &filename, const Rule &rule);
+        ~Checkpointer();  // schreibt noch wartende Sicherungen und beendet den Thread
+
+        // Übergibt eine Generation an den Hintergrund-Thread; false, wenn der Punkt ausgelassen wurde.
+        bool submit(const BitGrid &grid, long long generation);
+        // Wartet, bis alle übergebenen Sicherungen geschrieben sind.
+        void flush();
+
+        long long writtenCount();
+        long long skippedCount();
+        long long simulationNanoseconds();
+};
+
+#endif // CHECKPOINTER_H
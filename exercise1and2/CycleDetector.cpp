@@ -0,0 +1,31 @@
+#include "CycleDetector.h"
+
+CycleDetector::CycleDetector(int maxPeriod)
+    : hashes(maxPeriod > 0 ? maxPeriod : 1), generations(hashes.size()), next(0), count(0) {}
+
+void CycleDetector::reset() {
+    next = 0;
+    count = 0;
+}
+
+int CycleDetector::record(uint64_t hash, long long generation) {
+    int size = static_cast<int>(hashes.size());
+
+    // Vom jüngsten Eintrag rückwärts suchen, damit die kleinste Periode gefunden wird.
+    int period = 0;
+    for (int i = 1; i <= count; ++i) {
+        int slot = (next - i + size) % size;
+        if (hashes[slot] == hash) {
+            period = static_cast<int>(generation - generations[slot]);
+            break;
+        }
+    }
+
+    hashes[next] = hash;
+    generations[next] = generation;
+    next = (next + 1) % size;
+    if (count < size) {
+        ++count;
+    }
+    return period;
+}
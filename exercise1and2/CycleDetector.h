@@ -0,0 +1,35 @@
+#ifndef CYCLEDETECTOR_H
+#define CYCLEDETECTOR_H
+
+#include <vector>
+#include <cstdint>
+
+// Erkennt periodische Endzustände an den Zustands-Hashes, die die Engines als Nebenprodukt
+// eines Schritts liefern (siehe StepStats). Gespeichert werden nur die letzten maxPeriod Hashes
+// in einem Ringpuffer; der Vergleich kostet also pro Generation höchstens maxPeriod Vergleiche
+// und keinen Zugriff auf das Gitter. Stillstand (Periode 1) erkennt bereits die Anzahl der
+// veränderten Zellen; hier geht es um Oszillatoren wie Blinker (2) oder Pulsar (3).
+// Bei 64 Bit ist eine zufällige Kollision so unwahrscheinlich, dass sie vernachlässigt wird.
+class CycleDetector {
+    private:
+        std::vector<uint64_t> hashes;
+        std::vector<long long> generations;
+        int next;   // nächster Platz im Ringpuffer
+        int count;  // Anzahl gültiger Einträge
+
+    public:
+        explicit CycleDetector(int maxPeriod = 16);
+
+        // Vergisst alle bisherigen Hashes, z.B. nach dem Laden eines neuen Zustands.
+        void reset();
+
+        // Trägt den Hash der Generation generation ein. Liefert den Abstand zur letzten Generation
+        // mit demselben Hash (die Periode) oder 0, wenn der Zustand in den gespeicherten Generationen
+        // nicht vorkam. Wird nur jede k-te Generation eingetragen, ist das Ergebnis ein Vielfaches
+        // der Periode.
+        int record(uint64_t hash, long long generation);
+
+        int maxPeriod() const { return static_cast<int>(hashes.size()); }
+};
+
+#endif // CYCLEDETECTOR_H
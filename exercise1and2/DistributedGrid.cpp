@@ -0,0 +1,508 @@
+#include "DistributedGrid.h"
+#include "LifeKernels.h"
+#include "ThreadPool.h"
+#include "WorldFile.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+// Zeilen- und Spaltenversatz der Nachbarn in der Reihenfolge von Direction.
+static const int DIRECTION_OFFSETS[8][2] = {
+    {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
+};
+
+// Richtung, aus der Daten kommen, die in Richtung d unterwegs sind.
+static int opposite(int d) {
+    static const int OPPOSITE[8] = {1, 0, 3, 2, 7, 6, 5, 4};
+    return OPPOSITE[d];
+}
+
+// Anfang von Teil index, wenn total Einheiten möglichst gleichmäßig auf parts Teile verteilt werden.
+static int splitBegin(int total, int parts, int index) {
+    return static_cast<int>(static_cast<long long>(total) * index / parts);
+}
+
+// count (1..64) Bits ab Bit bit einer Zeile; die Zeile muss bis zum letzten gelesenen Bit reichen.
+static uint64_t extractBits(const uint64_t* row, int bit, int count) {
+    int word = bit >> 6;
+    int shift = bit & 63;
+    uint64_t value = row[word] >> shift;
+    if (shift != 0 && shift + count > 64) {
+        value |= row[word + 1] << (64 - shift);
+    }
+    return count == 64 ? value : value & ((1ULL << count) - 1);
+}
+
+// Schreibt die unteren count (1..64) Bits von value ab Bit bit; die übrigen Bits bleiben erhalten.
+static void depositBits(uint64_t* row, int bit, int count, uint64_t value) {
+    int word = bit >> 6;
+    int shift = bit & 63;
+    uint64_t mask = count == 64 ? ~0ULL : ((1ULL << count) - 1);
+    value &= mask;
+    row[word] = (row[word] & ~(mask << shift)) | (value << shift);
+    if (shift != 0 && shift + count > 64) {
+        row[word + 1] = (row[word + 1] & ~(mask >> (64 - shift))) | (value >> (64 - shift));
+    }
+}
+
+// Mischfunktion nach splitmix64 für die vom Prozessgitter unabhängige Zufallsbelegung.
+static uint64_t mixBits(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+DistributedGrid::DistributedGrid(MPI_Comm world, int haloDepth, int threads)
+    : parent(world), comm(MPI_COMM_NULL), rank(0), processes(1), dims{1, 1}, coords{0, 0},
+      halo(std::min(std::max(haloDepth, 1), 64)), height(0), width(0), rowOffset(0), rows(0), colOffset(0), cols(0),
+      generation(0), lastChanged(0) {
+    MPI_Comm_rank(parent, &rank);
+    MPI_Comm_size(parent, &processes);
+    for (int d = 0; d < DIRECTIONS; ++d) {
+        neighbours[d] = MPI_PROC_NULL;
+    }
+    if (threads != 1) {
+        pool.reset(new ThreadPool(threads));
+    }
+}
+
+DistributedGrid::~DistributedGrid() {
+    if (comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&comm);
+    }
+}
+
+bool DistributedGrid::allTrue(bool value) const {
+    int local = value ? 1 : 0;
+    int all = 0;
+    MPI_Allreduce(&local, &all, 1, MPI_INT, MPI_LAND, comm != MPI_COMM_NULL ? comm : parent);
+    return all != 0;
+}
+
+bool DistributedGrid::setSize(int h, int w) {
+    // Prozessgitter möglichst quadratisch; mehr Spaltenblöcke als Wörter pro Zeile gibt es nicht,
+    // dann wird nur nach Zeilen aufgeteilt.
+    int wordsPerRow = (w + 63) / 64;
+    int layout[2] = {0, 0};
+    MPI_Dims_create(processes, 2, layout);
+    if (layout[1] > wordsPerRow) {
+        layout[0] = processes;
+        layout[1] = 1;
+    }
+
+    if (comm != MPI_COMM_NULL && (layout[0] != dims[0] || layout[1] != dims[1])) {
+        MPI_Comm_free(&comm);
+    }
+    if (comm == MPI_COMM_NULL) {
+        int periods[2] = {1, 1};
+        MPI_Cart_create(parent, 2, layout, periods, 1, &comm);
+        MPI_Comm_rank(comm, &rank);
+        MPI_Cart_coords(comm, rank, 2, coords);
+        dims[0] = layout[0];
+        dims[1] = layout[1];
+        for (int d = 0; d < DIRECTIONS; ++d) {
+            int neighbour[2] = {coords[0] + DIRECTION_OFFSETS[d][0], coords[1] + DIRECTION_OFFSETS[d][1]};
+            MPI_Cart_rank(comm, neighbour, &neighbours[d]);  // periodisch: Koordinaten werden umgebrochen
+        }
+    }
+
+    height = h;
+    width = w;
+    rowOffset = splitBegin(h, dims[0], coords[0]);
+    rows = splitBegin(h, dims[0], coords[0] + 1) - rowOffset;
+    colOffset = 64 * splitBegin(wordsPerRow, dims[1], coords[1]);
+    cols = std::min(w, 64 * splitBegin(wordsPerRow, dims[1], coords[1] + 1)) - colOffset;
+    generation = 0;
+    lastChanged = 0;
+
+    // Der Rand eines Blocks stammt vollständig vom direkten Nachbarn.
+    bool fits = rows >= halo && cols >= halo;
+    if (!allTrue(fits)) {
+        if (rank == 0) {
+            std::cerr << "Error: a " << h << "x" << w << " grid cannot be split into " << dims[0] << "x" << dims[1]
+                      << " blocks with a halo of " << halo << " cells." << std::endl;
+        }
+        height = width = rows = cols = 0;
+        return false;
+    }
+
+    current.resize(rows + 2 * halo, cols + 128);
+    next.resize(rows + 2 * halo, cols + 128);
+    for (int d = 0; d < DIRECTIONS; ++d) {
+        Region send = edgeRegion(d);
+        Region receive = haloRegion(opposite(d));
+        sendBuffers[d].resize(static_cast<size_t>(send.rowEnd - send.rowBegin) * ((send.bitEnd - send.bitBegin + 63) / 64));
+        receiveBuffers[d].resize(static_cast<size_t>(receive.rowEnd - receive.rowBegin) * ((receive.bitEnd - receive.bitBegin + 63) / 64));
+    }
+    return true;
+}
+
+uint64_t DistributedGrid::ownMask(int word) const {
+    int tailBits = cols - 64 * (ownWords() - 1);
+    return word == ownWords() && tailBits < 64 ? (1ULL << tailBits) - 1 : ~0ULL;
+}
+
+DistributedGrid::Region DistributedGrid::edgeRegion(int direction) const {
+    // Die eigenen Zellen, die der Nachbar in dieser Richtung als Rand braucht.
+    int k = halo;
+    Region region{k, k + rows, 64, 64 + cols};
+    int dr = DIRECTION_OFFSETS[direction][0];
+    int dc = DIRECTION_OFFSETS[direction][1];
+    if (dr < 0) {
+        region.rowEnd = 2 * k;
+    } else if (dr > 0) {
+        region.rowBegin = rows;
+    }
+    if (dc < 0) {
+        region.bitEnd = 64 + k;
+    } else if (dc > 0) {
+        region.bitBegin = 64 + cols - k;
+    }
+    return region;
+}
+
+DistributedGrid::Region DistributedGrid::haloRegion(int direction) const {
+    // Der Rand auf der Seite des Nachbarn in dieser Richtung.
+    int k = halo;
+    Region region{k, k + rows, 64, 64 + cols};
+    int dr = DIRECTION_OFFSETS[direction][0];
+    int dc = DIRECTION_OFFSETS[direction][1];
+    if (dr < 0) {
+        region.rowBegin = 0;
+        region.rowEnd = k;
+    } else if (dr > 0) {
+        region.rowBegin = k + rows;
+        region.rowEnd = 2 * k + rows;
+    }
+    if (dc < 0) {
+        region.bitBegin = 64 - k;
+        region.bitEnd = 64;
+    } else if (dc > 0) {
+        region.bitBegin = 64 + cols;
+        region.bitEnd = 64 + cols + k;
+    }
+    return region;
+}
+
+void DistributedGrid::pack(const BitGrid &grid, const Region &region, std::vector<uint64_t> &buffer) {
+    size_t i = 0;
+    for (int x = region.rowBegin; x < region.rowEnd; ++x) {
+        const uint64_t* row = grid.row(x);
+        for (int bit = region.bitBegin; bit < region.bitEnd; bit += 64) {
+            buffer[i++] = extractBits(row, bit, std::min(64, region.bitEnd - bit));
+        }
+    }
+}
+
+void DistributedGrid::unpack(BitGrid &grid, const Region &region, const std::vector<uint64_t> &buffer) {
+    size_t i = 0;
+    for (int x = region.rowBegin; x < region.rowEnd; ++x) {
+        uint64_t* row = grid.row(x);
+        for (int bit = region.bitBegin; bit < region.bitEnd; bit += 64) {
+            depositBits(row, bit, std::min(64, region.bitEnd - bit), buffer[i++]);
+        }
+    }
+}
+
+void DistributedGrid::startExchange() {
+    // Daten, die in Richtung d unterwegs sind, tragen das Tag d. So bleiben die Nachrichten auch
+    // dann eindeutig, wenn derselbe Prozess in mehreren Richtungen Nachbar ist (z.B. bei 2 Prozessen
+    // pro Richtung oder bei nur einem Prozess, der mit sich selbst tauscht).
+    for (int d = 0; d < DIRECTIONS; ++d) {
+        MPI_Irecv(receiveBuffers[d].data(), static_cast<int>(receiveBuffers[d].size()), MPI_UINT64_T,
+                  neighbours[opposite(d)], d, comm, &requests[d]);
+    }
+    for (int d = 0; d < DIRECTIONS; ++d) {
+        pack(current, edgeRegion(d), sendBuffers[d]);
+        MPI_Isend(sendBuffers[d].data(), static_cast<int>(sendBuffers[d].size()), MPI_UINT64_T,
+                  neighbours[d], d, comm, &requests[DIRECTIONS + d]);
+    }
+}
+
+void DistributedGrid::finishExchange() {
+    MPI_Waitall(2 * DIRECTIONS, requests, MPI_STATUSES_IGNORE);
+    for (int d = 0; d < DIRECTIONS; ++d) {
+        unpack(current, haloRegion(opposite(d)), receiveBuffers[d]);
+    }
+}
+
+void DistributedGrid::evolveBlock(int rowBegin, int rowEnd, int wordBegin, int wordEnd) {
+    if (rowBegin >= rowEnd || wordBegin >= wordEnd) {
+        return;
+    }
+    // Die Zeilen werden im lokalen Gitter toroidal berechnet; der Umbruch trifft nur die äußeren
+    // Randwörter, deren Inhalt ohnehin nicht mehr gültig sein muss.
+    int n = current.getWordsPerRow();
+    int localWidth = current.getWidth();
+    auto band = [&](int begin, int end) {
+        for (int x = begin; x < end; ++x) {
+            evolveRowRange(current.row(x - 1), current.row(x), current.row(x + 1), next.row(x), n, localWidth,
+                           wordBegin, wordEnd, rule);
+        }
+    };
+    if (!pool || pool->size() == 1 || rowEnd - rowBegin < pool->size()) {
+        band(rowBegin, rowEnd);
+        return;
+    }
+    pool->run([&](int index) {
+        std::pair<int, int> part = ThreadPool::band(rowEnd - rowBegin, pool->size(), index);
+        band(rowBegin + part.first, rowBegin + part.second);
+    });
+}
+
+uint64_t DistributedGrid::countChanges() const {
+    // Nur eigene Zellen: current ist die vorige, next die neue Generation.
+    uint64_t changed = 0;
+    for (int x = halo; x < halo + rows; ++x) {
+        const uint64_t* before = current.row(x);
+        const uint64_t* after = next.row(x);
+        for (int k = 1; k <= ownWords(); ++k) {
+            changed += __builtin_popcountll((before[k] ^ after[k]) & ownMask(k));
+        }
+    }
+    return changed;
+}
+
+int DistributedGrid::step(int maxGenerations, bool countChanges) {
+    int count = std::min(std::max(maxGenerations, 1), halo);
+    int k = halo;
+    int localRows = rows + 2 * k;
+    int n = current.getWordsPerRow();
+
+    // Inneres der ersten Generation: Zeilen und Wörter, deren Nachbarschaft nur eigene Zellen
+    // enthält. Es wird berechnet, während die Ränder unterwegs sind.
+    int innerRowBegin = k + 1;
+    int innerRowEnd = k + rows - 1;
+    int innerWordBegin = 2;
+    int innerWordEnd = (cols - 1) / 64 + 1;
+    bool inner = innerRowBegin < innerRowEnd && innerWordBegin < innerWordEnd;
+
+    startExchange();
+    if (inner) {
+        evolveBlock(innerRowBegin, innerRowEnd, innerWordBegin, innerWordEnd);
+    }
+    finishExchange();
+
+    for (int s = 1; s <= count; ++s) {
+        // Nach s Generationen sind noch k - s Zellen Rand gültig; nur dieser Bereich wird berechnet.
+        int reach = k - s;
+        int rowBegin = s;
+        int rowEnd = localRows - s;
+        int wordBegin = (64 - reach) / 64;
+        int wordEnd = std::min(n, (64 + cols + reach + 63) / 64);
+        if (s == 1 && inner) {
+            // Rest der ersten Generation um das bereits berechnete Innere herum.
+            evolveBlock(rowBegin, innerRowBegin, wordBegin, wordEnd);
+            evolveBlock(innerRowEnd, rowEnd, wordBegin, wordEnd);
+            evolveBlock(innerRowBegin, innerRowEnd, wordBegin, innerWordBegin);
+            evolveBlock(innerRowBegin, innerRowEnd, innerWordEnd, wordEnd);
+        } else {
+            evolveBlock(rowBegin, rowEnd, wordBegin, wordEnd);
+        }
+        if (countChanges && s == count) {
+            lastChanged = this->countChanges();
+        }
+        current.swap(next);
+    }
+    generation += count;
+    return count;
+}
+
+DistributedGrid::Stats DistributedGrid::reduceStats() {
+    uint64_t local[2] = {lastChanged, 0};
+    for (int x = halo; x < halo + rows; ++x) {
+        const uint64_t* row = current.row(x);
+        for (int k = 1; k <= ownWords(); ++k) {
+            local[1] += __builtin_popcountll(row[k] & ownMask(k));
+        }
+    }
+    uint64_t total[2] = {0, 0};
+    MPI_Allreduce(local, total, 2, MPI_UINT64_T, MPI_SUM, comm);
+    return Stats{total[0], total[1]};
+}
+
+void DistributedGrid::fillRandom(double density, uint64_t seed) {
+    // Jede Zelle hängt nur von Startwert und globaler Position ab.
+    uint64_t threshold = density <= 0 ? 0 : density >= 1 ? ~0ULL : static_cast<uint64_t>(density * 18446744073709551616.0);
+    current.clear();
+    for (int x = 0; x < rows; ++x) {
+        uint64_t* row = current.row(halo + x);
+        uint64_t globalRow = static_cast<uint64_t>(rowOffset + x);
+        for (int y = 0; y < cols; ++y) {
+            uint64_t index = globalRow * static_cast<uint64_t>(width) + colOffset + y;
+            if (mixBits(seed * 0x9E3779B97F4A7C15ULL + index) < threshold) {
+                row[1 + (y >> 6)] |= 1ULL << (y & 63);
+            }
+        }
+    }
+    generation = 0;
+    lastChanged = 0;
+}
+
+int DistributedGrid::fileWords() const {
+    // Der letzte Spaltenblock schreibt auch die Auffüllung der Zeile bis zum Zeilenabstand der Datei.
+    int words = ownWords();
+    if (coords[1] == dims[1] - 1) {
+        words += BitGrid::strideForWidth(width) - (width + 63) / 64;
+    }
+    return words;
+}
+
+MPI_Datatype DistributedGrid::fileType() const {
+    int sizes[2] = {height, BitGrid::strideForWidth(width)};
+    int subsizes[2] = {rows, fileWords()};
+    int starts[2] = {rowOffset, colOffset / 64};
+    MPI_Datatype type;
+    MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C, MPI_UINT64_T, &type);
+    MPI_Type_commit(&type);
+    return type;
+}
+
+void DistributedGrid::copyToFile(std::vector<uint64_t> &block) const {
+    // Bits hinter der letzten eigenen Spalte gehören zum Rand und werden als 0 geschrieben.
+    int words = fileWords();
+    block.assign(static_cast<size_t>(rows) * words, 0);
+    for (int x = 0; x < rows; ++x) {
+        const uint64_t* row = current.row(halo + x);
+        uint64_t* out = &block[static_cast<size_t>(x) * words];
+        for (int k = 1; k <= ownWords(); ++k) {
+            out[k - 1] = row[k] & ownMask(k);
+        }
+    }
+}
+
+void DistributedGrid::copyFromFile(const std::vector<uint64_t> &block) {
+    int words = fileWords();
+    current.clear();
+    for (int x = 0; x < rows; ++x) {
+        uint64_t* row = current.row(halo + x);
+        const uint64_t* in = &block[static_cast<size_t>(x) * words];
+        for (int k = 1; k <= ownWords(); ++k) {
+            row[k] = in[k - 1] & ownMask(k);
+        }
+    }
+}
+
+uint64_t DistributedGrid::blockChecksum(const std::vector<uint64_t> &block) const {
+    // Die Prüfsumme der Weltdatei ist eine Summe über positionsabhängige Beiträge der Wörter: jeder
+    // Prozess summiert seinen Block an dessen Lage in der Datei, eine einzige Reduktion addiert die Teile.
+    int words = fileWords();
+    uint64_t stride = static_cast<uint64_t>(BitGrid::strideForWidth(width));
+    uint64_t local = 0;
+    for (int x = 0; x < rows; ++x) {
+        uint64_t position = static_cast<uint64_t>(rowOffset + x) * stride + colOffset / 64;
+        local += WorldFile::checksum(&block[static_cast<size_t>(x) * words], words, position);
+    }
+    uint64_t sum = 0;
+    MPI_Allreduce(&local, &sum, 1, MPI_UINT64_T, MPI_SUM, comm);
+    return sum;
+}
+
+bool DistributedGrid::save(const std::string &filename) {
+    MPI_File file;
+    bool opened = MPI_File_open(comm, filename.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file) == MPI_SUCCESS;
+    if (!allTrue(opened)) {
+        if (rank == 0) {
+            std::cerr << "Error opening file " << filename << " for parallel writing." << std::endl;
+        }
+        if (opened) {
+            MPI_File_close(&file);
+        }
+        return false;
+    }
+    MPI_File_set_size(file, 0);  // Reste einer älteren, größeren Datei verwerfen
+
+    // Jeder Prozess schreibt seinen Block als Teilfeld der Zeilen hinter der Kopfseite.
+    std::vector<uint64_t> block;
+    copyToFile(block);
+    MPI_Datatype type = fileType();
+    MPI_File_set_view(file, WorldFile::PAGE_BYTES, MPI_UINT64_T, type, "native", MPI_INFO_NULL);
+    bool ok = MPI_File_write_all(file, block.data(), static_cast<int>(block.size()), MPI_UINT64_T, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+    MPI_Type_free(&type);
+
+    WorldHeader header;
+    WorldFile::fillHeader(header, height, width, WorldFile::Info{generation, rule.birthMask(), rule.survivalMask()});
+    header.checksum = blockChecksum(block);
+
+    // Kopfseite von Prozess 0, danach die Datei auf ganze Seiten auffüllen wie WorldFile::save().
+    MPI_File_set_view(file, 0, MPI_BYTE, MPI_BYTE, "native", MPI_INFO_NULL);
+    if (rank == 0) {
+        std::vector<char> page(WorldFile::PAGE_BYTES, 0);
+        std::memcpy(page.data(), &header, sizeof(header));
+        ok = MPI_File_write_at(file, 0, page.data(), static_cast<int>(page.size()), MPI_BYTE, MPI_STATUS_IGNORE) == MPI_SUCCESS && ok;
+    }
+    uint64_t pages = (header.dataBytes + WorldFile::PAGE_BYTES - 1) / WorldFile::PAGE_BYTES;
+    MPI_File_set_size(file, static_cast<MPI_Offset>(WorldFile::PAGE_BYTES * (pages + 1)));
+    ok = MPI_File_close(&file) == MPI_SUCCESS && ok;
+
+    if (!allTrue(ok)) {
+        if (rank == 0) {
+            std::cerr << "Error writing file " << filename << "." << std::endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool DistributedGrid::load(const std::string &filename) {
+    MPI_File file;
+    bool opened = MPI_File_open(parent, filename.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &file) == MPI_SUCCESS;
+    int allOpened = 0;
+    int local = opened ? 1 : 0;
+    MPI_Allreduce(&local, &allOpened, 1, MPI_INT, MPI_LAND, parent);
+    if (!allOpened) {
+        if (rank == 0) {
+            std::cerr << "Error opening file " << filename << " for parallel reading." << std::endl;
+        }
+        if (opened) {
+            MPI_File_close(&file);
+        }
+        return false;
+    }
+
+    // Prozess 0 liest und prüft den Kopf, alle anderen übernehmen ihn.
+    WorldHeader header;
+    std::memset(&header, 0, sizeof(header));
+    int valid = 0;
+    int root = 0;
+    MPI_Comm_rank(parent, &root);
+    if (root == 0) {
+        MPI_Offset fileBytes = 0;
+        MPI_File_get_size(file, &fileBytes);
+        valid = fileBytes >= static_cast<MPI_Offset>(sizeof(header))
+             && MPI_File_read_at(file, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE) == MPI_SUCCESS
+             && WorldFile::validHeader(header, static_cast<uint64_t>(fileBytes));
+    }
+    MPI_Bcast(&valid, 1, MPI_INT, 0, parent);
+    MPI_Bcast(&header, sizeof(header), MPI_BYTE, 0, parent);
+    if (!valid || !setSize(header.height, header.width)) {
+        MPI_File_close(&file);
+        return false;
+    }
+
+    std::vector<uint64_t> block(static_cast<size_t>(rows) * fileWords());
+    MPI_Datatype type = fileType();
+    MPI_File_set_view(file, WorldFile::PAGE_BYTES, MPI_UINT64_T, type, "native", MPI_INFO_NULL);
+    bool ok = MPI_File_read_all(file, block.data(), static_cast<int>(block.size()), MPI_UINT64_T, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+    MPI_Type_free(&type);
+    MPI_File_close(&file);
+    if (!allTrue(ok)) {
+        if (rank == 0) {
+            std::cerr << "Error reading file " << filename << "." << std::endl;
+        }
+        return false;
+    }
+    if (blockChecksum(block) != header.checksum) {
+        if (rank == 0) {
+            std::cerr << "Error: world file checksum mismatch." << std::endl;
+        }
+        return false;
+    }
+
+    copyFromFile(block);
+    rule = Rule(header.birthMask, header.survivalMask);
+    generation = header.generation;
+    lastChanged = 0;
+    return true;
+}
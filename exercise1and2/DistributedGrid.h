@@ -0,0 +1,123 @@
+#ifndef DISTRIBUTEDGRID_H
+#define DISTRIBUTEDGRID_H
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "BitGrid.h"
+#include "Rule.h"
+
+class ThreadPool;
+
+// Toroidales Gitter, das in 2D-Blöcken auf die Prozesse eines MPI-Kommunikators verteilt ist.
+// Die Prozesse bilden ein in beiden Richtungen periodisches kartesisches Gitter; jeder hält seinen
+// Block mit einem Rand von halo Zellen (Tiefe k) auf allen Seiten in einem BitGrid:
+//
+//   Zeilen [0, k) Rand Nord | [k, k + rows) eigene Zeilen | [k + rows, 2k + rows) Rand Süd
+//   Bits   [64 - k, 64) Rand West | [64, 64 + cols) eigene Spalten | [64 + cols, 64 + cols + k) Rand Ost
+//
+// Die eigenen Spalten beginnen also immer am Anfang von Wort 1, die Zeilenkernel aus LifeKernels.h
+// rechnen unverändert auf den lokalen Zeilen. Spaltengrenzen der Blöcke liegen auf Vielfachen von 64,
+// damit ein Block in jeder Zeile der Weltdatei ein zusammenhängender Bereich ganzer Wörter ist.
+//
+// Ein Schritt tauscht den Rand einmal mit allen acht Nachbarn aus (nicht blockierend; während der
+// Nachrichten wird das Innere berechnet, das keinen Rand braucht) und rechnet danach bis zu k
+// Generationen ohne weitere Kommunikation: mit jeder Generation wird der gültige Bereich um eine
+// Zelle kleiner, nach k Generationen sind genau noch die eigenen Zellen gültig.
+//
+// Alle Methoden ohne gegenteiligen Hinweis sind kollektiv und müssen von allen Prozessen des
+// Kommunikators in derselben Reihenfolge aufgerufen werden.
+class DistributedGrid {
+    public:
+        struct Stats {
+            uint64_t changed;     // veränderte Zellen der letzten Generation (über alle Prozesse)
+            uint64_t population;  // lebende Zellen (über alle Prozesse)
+        };
+
+    private:
+        enum Direction { NORTH, SOUTH, WEST, EAST, NORTH_WEST, NORTH_EAST, SOUTH_WEST, SOUTH_EAST, DIRECTIONS };
+
+        // Rechteck im lokalen Gitter: Zeilen [rowBegin, rowEnd), Bits [bitBegin, bitEnd).
+        struct Region {
+            int rowBegin, rowEnd;
+            int bitBegin, bitEnd;
+        };
+
+        MPI_Comm parent;             // Kommunikator des Aufrufers
+        MPI_Comm comm;               // kartesischer Kommunikator, in beiden Richtungen periodisch (nach setSize())
+        int rank, processes;
+        int dims[2], coords[2];      // Prozessgitter (Zeilen x Spalten) und eigene Position
+        int neighbours[DIRECTIONS];
+        int halo;                    // Randtiefe k = höchstens so viele Generationen pro Austausch
+        int height, width;           // ganzes Gitter
+        int rowOffset, rows;         // eigener Block: erste globale Zeile und Anzahl
+        int colOffset, cols;         // eigener Block: erste globale Spalte (Vielfaches von 64) und Anzahl
+        Rule rule;
+        long long generation;
+        uint64_t lastChanged;        // veränderte eigene Zellen der letzten Generation
+        BitGrid current, next;
+        std::vector<uint64_t> sendBuffers[DIRECTIONS];
+        std::vector<uint64_t> receiveBuffers[DIRECTIONS];
+        MPI_Request requests[2 * DIRECTIONS];
+        std::unique_ptr<ThreadPool> pool;
+
+        int ownWords() const { return (cols + 63) / 64; }
+        uint64_t ownMask(int word) const;   // eigene Bits von Wort word (1 .. ownWords())
+        Region edgeRegion(int direction) const;
+        Region haloRegion(int direction) const;
+        static void pack(const BitGrid &grid, const Region &region, std::vector<uint64_t> &buffer);
+        static void unpack(BitGrid &grid, const Region &region, const std::vector<uint64_t> &buffer);
+        void startExchange();
+        void finishExchange();
+        void evolveBlock(int rowBegin, int rowEnd, int wordBegin, int wordEnd);
+        uint64_t countChanges() const;
+
+        // Dateizugriff: der eigene Block als rows x fileWords() Wörter, wie er in der Weltdatei liegt.
+        int fileWords() const;
+        MPI_Datatype fileType() const;
+        void copyToFile(std::vector<uint64_t> &block) const;
+        void copyFromFile(const std::vector<uint64_t> &block);
+        uint64_t blockChecksum(const std::vector<uint64_t> &block) const;
+        bool allTrue(bool value) const;
+
+    public:
+        // halo ist die Randtiefe (1..64): so viele Generationen werden pro Austausch gerechnet.
+        // threads sind die Threads pro Prozess (1 für einen Prozess pro Kern).
+        DistributedGrid(MPI_Comm world, int halo, int threads = 1);
+        ~DistributedGrid();
+        DistributedGrid(const DistributedGrid &) = delete;
+        DistributedGrid &operator=(const DistributedGrid &) = delete;
+
+        // Verteilt ein leeres h x w Gitter; false (auf allen Prozessen), wenn ein Block schmaler
+        // oder niedriger als der Rand würde.
+        bool setSize(int h, int w);
+        void setRule(const Rule &newRule) { rule = newRule; }  // nicht kollektiv, aber überall gleich setzen
+        // Belegt das Gitter zufällig; das Ergebnis hängt nicht von der Anzahl der Prozesse ab.
+        void fillRandom(double density, uint64_t seed);
+
+        // Liest bzw. schreibt das binäre Weltformat (WorldFile) mit MPI-IO: jeder Prozess liest und
+        // schreibt nur seinen Block; die Prüfsumme setzt sich aus den Teilsummen der Blöcke zusammen
+        // (eine Reduktion). load() übernimmt Größe, Regel und Generation der Datei.
+        bool load(const std::string &filename);
+        bool save(const std::string &filename);
+
+        // Rechnet min(maxGenerations, halo) Generationen mit einem Randaustausch und gibt ihre Anzahl
+        // zurück. Mit countChanges zählt der letzte Schritt die veränderten Zellen für reduceStats().
+        int step(int maxGenerations, bool countChanges);
+        // Summiert veränderte Zellen und Population über alle Prozesse.
+        Stats reduceStats();
+
+        int getHeight() const { return height; }
+        int getWidth() const { return width; }
+        int getHalo() const { return halo; }
+        int getRank() const { return rank; }
+        int getProcesses() const { return processes; }
+        int getProcessRows() const { return dims[0]; }
+        int getProcessCols() const { return dims[1]; }
+        long long getGeneration() const { return generation; }
+        const Rule &getRule() const { return rule; }
+};
+
+#endif // DISTRIBUTEDGRID_H
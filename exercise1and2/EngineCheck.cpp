@@ -0,0 +1,131 @@
+#include "EvolveEngine.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Gleichheitsprüfung aller Engines (make check): jede Engine aus EvolveEngine::names() rechnet
+// dieselben Startzustände wie die zellweise Engine "scalar" über mehrere Größen, Regeln und
+// Einstellungen. Verglichen werden nach jedem Schritt das Gitter sowie veränderte Zellen und Hash
+// der letzten Generation. Engines ohne Gerät (OpenCL) werden übersprungen, nicht als Fehler gezählt.
+
+static const int GENERATIONS = 24;
+
+// Größen mit Rändern innerhalb eines Wortes, genau auf Wortgrenzen und über mehrere Wörter.
+static const int SIZES[][2] = {
+    {1, 1}, {3, 5}, {17, 64}, {33, 65}, {64, 64}, {100, 130}, {128, 256}, {250, 1000}, {256, 64}, {7, 200}
+};
+
+static const char* RULES[] = {"B3/S23", "B36/S23", "B2/S", "B1357/S1357", "B3678/S34678", "B0/S8"};
+
+// Kleinste Kacheln, damit auch kleine Gitter aus vielen Kacheln bestehen, und die Standardgröße.
+static const int TILES[][2] = {{16, 1}, {0, 0}};
+
+static bool sameCells(const BitGrid &a, const BitGrid &b) {
+    int n = a.getWordsPerRow();
+    for (int x = 0; x < a.getHeight(); ++x) {
+        for (int k = 0; k < n; ++k) {
+            if (a.row(x)[k] != b.row(x)[k]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Rechnet einen Fall und gibt false bei einer Abweichung zurück; skipped wird gesetzt, wenn die
+// Engine nicht starten kann, aber nicht grundsätzlich versagt (kein OpenCL-Gerät).
+static bool checkCase(const std::string &engine, const EngineParams &params, int height, int width, bool &skipped) {
+    BitGrid expected(height, width), expectedNext;
+    BitGrid actual(height, width), actualNext;
+    expected.fillRandom(0.35, static_cast<uint64_t>(height) * 1000003 + width);
+    actual = expected;
+
+    std::unique_ptr<EvolveEngine> reference(EvolveEngine::create("scalar", params));
+    std::unique_ptr<EvolveEngine> tested(EvolveEngine::create(engine, params));
+    if (!tested || !reference->attach(expected, expectedNext)) {
+        return false;
+    }
+    if (!tested->attach(actual, actualNext)) {
+        skipped = engine == "opencl";
+        return skipped;
+    }
+
+    int done = 0;
+    while (done < GENERATIONS) {
+        StepStats got;
+        int advanced = tested->step(GENERATIONS - done, &got);
+        if (advanced <= 0 || !tested->sync()) {
+            std::cerr << "  step failed after " << done << " generations\n";
+            return false;
+        }
+        StepStats want;
+        for (int i = 0; i < advanced; ++i) {
+            reference->step(1, &want);
+        }
+        done += advanced;
+        if (!sameCells(expected, actual) || got.changed != want.changed || got.hash != want.hash) {
+            std::cerr << "  mismatch at generation " << done << ": changed " << got.changed << " (expected "
+                      << want.changed << "), hash " << got.hash << " (expected " << want.hash << ")"
+                      << (sameCells(expected, actual) ? "" : ", cells differ") << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Prüft eine Engine in allen Fällen und gibt die Anzahl der Abweichungen zurück.
+static int checkEngine(const std::string &engine) {
+    int passed = 0, unsupported = 0, failed = 0;
+    for (const char* ruleText : RULES) {
+        EngineParams params;
+        params.threads = 3;  // mehrere Bänder auch auf Rechnern mit wenigen Kernen
+        params.generationsPerPass = 8;
+        Rule::parse(ruleText, params.rule);
+        if (!EvolveEngine::supports(engine, params.rule)) {
+            ++unsupported;
+            continue;
+        }
+        for (const int* tile : TILES) {
+            params.tileRows = tile[0];
+            params.tileWords = tile[1];
+            for (const int* size : SIZES) {
+                if (!EvolveEngine::supports(engine, size[0], size[1])) {
+                    ++unsupported;
+                    continue;
+                }
+                bool skipped = false;
+                if (!checkCase(engine, params, size[0], size[1], skipped)) {
+                    std::cerr << "FAILED " << engine << " " << size[0] << "x" << size[1] << " "
+                              << params.describe(engine) << "\n";  // describe() nennt jede Regel außer Conway
+                    ++failed;
+                } else if (skipped) {
+                    std::cout << engine << ": skipped (no device)\n";
+                    return 0;
+                } else {
+                    ++passed;
+                }
+            }
+        }
+    }
+    std::cout << engine << ": " << passed << " cases match scalar";
+    if (unsupported > 0) {
+        std::cout << ", " << unsupported << " unsupported";
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+int main() {
+    int failed = 0;
+    for (const std::string &engine : EvolveEngine::names()) {
+        if (engine != "scalar") {
+            failed += checkEngine(engine);
+        }
+    }
+    if (failed > 0) {
+        std::cout << failed << " cases FAILED\n";
+        return 1;
+    }
+    return 0;
+}
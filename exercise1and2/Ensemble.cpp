@@ -0,0 +1,508 @@
+#include "Ensemble.h"
+#include "Grid.h"
+#include "LifeKernels.h"
+#include "ThreadPool.h"
+#include "OpenCLEnsemble.h"
+#include "Profiling.h"
+#include <iostream>
+#include <chrono>
+#include <atomic>
+#include <map>
+#include <cstring>
+
+Ensemble::Ensemble()
+    : packedCount(0), current(0), totalRows(0), threadCount(0), kernelPath(kernel_path), deviceDirty(true) {}
+
+Ensemble::~Ensemble() = default;
+
+int Ensemble::add(const BitGrid &grid) {
+    if (grid.getHeight() <= 0 || grid.getWidth() <= 0) {
+        std::cerr << "Error: cannot add an empty world to the ensemble" << std::endl;
+        return -1;
+    }
+    World world;
+    world.height = grid.getHeight();
+    world.width = grid.getWidth();
+    world.sliced = false;
+    world.offset = 0;
+    world.firstRow = 0;
+    world.batch = -1;
+    world.lane = 0;
+    world.stable = false;
+    world.generations = 0;
+
+    // Die Welt wird erst beim nächsten Lauf zusammen mit allen anderen gepackt.
+    worlds.push_back(world);
+    staged.push_back(grid);
+    deviceDirty = true;
+    return static_cast<int>(worlds.size()) - 1;
+}
+
+int Ensemble::add(const Grid &grid) {
+    BitGrid copy(grid.getHeight(), grid.getWidth());
+    for (int x = 0; x < grid.getHeight(); ++x) {
+        for (int y = 0; y < grid.getWidth(); ++y) {
+            copy.set(x, y, grid.getCell(x, y));
+        }
+    }
+    return add(copy);
+}
+
+void Ensemble::addRandom(int count, int h, int w, double density, uint64_t seed) {
+    BitGrid grid(h, w);
+    for (int i = 0; i < count; ++i) {
+        grid.fillRandom(density, seed + static_cast<uint64_t>(worlds.size()));
+        add(grid);
+    }
+}
+
+void Ensemble::clear() {
+    worlds.clear();
+    staged.clear();
+    packedCount = 0;
+    batches.clear();
+    rowWorlds.clear();
+    for (int i = 0; i < 2; ++i) {
+        rows[i].clear();
+        slices[i].clear();
+    }
+    current = 0;
+    totalRows = 0;
+    tasks.clear();
+    deviceDirty = true;
+}
+
+void Ensemble::setThreadCount(int threads) {
+    threadCount = threads < 0 ? 0 : threads;
+}
+
+void Ensemble::setKernelPath(const std::string &path) {
+    kernelPath = path;
+}
+
+void Ensemble::setRule(const Rule &newRule) {
+    if (newRule != rule) {
+        rule = newRule;
+        deviceDirty = true;  // das Programm wird für die neue Regel neu gebaut
+    }
+}
+
+long long Ensemble::generationsOf(const World &world) const {
+    // Laufende Welten einer Gruppe zählen die Schritte der Gruppe seit dem Packen mit.
+    if (world.sliced && !world.stable) {
+        return world.generations + batches[world.batch].steps;
+    }
+    return world.generations;
+}
+
+void Ensemble::extractPacked(int index, BitGrid &grid) const {
+    const World &world = worlds[index];
+    grid.resize(world.height, world.width);
+    if (world.sliced) {
+        const uint64_t* words = slices[current].data() + batches[world.batch].offset;
+        for (int x = 0; x < world.height; ++x) {
+            for (int y = 0; y < world.width; ++y) {
+                grid.set(x, y, (words[static_cast<size_t>(x) * world.width + y] >> world.lane) & 1ULL);
+            }
+        }
+    } else {
+        int n = grid.getWordsPerRow();
+        for (int x = 0; x < world.height; ++x) {
+            std::memcpy(grid.row(x), &rows[current][world.offset + static_cast<size_t>(x) * n], n * sizeof(uint64_t));
+        }
+    }
+}
+
+void Ensemble::pack() {
+    if (packedCount == size() && !tasks.empty()) {
+        return;
+    }
+    GOL_PROFILE_SCOPE("ensemble.pack");
+
+    // Alle Zustände herausholen und das Layout für die aktuelle Menge der Welten neu aufbauen.
+    std::vector<BitGrid> states(worlds.size());
+    for (int i = 0; i < packedCount; ++i) {
+        extractPacked(i, states[i]);
+        worlds[i].generations = generationsOf(worlds[i]);
+    }
+    for (int i = packedCount; i < size(); ++i) {
+        states[i].swap(staged[i - packedCount]);
+    }
+    staged.clear();
+
+    batches.clear();
+    rowWorlds.clear();
+    for (int i = 0; i < 2; ++i) {
+        rows[i].clear();
+        slices[i].clear();
+    }
+    current = 0;
+    totalRows = 0;
+
+    std::map<std::pair<int, int>, std::vector<int>> bySize;
+    for (int i = 0; i < size(); ++i) {
+        bySize[{worlds[i].height, worlds[i].width}].push_back(i);
+    }
+
+    for (const auto &group : bySize) {
+        int h = group.first.first;
+        int w = group.first.second;
+        const std::vector<int> &members = group.second;
+        size_t count = members.size();
+        size_t words = static_cast<size_t>(w + 63) / 64;
+
+        // Wörter pro Zeile aller Welten dieser Größe: verschränkt w pro 64 Welten, sonst ein Zeilenwort
+        // pro Welt. Die günstigere Form wird genommen; einzelne Welten bleiben so immer im Zeilen-Layout.
+        if ((count + 63) / 64 * w < count * words) {
+            for (size_t first = 0; first < count; first += 64) {
+                Batch batch;
+                batch.height = h;
+                batch.width = w;
+                batch.offset = slices[0].size();
+                batch.running = 0;
+                batch.steps = 0;
+                slices[0].resize(batch.offset + static_cast<size_t>(h) * w, 0);
+                uint64_t* cells = slices[0].data() + batch.offset;
+                for (size_t k = first; k < count && k < first + 64; ++k) {
+                    int lane = static_cast<int>(k - first);
+                    World &world = worlds[members[k]];
+                    world.sliced = true;
+                    world.batch = static_cast<int>(batches.size());
+                    world.lane = lane;
+                    const BitGrid &state = states[members[k]];
+                    for (int x = 0; x < h; ++x) {
+                        for (int y = 0; y < w; ++y) {
+                            cells[static_cast<size_t>(x) * w + y] |= static_cast<uint64_t>(state.get(x, y)) << lane;
+                        }
+                    }
+                    batch.members.push_back(members[k]);
+                    batch.running |= world.stable ? 0 : (1ULL << lane);
+                }
+                batches.push_back(batch);
+            }
+        } else {
+            // Die Zeilen werden ohne die Auffüllung von BitGrid übernommen.
+            for (int index : members) {
+                World &world = worlds[index];
+                world.sliced = false;
+                world.batch = -1;
+                world.offset = rows[0].size();
+                world.firstRow = totalRows;
+                rows[0].resize(world.offset + static_cast<size_t>(h) * words);
+                for (int x = 0; x < h; ++x) {
+                    std::memcpy(&rows[0][world.offset + static_cast<size_t>(x) * words], states[index].row(x),
+                                words * sizeof(uint64_t));
+                }
+                totalRows += h;
+                rowWorlds.push_back(index);
+            }
+        }
+    }
+    // Beide Puffer bekommen den Startzustand, da stabile Welten nicht mehr geschrieben werden.
+    rows[1] = rows[0];
+    slices[1] = slices[0];
+
+    // Jede Gruppe ist ein Arbeitspaket; Zeilen-Welten werden zu Paketen von etwa CHUNK_WORDS
+    // Wörtern zusammengefasst, damit sich kleine Welten die Verwaltung teilen.
+    tasks.clear();
+    for (size_t b = 0; b < batches.size(); ++b) {
+        tasks.push_back(Task{static_cast<int>(b), 0, 0});
+    }
+    size_t chunkWords = 0;
+    for (size_t r = 0; r < rowWorlds.size(); ++r) {
+        if (r == 0 || chunkWords >= static_cast<size_t>(CHUNK_WORDS)) {
+            tasks.push_back(Task{-1, static_cast<int>(r), static_cast<int>(r)});
+            chunkWords = 0;
+        }
+        const World &world = worlds[rowWorlds[r]];
+        chunkWords += static_cast<size_t>(world.height) * ((world.width + 63) / 64);
+        tasks.back().end = static_cast<int>(r) + 1;
+    }
+    packedCount = size();
+    deviceDirty = true;
+}
+
+template <class Logic>
+void Ensemble::evolveRowWorld(const Logic &logic, World &world, const uint64_t* src, uint64_t* dst) {
+    int h = world.height;
+    int n = (world.width + 63) / 64;
+    uint64_t changed = 0;  // ODER aller Unterschiede; für die Stabilität reicht "irgendein Bit"
+
+    if (n == 1) {
+        // Schmale Welten (bis 64 Spalten): eine Zeile ist ein Wort. Der toroidale Rand ist eine
+        // Rotation innerhalb der Breite; West- und Ostnachbarn werden pro Zeile nur einmal gebildet.
+        int t = world.width;
+        uint64_t mask = t == 64 ? ~0ULL : ((1ULL << t) - 1);
+        auto west = [t](uint64_t v) { return (v << 1) | (v >> (t - 1)); };
+        auto east = [t](uint64_t v) { return (v >> 1) | ((v & 1ULL) << (t - 1)); };
+
+        uint64_t up = src[h - 1], upW = west(up), upE = east(up);
+        uint64_t mid = src[0], midW = west(mid), midE = east(mid);
+        for (int x = 0; x < h; ++x) {
+            uint64_t down = src[x + 1 < h ? x + 1 : 0];
+            uint64_t downW = west(down), downE = east(down);
+            // Die Maske hält die Bits hinter der Breite leer, auch bei Regeln mit Geburt bei 0 Nachbarn.
+            uint64_t result = ruleWord(logic, upW, up, upE, midW, mid, midE, downW, down, downE) & mask;
+            dst[x] = result;
+            changed |= result ^ mid;
+            up = mid; upW = midW; upE = midE;
+            mid = down; midW = downW; midE = downE;
+        }
+    } else {
+        // Breitere Welten verwenden die Zeilenkernel der großen Gitter.
+        for (int x = 0; x < h; ++x) {
+            const uint64_t* up = src + static_cast<size_t>((x - 1 + h) % h) * n;
+            const uint64_t* mid = src + static_cast<size_t>(x) * n;
+            const uint64_t* down = src + static_cast<size_t>((x + 1) % h) * n;
+            uint64_t* out = dst + static_cast<size_t>(x) * n;
+            evolveRow(up, mid, down, out, n, world.width, rule);
+            for (int k = 0; k < n; ++k) {
+                changed |= out[k] ^ mid[k];
+            }
+        }
+    }
+
+    ++world.generations;
+    world.stable = changed == 0;  // beide Puffer sind jetzt gleich, die Welt kann ruhen
+}
+
+template <class Logic>
+void Ensemble::evolveBatch(const Logic &logic, Batch &batch, const uint64_t* src, uint64_t* dst) {
+    int h = batch.height;
+    int w = batch.width;
+    uint64_t changed = 0;  // Bit i: Welt i hat sich in diesem Schritt verändert
+
+    // Die Nachbarn einer Zelle sind die Nachbarwörter; ruleWord rechnet so 64 Welten auf einmal.
+    for (int x = 0; x < h; ++x) {
+        const uint64_t* up = src + static_cast<size_t>(x == 0 ? h - 1 : x - 1) * w;
+        const uint64_t* mid = src + static_cast<size_t>(x) * w;
+        const uint64_t* down = src + static_cast<size_t>(x + 1 == h ? 0 : x + 1) * w;
+        uint64_t* out = dst + static_cast<size_t>(x) * w;
+        // Randspalten mit Umbruch einzeln, dazwischen ohne Verzweigung.
+        auto cell = [&](int y, int west, int east) {
+            uint64_t result = ruleWord(logic, up[west], up[y], up[east], mid[west], mid[y], mid[east],
+                                       down[west], down[y], down[east]);
+            out[y] = result;
+            changed |= result ^ mid[y];
+        };
+        cell(0, w - 1, w > 1 ? 1 : 0);
+        for (int y = 1; y < w - 1; ++y) {
+            cell(y, y - 1, y + 1);
+        }
+        if (w > 1) {
+            cell(w - 1, w - 2, 0);
+        }
+    }
+
+    // Stabile Welten werden weiter mitgerechnet (ihr Zustand ändert sich nicht), zählen aber
+    // keine Generationen mehr. Unbelegte Bits gehören zu keiner Welt und sind nie in running.
+    ++batch.steps;
+    uint64_t settled = batch.running & ~changed;
+    while (settled != 0) {
+        World &world = worlds[batch.members[__builtin_ctzll(settled)]];
+        world.stable = true;
+        world.generations += batch.steps;
+        settled &= settled - 1;
+    }
+    batch.running &= changed;
+}
+
+void Ensemble::runCpu(int generations) {
+    pack();
+    // Die Regel wird einmal pro Lauf ausgewählt; die Schleifen darunter sind für sie übersetzt.
+    visitRule(rule, [&](const auto &logic) { runCpuSteps(logic, generations); });
+}
+
+template <class Logic>
+void Ensemble::runCpuSteps(const Logic &logic, int generations) {
+    ThreadPool pool(threadCount);
+    int taskCount = static_cast<int>(tasks.size());
+    std::atomic<int> nextTask(0);
+    std::atomic<int> running(1);
+
+    for (int step = 0; step < generations && running.load(std::memory_order_relaxed) > 0; ++step) {
+        const uint64_t* rowSrc = rows[current].data();
+        uint64_t* rowDst = rows[1 - current].data();
+        const uint64_t* sliceSrc = slices[current].data();
+        uint64_t* sliceDst = slices[1 - current].data();
+        nextTask.store(0, std::memory_order_relaxed);
+        running.store(0, std::memory_order_relaxed);
+
+        // Ein Auftrag für alle Welten; die Pakete werden dynamisch verteilt, da stabile Welten nichts kosten.
+        pool.run([&](int) {
+            int active = 0;
+            for (int t = nextTask.fetch_add(1, std::memory_order_relaxed); t < taskCount;
+                 t = nextTask.fetch_add(1, std::memory_order_relaxed)) {
+                const Task &task = tasks[t];
+                if (task.batch >= 0) {
+                    Batch &batch = batches[task.batch];
+                    if (batch.running != 0) {
+                        evolveBatch(logic, batch, sliceSrc + batch.offset, sliceDst + batch.offset);
+                        active += __builtin_popcountll(batch.running);
+                    }
+                    continue;
+                }
+                for (int r = task.begin; r < task.end; ++r) {
+                    World &world = worlds[rowWorlds[r]];
+                    if (!world.stable) {
+                        evolveRowWorld(logic, world, rowSrc + world.offset, rowDst + world.offset);
+                        active += world.stable ? 0 : 1;
+                    }
+                }
+            }
+            running.fetch_add(active, std::memory_order_relaxed);
+        });
+        current = 1 - current;
+    }
+    deviceDirty = true;  // die Kopie auf dem Gerät ist veraltet
+}
+
+bool Ensemble::runOpenCL(int generations) {
+    pack();
+    if (!opencl) {
+        opencl.reset(new OpenCLEnsemble());
+    }
+    if (!opencl->initialize(kernelPath, rule)) {
+        return false;
+    }
+
+    std::vector<cl_uchar> stable(worlds.size());
+    std::vector<cl_long> worldGenerations(worlds.size());
+    if (deviceDirty) {
+        OpenCLEnsemble::Layout layout;
+        layout.rowWorld.reserve(totalRows);
+        for (int index : rowWorlds) {
+            layout.rowWorld.insert(layout.rowWorld.end(), worlds[index].height, static_cast<cl_uint>(index));
+        }
+        for (const Batch &batch : batches) {
+            layout.batchOffset.push_back(batch.offset);
+            layout.batchHeight.push_back(batch.height);
+            layout.batchWidth.push_back(batch.width);
+        }
+        for (size_t i = 0; i < worlds.size(); ++i) {
+            const World &world = worlds[i];
+            layout.worldBatch.push_back(world.sliced ? world.batch : -1);
+            layout.worldLane.push_back(world.lane);
+            layout.worldFirstRow.push_back(static_cast<cl_uint>(world.firstRow));
+            layout.worldHeight.push_back(world.height);
+            layout.worldWidth.push_back(world.width);
+            layout.worldOffset.push_back(world.offset);
+            stable[i] = world.stable ? 1 : 0;
+            worldGenerations[i] = generationsOf(world);
+        }
+        if (!opencl->upload(rows[current], slices[current], layout, stable, worldGenerations)) {
+            return false;
+        }
+        deviceDirty = false;
+    }
+
+    // Alle 32 Generationen wird geprüft, ob noch eine Welt läuft.
+    if (opencl->run(generations, 32) < 0) {
+        return false;
+    }
+
+    // Die Ergebnisse werden am Ende des Laufs einmal zurückgelesen; das Gerät zählt die Generationen
+    // aller Welten selbst, die Schritte der Gruppen beginnen daher wieder bei null.
+    if (!opencl->download(rows[current], slices[current], stable, worldGenerations)) {
+        return false;
+    }
+    rows[1 - current] = rows[current];
+    slices[1 - current] = slices[current];
+    for (Batch &batch : batches) {
+        batch.steps = 0;
+        batch.running = 0;
+    }
+    for (size_t i = 0; i < worlds.size(); ++i) {
+        World &world = worlds[i];
+        world.stable = stable[i] != 0;
+        world.generations = worldGenerations[i];
+        if (world.sliced && !world.stable) {
+            batches[world.batch].running |= 1ULL << world.lane;
+        }
+    }
+    return true;
+}
+
+long long Ensemble::run(int generations, Device device) {
+    // Erfasse den Startzeitpunkt der Berechnung
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    if (device == Device::OpenCL) {
+        if (!runOpenCL(generations)) {
+            return -1;
+        }
+    } else {
+        GOL_PROFILE_SCOPE("ensemble.cpu");
+        runCpu(generations);
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    return duration.count();
+}
+
+int Ensemble::stableCount() const {
+    int count = 0;
+    for (const World &world : worlds) {
+        count += world.stable ? 1 : 0;
+    }
+    return count;
+}
+
+Ensemble::WorldResult Ensemble::result(int index) const {
+    const World &world = worlds[index];
+    WorldResult r{world.height, world.width, generationsOf(world), world.stable, 0, 0};
+
+    // Population und Hash werden aus dem Zustand berechnet, damit die Schritte selbst nur das
+    // Stabilitätsbit brauchen; der Hash entspricht dem von evolveGeneration() für ein BitGrid.
+    BitGrid state;
+    extract(index, state);
+    StepStats stats;
+    int n = state.getWordsPerRow();
+    for (int x = 0; x < state.getHeight(); ++x) {
+        const uint64_t* words = state.row(x);
+        for (int k = 0; k < n; ++k) {
+            r.population += __builtin_popcountll(words[k]);
+        }
+        accumulateWords(words, words, n, static_cast<uint64_t>(x) * n, stats);
+    }
+    r.hash = stats.hash;
+    return r;
+}
+
+bool Ensemble::extract(int index, BitGrid &grid) const {
+    if (index < 0 || index >= size()) {
+        std::cerr << "Error: no world " << index << " in the ensemble" << std::endl;
+        return false;
+    }
+    if (index >= packedCount) {
+        grid = staged[index - packedCount];
+    } else {
+        extractPacked(index, grid);
+    }
+    return true;
+}
+
+bool Ensemble::extract(int index, Grid &grid) const {
+    BitGrid copy;
+    if (!extract(index, copy)) {
+        return false;
+    }
+    grid.setSize(copy.getHeight(), copy.getWidth());
+    for (int x = 0; x < copy.getHeight(); ++x) {
+        for (int y = 0; y < copy.getWidth(); ++y) {
+            grid.setCell(x, y, copy.get(x, y));
+        }
+    }
+    return true;
+}
+
+bool Ensemble::writeResults(std::ostream &out) const {
+    out << "world,height,width,generations,stable,population,hash\n";
+    for (int i = 0; i < size(); ++i) {
+        WorldResult r = result(i);
+        out << i << "," << r.height << "," << r.width << "," << r.generations << "," << (r.stable ? 1 : 0)
+            << "," << r.population << "," << r.hash << "\n";
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,130 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <ostream>
+#include <cstdint>
+#include "BitGrid.h"
+#include "Rule.h"
+
+class Grid;
+class OpenCLEnsemble;
+
+// Viele kleine, voneinander unabhängige Welten in einer gemeinsamen Struktur (z.B. für
+// Parameterstudien). Ein Schritt berechnet alle Welten mit einem einzigen Auftrag an den
+// Thread-Pool bzw. einer festen Anzahl von Kernel-Starts, statt pro Welt Threads, Puffer oder
+// Programme anzulegen. Jede Welt behält ihre eigene Größe und ihren eigenen toroidalen Rand.
+//
+// Gespeichert wird in zwei Formen, die beim Packen vor dem ersten Lauf gewählt werden:
+// - Scheiben: bis zu 64 gleich große Welten werden bitweise verschränkt, Bit i von Wort (x, y)
+//   ist Zelle (x, y) der i-ten Welt der Gruppe. Ein Wort rechnet so dieselbe Zelle in 64 Welten,
+//   die Nachbarn sind einfach die Nachbarwörter. Das lohnt sich für viele schmale Welten.
+// - Zeilen: wie BitGrid 64 Zellen einer Zeile pro Wort, aber ohne Auffüllung hintereinander.
+//   Das bleibt für breite Welten und für Größen, die nur selten vorkommen.
+// So wachsen die Kosten mit der Gesamtzahl der Zellen und nicht mit der Anzahl der Welten.
+//
+// Eine Welt, die sich nicht mehr verändert, wird als stabil markiert und zählt keine Generationen
+// mehr; sind alle Welten stabil, endet run() vorzeitig.
+class Ensemble {
+    public:
+        enum class Device { Cpu, OpenCL };
+
+        struct WorldResult {
+            int height, width;
+            long long generations;  // berechnete Generationen; bei stabilen Welten bis zur Erkennung
+            bool stable;            // die letzte Generation hat keine Zelle verändert
+            uint64_t population;    // lebende Zellen im aktuellen Zustand
+            uint64_t hash;          // Hash des aktuellen Zustands wie StepStats::hash eines BitGrid
+        };
+
+    private:
+        struct World {
+            int height, width;
+            bool sliced;            // liegt in einer Gruppe des Scheiben-Layouts
+            size_t offset;          // Zeilen-Layout: erstes Wort der Welt
+            int firstRow;           // Zeilen-Layout: erste Zeile über alle Zeilen-Welten
+            int batch, lane;        // Scheiben-Layout: Gruppe und Bit
+            bool stable;
+            long long generations;  // im Scheiben-Layout ohne die Schritte der laufenden Gruppe
+        };
+
+        struct Batch {
+            int height, width;
+            size_t offset;             // erstes Wort der Gruppe
+            std::vector<int> members;  // Welt pro Bit
+            uint64_t running;          // Bits der noch nicht stabilen Welten
+            long long steps;           // seit dem Packen berechnete Generationen
+        };
+
+        // Arbeitspaket: eine Gruppe (batch >= 0) oder die Zeilen-Welten rowWorlds[begin, end).
+        struct Task {
+            int batch;
+            int begin, end;
+        };
+
+        std::vector<World> worlds;
+        std::vector<BitGrid> staged;      // seit dem letzten Packen hinzugefügte Welten
+        int packedCount;                  // Welten [0, packedCount) liegen in rows bzw. slices
+        std::vector<Batch> batches;
+        std::vector<int> rowWorlds;       // Welten im Zeilen-Layout
+        std::vector<uint64_t> rows[2];    // Zeilen-Layout: aktuelle und nächste Generation
+        std::vector<uint64_t> slices[2];  // Scheiben-Layout: aktuelle und nächste Generation
+        int current;                      // Index der Puffer mit der aktuellen Generation
+        int totalRows;                    // Zeilen aller Zeilen-Welten
+        std::vector<Task> tasks;
+        int threadCount;
+        Rule rule;
+        std::string kernelPath;
+        std::unique_ptr<OpenCLEnsemble> opencl;  // wird beim ersten Lauf auf dem Gerät angelegt
+        bool deviceDirty;                        // Welten wurden seit dem letzten Hochladen verändert
+
+        void pack();
+        void extractPacked(int index, BitGrid &grid) const;
+        long long generationsOf(const World &world) const;
+        // Logic ist die Regel als FixedRule oder MaskedRule (siehe visitRule() in LifeKernels.h).
+        template <class Logic>
+        void evolveRowWorld(const Logic &logic, World &world, const uint64_t* src, uint64_t* dst);
+        template <class Logic>
+        void evolveBatch(const Logic &logic, Batch &batch, const uint64_t* src, uint64_t* dst);
+        template <class Logic>
+        void runCpuSteps(const Logic &logic, int generations);
+        void runCpu(int generations);
+        bool runOpenCL(int generations);
+
+    public:
+        // Wörter, ab denen aufeinanderfolgende Zeilen-Welten ein eigenes Arbeitspaket bilden.
+        static const int CHUNK_WORDS = 2048;
+
+        Ensemble();
+        ~Ensemble();
+
+        // Fügt eine Welt mit dem Zustand von grid hinzu und gibt ihren Index zurück (-1 bei leerem Gitter).
+        int add(const BitGrid &grid);
+        int add(const Grid &grid);
+        // Fügt count Welten der Größe h x w mit zufälliger Belegung hinzu (Startwert seed + Index).
+        void addRandom(int count, int h, int w, double density, uint64_t seed);
+        void clear();
+        int size() const { return static_cast<int>(worlds.size()); }
+
+        void setThreadCount(int threads);
+        void setKernelPath(const std::string &path);
+        // Regel für alle Welten, Standard Conway.
+        void setRule(const Rule &newRule);
+        const Rule &getRule() const { return rule; }
+
+        // Rechnet alle noch nicht stabilen Welten bis zu 'generations' Generationen weiter und gibt
+        // die benötigte Zeit in Millisekunden zurück (-1 bei einem Fehler des Geräts).
+        long long run(int generations, Device device = Device::Cpu);
+
+        int stableCount() const;
+        WorldResult result(int index) const;
+        // Kopiert den aktuellen Zustand einer Welt heraus.
+        bool extract(int index, BitGrid &grid) const;
+        bool extract(int index, Grid &grid) const;
+        // Eine Zeile pro Welt: Index, Größe, Generationen, Stabilität, Population und Hash als CSV.
+        bool writeResults(std::ostream &out) const;
+};
+
+#endif // ENSEMBLE_H
@@ -0,0 +1,469 @@
+#include "EvolveEngine.h"
+#include "LutKernels.h"
+#include "ThreadPool.h"
+#include "ActiveTiles.h"
+#include "TemporalBlocking.h"
+#include "Hashlife.h"
+#include "OpenCLEngine.h"
+#include <iostream>
+#include <sstream>
+#include <memory>
+
+EngineParams::EngineParams()
+    : threads(0), tileRows(0), tileWords(0), generationsPerPass(8),
+      localX(0), localY(0), cellsPerItem(0), kernelPath("game_of_life.cl") {}
+
+bool EngineParams::operator==(const EngineParams &other) const {
+    return threads == other.threads && tileRows == other.tileRows && tileWords == other.tileWords
+        && generationsPerPass == other.generationsPerPass && localX == other.localX
+        && localY == other.localY && cellsPerItem == other.cellsPerItem && kernelPath == other.kernelPath
+        && rule == other.rule;
+}
+
+std::string EngineParams::describe(const std::string &engine) const {
+    std::ostringstream out;
+    if (!rule.isConway()) {
+        out << "rule=" << rule.toString() << " ";
+    }
+    if (engine == "opencl") {
+        if (localX > 0) {
+            out << "group=" << localX << "x" << localY << " cells=" << cellsPerItem;
+        } else {
+            out << "device defaults";
+        }
+        return out.str();
+    }
+    if (engine != "hashlife") {
+        out << "threads=" << ThreadPool::resolveThreadCount(threads);
+    }
+    if ((engine == "active-tiles" || engine == "temporal-blocking") && tileRows > 0) {
+        out << " tile=" << tileRows << "x" << tileWords * 64;
+    }
+    if (engine == "temporal-blocking" || engine == "hashlife") {
+        out << (engine == "hashlife" ? "" : " ") << "generations/pass=" << generationsPerPass;
+    }
+    return out.str();
+}
+
+// Wortparallele CPU-Version mit Zeilenbändern auf dem Thread-Pool. Basis der übrigen CPU-Engines,
+// die den Pool und die beiden Puffer übernehmen.
+class BitwiseEvolve : public EvolveEngine {
+    protected:
+        EngineParams params;
+        std::unique_ptr<ThreadPool> pool;
+        BitGrid* current;
+        BitGrid* next;
+        std::vector<StepStats> partials;  // ein Eintrag pro Band, am Ende aufsummiert
+
+        // Verteilt 'total' Einheiten in Bändern auf den Pool und summiert die Statistik der Bänder.
+        template <typename Band>
+        void runBands(int total, StepStats *stats, Band band) {
+            int parts = pool->size();
+            if (parts == 1 || total < parts) {
+                band(0, total, stats);
+            } else {
+                partials.assign(parts, StepStats());
+                pool->run([&](int index) {
+                    std::pair<int, int> range = ThreadPool::band(total, parts, index);
+                    band(range.first, range.second, stats ? &partials[index] : nullptr);
+                });
+                if (stats) {
+                    for (const StepStats &partial : partials) {
+                        *stats += partial;
+                    }
+                }
+            }
+        }
+
+        // Der Pool lebt so lange wie die Engine und wird nur bei einer anderen Thread-Anzahl neu gestartet.
+        void preparePool() {
+            if (!pool || pool->size() != ThreadPool::resolveThreadCount(params.threads)) {
+                pool.reset(new ThreadPool(params.threads));
+            }
+        }
+
+    public:
+        explicit BitwiseEvolve(const EngineParams &p) : params(p), current(nullptr), next(nullptr) {}
+
+        const char* name() const override { return "bitwise"; }
+
+        bool attach(BitGrid &currentGrid, BitGrid &nextGrid) override {
+            preparePool();
+            current = &currentGrid;
+            next = &nextGrid;
+            next->resize(current->getHeight(), current->getWidth());
+            return true;
+        }
+
+        int step(int, StepStats *stats) override {
+            if (stats) {
+                *stats = StepStats();
+            }
+            runBands(current->getHeight(), stats, [&](int begin, int end, StepStats *partial) {
+                evolveRows(*current, *next, begin, end, params.rule, partial);
+            });
+            current->swap(*next);
+            return 1;
+        }
+};
+
+// Zellweise Referenz: zählt für jede Zelle die acht Nachbarn auf dem Torus und wendet Rule::next() an.
+// Langsam, aber unabhängig von den Wortkernen und damit der Maßstab für deren Ergebnisse.
+class ScalarEvolve : public BitwiseEvolve {
+    public:
+        explicit ScalarEvolve(const EngineParams &p) : BitwiseEvolve(p) {}
+
+        const char* name() const override { return "scalar"; }
+
+        int step(int, StepStats *stats) override {
+            if (stats) {
+                *stats = StepStats();
+            }
+            int height = current->getHeight();
+            int width = current->getWidth();
+            int words = current->getWordsPerRow();
+            runBands(height, stats, [&](int begin, int end, StepStats *partial) {
+                for (int x = begin; x < end; ++x) {
+                    for (int y = 0; y < width; ++y) {
+                        int count = 0;
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            for (int dy = -1; dy <= 1; ++dy) {
+                                if (dx != 0 || dy != 0) {
+                                    count += current->get((x + dx + height) % height, (y + dy + width) % width) ? 1 : 0;
+                                }
+                            }
+                        }
+                        next->set(x, y, params.rule.next(current->get(x, y), count));
+                    }
+                    if (partial) {
+                        accumulateWords(current->row(x), next->row(x), words, static_cast<uint64_t>(x) * words, *partial);
+                    }
+                }
+            });
+            current->swap(*next);
+            return 1;
+        }
+};
+
+// Rechnet im Gitter selbst statt in einen zweiten Puffer (siehe evolveRowsInPlace()): gehalten wird nur
+// eine Generation, dazu pro Band die ursprünglichen Zeilen an seinen Grenzen und zwei Zeilen als Ring.
+// Die Grenzzeilen werden vor dem Start aller Bänder kopiert, weil das Nachbarband sie überschreibt.
+class InPlaceEvolve : public BitwiseEvolve {
+    private:
+        std::vector<uint64_t> rows;  // pro Band: Zeile darüber, Zeile darunter, zwei Zeilen Ring
+
+    public:
+        explicit InPlaceEvolve(const EngineParams &p) : BitwiseEvolve(p) {}
+
+        const char* name() const override { return "in-place"; }
+
+        bool attach(BitGrid &currentGrid, BitGrid &nextGrid) override {
+            preparePool();
+            current = &currentGrid;
+            next = nullptr;
+            nextGrid.resize(0, 0);  // der zweite Puffer einer vorherigen Engine wird freigegeben
+            return true;
+        }
+
+        int step(int, StepStats *stats) override {
+            if (stats) {
+                *stats = StepStats();
+            }
+            int height = current->getHeight();
+            int n = current->getWordsPerRow();
+            if (height == 0 || n == 0) {
+                return 1;
+            }
+            int parts = height < pool->size() ? 1 : pool->size();
+            rows.resize(4 * static_cast<size_t>(n) * parts);
+            for (int index = 0; index < parts; ++index) {
+                std::pair<int, int> range = ThreadPool::band(height, parts, index);
+                const uint64_t* above = current->row((range.first - 1 + height) % height);
+                const uint64_t* below = current->row(range.second % height);
+                uint64_t* saved = &rows[4 * static_cast<size_t>(n) * index];
+                std::copy(above, above + n, saved);
+                std::copy(below, below + n, saved + n);
+            }
+
+            auto band = [&](int index, StepStats *partial) {
+                std::pair<int, int> range = ThreadPool::band(height, parts, index);
+                uint64_t* saved = &rows[4 * static_cast<size_t>(n) * index];
+                evolveRowsInPlace(*current, range.first, range.second, saved, saved + n, saved + 2 * n,
+                                  params.rule, partial);
+            };
+            if (parts == 1) {
+                band(0, stats);
+            } else {
+                partials.assign(parts, StepStats());
+                pool->run([&](int index) { band(index, stats ? &partials[index] : nullptr); });
+                if (stats) {
+                    for (const StepStats &partial : partials) {
+                        *stats += partial;
+                    }
+                }
+            }
+            return 1;
+        }
+};
+
+// Nachschlagetabelle 4x4 -> 2x2, verteilt in Bändern von Zeilenpaaren.
+class LookupTableEvolve : public BitwiseEvolve {
+    private:
+        std::vector<uint8_t> table;
+
+    public:
+        explicit LookupTableEvolve(const EngineParams &p) : BitwiseEvolve(p) {}
+
+        const char* name() const override { return "lookup-table"; }
+
+        bool attach(BitGrid &currentGrid, BitGrid &nextGrid) override {
+            if (table.empty()) {
+                table = buildLookupTable(params.rule);  // die Tabelle wird beim ersten Aufruf berechnet
+            }
+            return BitwiseEvolve::attach(currentGrid, nextGrid);
+        }
+
+        int step(int, StepStats *stats) override {
+            if (stats) {
+                *stats = StepStats();
+            }
+            runBands(lutRowPairs(current->getHeight()), stats, [&](int begin, int end, StepStats *partial) {
+                evolveRowPairsLut(*current, *next, table.data(), begin, end, partial);
+            });
+            current->swap(*next);
+            return 1;
+        }
+};
+
+// Nur Kacheln mit veränderter Nachbarschaft werden neu berechnet (siehe ActiveTiles.h).
+class ActiveTilesEvolve : public BitwiseEvolve {
+    private:
+        std::unique_ptr<ActiveTileEngine> tiles;
+
+    public:
+        explicit ActiveTilesEvolve(const EngineParams &p) : BitwiseEvolve(p) {}
+
+        const char* name() const override { return "active-tiles"; }
+
+        bool attach(BitGrid &currentGrid, BitGrid &nextGrid) override {
+            // Nach einem neuen Startzustand gelten alle Kacheln wieder als verändert.
+            tiles.reset(params.tileRows > 0 ? new ActiveTileEngine(params.tileRows, params.tileWords)
+                                            : new ActiveTileEngine());
+            tiles->setRule(params.rule);
+            tiles->reset(currentGrid.getHeight(), currentGrid.getWidth());
+            return BitwiseEvolve::attach(currentGrid, nextGrid);
+        }
+
+        int step(int, StepStats *stats) override {
+            StepStats result = tiles->step(*current, *next, pool.get());
+            if (stats) {
+                *stats = result;
+            }
+            current->swap(*next);
+            return 1;
+        }
+};
+
+// Mehrere Generationen pro Durchlauf in cache-großen Kacheln (siehe TemporalBlocking.h).
+class TemporalBlockingEvolve : public BitwiseEvolve {
+    private:
+        std::unique_ptr<TemporalBlockEngine> blocks;
+
+    public:
+        explicit TemporalBlockingEvolve(const EngineParams &p) : BitwiseEvolve(p) {
+            blocks.reset(params.tileRows > 0
+                ? new TemporalBlockEngine(params.generationsPerPass, params.tileRows, params.tileWords)
+                : new TemporalBlockEngine(params.generationsPerPass));
+            blocks->setRule(params.rule);
+        }
+
+        const char* name() const override { return "temporal-blocking"; }
+
+        int generationsPerStep() const override { return blocks->getGenerationsPerPass(); }
+
+        int step(int maxGenerations, StepStats *stats) override {
+            int count = maxGenerations < generationsPerStep() ? maxGenerations : generationsPerStep();
+            if (count < 1) {
+                count = 1;
+            }
+            StepStats result = blocks->step(*current, *next, count, pool.get());
+            if (stats) {
+                *stats = result;
+            }
+            current->swap(*next);
+            return count;
+        }
+};
+
+// Hashlife springt pro Schritt um generationsPerPass Generationen und schreibt das Ergebnis zurück.
+// Wie bei temporal-blocking beschreibt die Statistik nur die letzte Generation: mit Statistik wird bis
+// zur vorletzten gesprungen, diese exportiert und nach einer weiteren Generation verglichen. Ein Vergleich
+// über den ganzen Sprung hielte Oszillatoren, deren Periode den Sprung teilt, für stabil.
+class HashlifeEvolve : public EvolveEngine {
+    private:
+        EngineParams params;
+        Hashlife hashlife;
+        BitGrid* current;
+        BitGrid* next;
+
+    public:
+        explicit HashlifeEvolve(const EngineParams &p) : params(p), current(nullptr), next(nullptr) {
+            hashlife.setRule(params.rule);
+        }
+
+        const char* name() const override { return "hashlife"; }
+
+        int generationsPerStep() const override { return params.generationsPerPass > 0 ? params.generationsPerPass : 1; }
+
+        bool attach(BitGrid &currentGrid, BitGrid &nextGrid) override {
+            if (!Hashlife::supports(params.rule)) {
+                std::cerr << "Error: Hashlife does not support rules with birth on 0 neighbours ("
+                          << params.rule.toString() << ").\n";
+                return false;
+            }
+            if (!hashlife.importGrid(currentGrid)) {
+                std::cerr << "Error: Hashlife requires power-of-two grid dimensions.\n";
+                return false;
+            }
+            current = &currentGrid;
+            next = &nextGrid;
+            next->resize(current->getHeight(), current->getWidth());
+            return true;
+        }
+
+        int step(int maxGenerations, StepStats *stats) override {
+            int count = maxGenerations < generationsPerStep() ? maxGenerations : generationsPerStep();
+            if (count < 1) {
+                count = 1;
+            }
+            if (!stats) {
+                hashlife.advance(count);
+                hashlife.exportGrid(*next);
+            } else {
+                if (count > 1) {
+                    hashlife.advance(count - 1);
+                    hashlife.exportGrid(*current);  // der Zustand vor dem Sprung wird nicht mehr gebraucht
+                }
+                hashlife.advance(1);
+                hashlife.exportGrid(*next);
+                *stats = StepStats();
+                int words = current->getWordsPerRow();
+                for (int x = 0; x < current->getHeight(); ++x) {
+                    accumulateWords(current->row(x), next->row(x), words, static_cast<uint64_t>(x) * words, *stats);
+                }
+            }
+            current->swap(*next);
+            return count;
+        }
+};
+
+// Die Generationen bleiben auf dem Gerät; zurückgelesen wird nur bei sync().
+class OpenCLEvolve : public EvolveEngine {
+    private:
+        EngineParams params;
+        OpenCLEngine engine;
+        BitGrid* current;
+        bool hostCurrent;  // current enthält die Generation des Geräts
+
+    public:
+        explicit OpenCLEvolve(const EngineParams &p) : params(p), current(nullptr), hostCurrent(true) {
+            if (params.localX > 0 && params.localY > 0 && params.cellsPerItem > 0) {
+                engine.setTuning({params.localX, params.localY, params.cellsPerItem});
+            }
+            engine.setRule(params.rule);
+        }
+
+        const char* name() const override { return "opencl"; }
+
+        bool attach(BitGrid &currentGrid, BitGrid &) override {
+            current = &currentGrid;
+            hostCurrent = true;
+            // Programm und Puffer werden nur beim ersten Mal bzw. bei einer neuen Größe angelegt.
+            return engine.initialize(params.kernelPath, currentGrid.getHeight(), currentGrid.getWidth())
+                && engine.upload(currentGrid);
+        }
+
+        int step(int, StepStats *stats) override {
+            if (!engine.step()) {
+                return 0;
+            }
+            hostCurrent = false;
+            if (stats && !engine.readStats(*stats)) {
+                return 0;
+            }
+            return 1;
+        }
+
+        bool sync() override {
+            if (!hostCurrent && !engine.download(*current)) {
+                return false;
+            }
+            hostCurrent = true;
+            return true;
+        }
+
+        bool finish() override {
+            return engine.finish();
+        }
+};
+
+// Tabelle der Engines: Name, unterstützte Größen und Erzeugung.
+struct EngineEntry {
+    const char* name;
+    bool (*supports)(int height, int width);
+    EvolveEngine* (*create)(const EngineParams &params);
+};
+
+static bool anySize(int height, int width) {
+    return height > 0 && width > 0;
+}
+
+static const EngineEntry engineTable[] = {
+    { "scalar", anySize, [](const EngineParams &p) -> EvolveEngine* { return new ScalarEvolve(p); } },
+    { "bitwise", anySize, [](const EngineParams &p) -> EvolveEngine* { return new BitwiseEvolve(p); } },
+    { "in-place", anySize, [](const EngineParams &p) -> EvolveEngine* { return new InPlaceEvolve(p); } },
+    { "active-tiles", anySize, [](const EngineParams &p) -> EvolveEngine* { return new ActiveTilesEvolve(p); } },
+    { "temporal-blocking", anySize, [](const EngineParams &p) -> EvolveEngine* { return new TemporalBlockingEvolve(p); } },
+    { "lookup-table", anySize, [](const EngineParams &p) -> EvolveEngine* { return new LookupTableEvolve(p); } },
+    { "hashlife", Hashlife::supports, [](const EngineParams &p) -> EvolveEngine* { return new HashlifeEvolve(p); } },
+    { "opencl", anySize, [](const EngineParams &p) -> EvolveEngine* { return new OpenCLEvolve(p); } },
+};
+
+static const EngineEntry* findEngine(const std::string &name) {
+    for (const EngineEntry &entry : engineTable) {
+        if (name == entry.name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> EvolveEngine::names() {
+    std::vector<std::string> result;
+    for (const EngineEntry &entry : engineTable) {
+        result.push_back(entry.name);
+    }
+    return result;
+}
+
+bool EvolveEngine::exists(const std::string &name) {
+    return findEngine(name) != nullptr;
+}
+
+bool EvolveEngine::supports(const std::string &name, int height, int width) {
+    const EngineEntry* entry = findEngine(name);
+    return entry != nullptr && entry->supports(height, width);
+}
+
+bool EvolveEngine::supports(const std::string &name, const Rule &rule) {
+    return name != "hashlife" || Hashlife::supports(rule);
+}
+
+EvolveEngine* EvolveEngine::create(const std::string &name, const EngineParams &params) {
+    const EngineEntry* entry = findEngine(name);
+    if (entry == nullptr) {
+        std::cerr << "Error: unknown engine " << name << std::endl;
+        return nullptr;
+    }
+    return entry->create(params);
+}
@@ -0,0 +1,67 @@
+#ifndef EVOLVEENGINE_H
+#define EVOLVEENGINE_H
+
+#include <string>
+#include <vector>
+#include "BitGrid.h"
+#include "LifeKernels.h"
+
+// Einstellungen der Engines; jede Engine liest nur die Werte, die für sie eine Bedeutung haben.
+// Werte von 0 stehen für den Standard der jeweiligen Engine.
+struct EngineParams {
+    int threads;                       // CPU-Threads, 0 = alle Hardware-Threads
+    int tileRows, tileWords;           // Kachelgröße von active-tiles und temporal-blocking
+    int generationsPerPass;            // Generationen pro Schritt (temporal-blocking, hashlife)
+    int localX, localY, cellsPerItem;  // OpenCL-Tuning, 0 = Standard des Geräts
+    std::string kernelPath;            // OpenCL-Kernel
+    Rule rule;                         // Regel aller Engines, Standard Conway
+
+    EngineParams();
+    bool operator==(const EngineParams &other) const;
+    bool operator!=(const EngineParams &other) const { return !(*this == other); }
+    // Kurze Beschreibung der gesetzten Werte für Ausgaben, z.B. "threads=4 tile=64x8".
+    std::string describe(const std::string &engine) const;
+};
+
+// Gemeinsame Schnittstelle aller Berechnungsarten (Grid::run(), Benchmark, AutoTuner).
+// Eine Engine rechnet auf den beiden Generationspuffern des Aufrufers: CPU-Engines vertauschen sie
+// nach jedem Schritt, sodass current immer die neueste Generation enthält. Geräte-Engines halten
+// den Zustand zwischen den Schritten auf dem Gerät und schreiben current erst bei sync() zurück.
+// Neue Engines werden in der Tabelle in EvolveEngine.cpp eingetragen und sind dann über ihren
+// Namen in run(), im Benchmark und im AutoTuner verfügbar.
+class EvolveEngine {
+    public:
+        virtual ~EvolveEngine() {}
+
+        virtual const char* name() const = 0;
+
+        // Übernimmt current als Startzustand (Thread-Pool, Tabellen, Programm, Hochladen, ...).
+        // Muss nach jeder Änderung von current außerhalb der Engine erneut aufgerufen werden.
+        virtual bool attach(BitGrid &current, BitGrid &next) = 0;
+
+        // So viele Generationen rechnet step() höchstens auf einmal.
+        virtual int generationsPerStep() const { return 1; }
+
+        // Rechnet mindestens eine und höchstens maxGenerations Generationen und gibt deren Anzahl
+        // zurück (0 bei einem Fehler). Ist stats gesetzt, erhält es veränderte Zellen und Hash der
+        // letzten Generation; ohne stats entfällt das Zählen.
+        virtual int step(int maxGenerations, StepStats *stats) = 0;
+
+        // Stellt sicher, dass current die Generation der Engine enthält (z.B. Zurücklesen vom Gerät).
+        virtual bool sync() { return true; }
+
+        // Wartet, bis alle eingereihte Arbeit abgeschlossen ist (für Zeitmessungen).
+        virtual bool finish() { return true; }
+
+        // Namen aller Engines in der Reihenfolge der Tabelle.
+        static std::vector<std::string> names();
+        static bool exists(const std::string &name);
+        // false, wenn die Engine die Gittergröße grundsätzlich nicht unterstützt (Hashlife).
+        static bool supports(const std::string &name, int height, int width);
+        // false, wenn die Engine die Regel nicht rechnen kann (Hashlife bei Geburt mit 0 Nachbarn).
+        static bool supports(const std::string &name, const Rule &rule);
+        // Legt die Engine name an; nullptr und eine Fehlermeldung bei unbekanntem Namen.
+        static EvolveEngine* create(const std::string &name, const EngineParams &params);
+};
+
+#endif // EVOLVEENGINE_H
@@ -0,0 +1,299 @@
+#include "FrameExporter.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>  // _mkdir
+#define popen _popen
+#define pclose _pclose
+#else
+#include <csignal>
+#endif
+
+// Zählt die gesetzten Bits [begin, end) einer Zeile.
+static uint32_t countBits(const uint64_t* words, int begin, int end) {
+    int first = begin >> 6;
+    int last = (end - 1) >> 6;
+    uint64_t lowMask = ~0ULL << (begin & 63);
+    uint64_t highMask = ~0ULL >> (63 - ((end - 1) & 63));
+    if (first == last) {
+        return __builtin_popcountll(words[first] & lowMask & highMask);
+    }
+    uint32_t count = __builtin_popcountll(words[first] & lowMask) + __builtin_popcountll(words[last] & highMask);
+    for (int k = first + 1; k < last; ++k) {
+        count += __builtin_popcountll(words[k]);
+    }
+    return count;
+}
+
+// Farbverlauf für PPM: von fast schwarz (leer) über violett, rot und orange nach hellgelb (voll).
+static void densityColor(uint8_t density, uint8_t* rgb) {
+    static const uint8_t stops[5][3] = { {10, 10, 30}, {90, 20, 120}, {200, 50, 60}, {250, 160, 30}, {255, 255, 220} };
+    int scaled = density * 4;          // 0..1020
+    int segment = std::min(scaled / 255, 3);
+    int t = scaled - segment * 255;    // 0..255 innerhalb des Abschnitts
+    for (int c = 0; c < 3; ++c) {
+        rgb[c] = static_cast<uint8_t>(stops[segment][c] + (stops[segment + 1][c] - stops[segment][c]) * t / 255);
+    }
+}
+
+FrameExporter::FrameExporter(const std::string &path, const Options &exportOptions)
+    : target(path), options(exportOptions), stream(nullptr), pipe(false), open(false), busy(false), stopping(false),
+      written(0), dropped(0), failed(0), submitNanoseconds(0) {
+    options.poolSize = std::max(options.poolSize, 1);
+    options.maxSide = std::max(options.maxSide, 1);
+
+    if (target == "-") {
+        stream = stdout;
+    } else if (!target.empty() && target[0] == '|') {
+        // Programm, das die Bilder auf seiner Standardeingabe liest (z.B. ein Video-Encoder).
+#ifndef _WIN32
+        // Beendet sich das Programm vorzeitig, soll fwrite() einen Fehler liefern statt SIGPIPE auszulösen.
+        std::signal(SIGPIPE, SIG_IGN);
+#endif
+        stream = popen(target.c_str() + 1, "w");
+        pipe = true;
+        if (stream == nullptr) {
+            std::cerr << "Error starting frame export command " << target.substr(1) << std::endl;
+            return;
+        }
+    } else {
+        struct stat info;
+        if (stat(target.c_str(), &info) != 0) {
+#ifdef _WIN32
+            int result = _mkdir(target.c_str());
+#else
+            int result = mkdir(target.c_str(), 0755);
+#endif
+            if (result != 0) {
+                std::cerr << "Error creating frame export directory " << target << std::endl;
+                return;
+            }
+        } else if (!S_ISDIR(info.st_mode)) {
+            std::cerr << "Error: frame export target " << target << " is not a directory" << std::endl;
+            return;
+        }
+    }
+
+    pool.resize(options.poolSize);
+    for (int i = options.poolSize - 1; i >= 0; --i) {
+        freeSlots.push_back(i);
+    }
+    open = true;
+    writer = std::thread(&FrameExporter::writerLoop, this);
+}
+
+FrameExporter::~FrameExporter() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+    if (pipe && stream != nullptr) {
+        pclose(stream);  // wartet, bis das Programm die Eingabe verarbeitet hat
+    } else if (stream != nullptr) {
+        std::fflush(stream);
+    }
+}
+
+bool FrameExporter::parseFormat(const std::string &name, Format &format) {
+    if (name == "pgm") {
+        format = Format::PGM;
+    } else if (name == "ppm") {
+        format = Format::PPM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool FrameExporter::parsePolicy(const std::string &name, Policy &policy) {
+    if (name == "drop") {
+        policy = Policy::Drop;
+    } else if (name == "block") {
+        policy = Policy::Block;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool FrameExporter::submit(const BitGrid &grid, long long generation) {
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!open) {
+        return false;
+    }
+
+    // Freien Platz nehmen; ohne freien Platz auslassen oder begrenzt warten.
+    bool available = !freeSlots.empty();
+    if (!available && options.policy == Policy::Block) {
+        available = freed.wait_for(lock, std::chrono::milliseconds(options.blockTimeoutMs),
+                                   [this] { return !freeSlots.empty(); });
+    }
+    if (!available) {
+        ++dropped;
+        submitNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        return false;
+    }
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+    lock.unlock();
+
+    // Die Kopie geschieht ohne Sperre; der Hintergrund-Thread greift nur auf eingereihte Plätze zu.
+    pool[slot].grid = grid;
+    pool[slot].generation = generation;
+
+    lock.lock();
+    queued.push_back(slot);
+    submitNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    lock.unlock();
+    wake.notify_one();
+    return true;
+}
+
+void FrameExporter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    freed.wait(lock, [this] { return queued.empty() && !busy; });
+}
+
+long long FrameExporter::writtenCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+long long FrameExporter::droppedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return dropped;
+}
+
+long long FrameExporter::simulationNanoseconds() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return submitNanoseconds;
+}
+
+void FrameExporter::writerLoop() {
+    ThreadPool workers(options.threads);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return !queued.empty() || stopping; });
+        if (queued.empty()) {
+            return;  // beendet und nichts mehr zu schreiben
+        }
+        int slot = queued.front();
+        queued.pop_front();
+        busy = true;
+
+        lock.unlock();
+        bool ok = writeFrame(pool[slot], workers);
+        lock.lock();
+
+        busy = false;
+        freeSlots.push_back(slot);
+        if (ok) {
+            ++written;
+        } else {
+            ++failed;
+        }
+        freed.notify_all();
+    }
+}
+
+void FrameExporter::downscale(const BitGrid &grid, int outHeight, int outWidth, ThreadPool &workers) {
+    int h = grid.getHeight();
+    int w = grid.getWidth();
+    density.resize(static_cast<size_t>(outHeight) * outWidth);
+
+    // Spaltengrenzen der Bildpunkte; Block (i, j) umfasst Zeilen [i*h/H, (i+1)*h/H) und entsprechend Spalten.
+    std::vector<int> colStart(outWidth + 1);
+    for (int j = 0; j <= outWidth; ++j) {
+        colStart[j] = static_cast<int>(static_cast<long long>(j) * w / outWidth);
+    }
+
+    workers.run([&](int index) {
+        std::pair<int, int> rows = ThreadPool::band(outHeight, workers.size(), index);
+        std::vector<uint32_t> counts(outWidth);
+        for (int i = rows.first; i < rows.second; ++i) {
+            int first = static_cast<int>(static_cast<long long>(i) * h / outHeight);
+            int last = static_cast<int>(static_cast<long long>(i + 1) * h / outHeight);
+            std::fill(counts.begin(), counts.end(), 0);
+            for (int x = first; x < last; ++x) {
+                const uint64_t* row = grid.row(x);
+                for (int j = 0; j < outWidth; ++j) {
+                    counts[j] += countBits(row, colStart[j], colStart[j + 1]);
+                }
+            }
+            uint8_t* out = &density[static_cast<size_t>(i) * outWidth];
+            for (int j = 0; j < outWidth; ++j) {
+                uint64_t cells = static_cast<uint64_t>(last - first) * (colStart[j + 1] - colStart[j]);
+                out[j] = static_cast<uint8_t>((counts[j] * 255ULL + cells / 2) / cells);
+            }
+        }
+    });
+}
+
+bool FrameExporter::writeFrame(const Slot &slot, ThreadPool &workers) {
+    const BitGrid &grid = slot.grid;
+    int h = grid.getHeight();
+    int w = grid.getWidth();
+    if (h <= 0 || w <= 0) {
+        return false;
+    }
+
+    // Zielgröße: vorgegeben (höchstens Gittergröße) oder die längere Seite auf maxSide begrenzt.
+    int outHeight = options.height, outWidth = options.width;
+    if (outHeight <= 0 || outWidth <= 0) {
+        double factor = std::min(1.0, static_cast<double>(options.maxSide) / std::max(h, w));
+        outHeight = std::max(1, static_cast<int>(h * factor));
+        outWidth = std::max(1, static_cast<int>(w * factor));
+    }
+    outHeight = std::min(outHeight, h);
+    outWidth = std::min(outWidth, w);
+    downscale(grid, outHeight, outWidth, workers);
+
+    bool color = options.format == Format::PPM;
+    char header[64];
+    int headerLength = std::snprintf(header, sizeof(header), "%s\n%d %d\n255\n", color ? "P6" : "P5", outWidth, outHeight);
+    size_t pixels = static_cast<size_t>(outHeight) * outWidth;
+    image.resize(headerLength + pixels * (color ? 3 : 1));
+    std::copy(header, header + headerLength, image.begin());
+    if (color) {
+        for (size_t p = 0; p < pixels; ++p) {
+            densityColor(density[p], &image[headerLength + 3 * p]);
+        }
+    } else {
+        std::copy(density.begin(), density.end(), image.begin() + headerLength);
+    }
+
+    if (stream != nullptr) {
+        // Ein Bild nach dem anderen in denselben Strom, wie es image2pipe-Leser erwarten.
+        bool ok = std::fwrite(image.data(), 1, image.size(), stream) == image.size() && std::fflush(stream) == 0;
+        if (!ok) {
+            std::cerr << "Error writing frame " << slot.generation << " to " << target << std::endl;
+        }
+        return ok;
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "/frame_%08lld.%s", slot.generation, color ? "ppm" : "pgm");
+    std::string path = target + name;
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Error writing frame " << path << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(image.data(), 1, image.size(), file) == image.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error writing frame " << path << std::endl;
+    }
+    return ok;
+}
@@ -0,0 +1,95 @@
+#ifndef FRAMEEXPORTER_H
+#define FRAMEEXPORTER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include "BitGrid.h"
+
+class ThreadPool;
+
+// Schreibt Generationen als binäre PGM- (Graustufen) oder PPM-Bilder (Farbverlauf) in einem
+// Hintergrund-Thread: in ein Verzeichnis (frame_<Generation>.pgm), nach stdout ("-") oder in die
+// Standardeingabe eines Programms ("|ffmpeg -f image2pipe -i - out.mp4"). Jedes Bild wird dabei
+// auf die Zielgröße verkleinert; ein Bildpunkt ist der Anteil lebender Zellen seines Blocks.
+// Das Verkleinern verteilt der Hintergrund-Thread auf einen eigenen Thread-Pool.
+//
+// Die Simulation kopiert eine Generation nur in einen freien Platz eines festen Vorrats
+// (Options::poolSize), der Speicher bleibt also begrenzt. Ist kein Platz frei, weil das Schreiben
+// nicht nachkommt, wird das Bild je nach Policy ausgelassen oder höchstens blockTimeoutMs
+// gewartet (und danach ausgelassen); die Simulation steht nie unbegrenzt.
+class FrameExporter {
+    public:
+        enum class Format { PGM, PPM };
+        enum class Policy { Drop, Block };
+
+        struct Options {
+            Format format = Format::PGM;
+            int width = 0, height = 0;   // Bildgröße; 0 = Gittergröße, höchstens maxSide an der längeren Seite
+            int maxSide = 1024;
+            Policy policy = Policy::Drop;
+            int poolSize = 4;            // Schnappschüsse im Umlauf (mindestens 1)
+            int blockTimeoutMs = 1000;   // längste Wartezeit von submit() bei Policy::Block
+            int threads = 0;             // Threads fürs Verkleinern, 0 = alle Hardware-Threads
+        };
+
+    private:
+        struct Slot {
+            BitGrid grid;
+            long long generation;
+        };
+
+        std::string target;
+        Options options;
+        std::FILE* stream;   // stdout oder Pipe; nullptr beim Schreiben in ein Verzeichnis
+        bool pipe;           // stream stammt von popen()
+        bool open;
+        std::vector<Slot> pool;
+        std::vector<int> freeSlots;
+        std::deque<int> queued;  // zu schreibende Plätze in Reihenfolge der Generationen
+        bool busy;               // der Hintergrund-Thread schreibt gerade
+        bool stopping;
+        std::mutex mutex;
+        std::condition_variable wake;   // weckt den Hintergrund-Thread
+        std::condition_variable freed;  // meldet einen freien Platz bzw. einen leeren Puffer
+
+        long long written, dropped, failed;
+        long long submitNanoseconds;  // Zeit, die die Simulation in submit() verbracht hat
+
+        // Nur vom Hintergrund-Thread benutzt.
+        std::vector<uint8_t> density;  // Anteil lebender Zellen pro Bildpunkt, 0..255
+        std::vector<uint8_t> image;    // fertiges Bild samt Kopf
+        std::thread writer;
+
+        void writerLoop();
+        void downscale(const BitGrid &grid, int outHeight, int outWidth, ThreadPool &workers);
+        bool writeFrame(const Slot &slot, ThreadPool &workers);
+
+    public:
+        FrameExporter(const std::string &target, const Options &options);
+        ~FrameExporter();  // schreibt noch wartende Bilder und beendet den Thread
+
+        static bool parseFormat(const std::string &name, Format &format);
+        static bool parsePolicy(const std::string &name, Policy &policy);
+
+        // false, wenn das Ziel nicht geöffnet werden konnte.
+        bool isOpen() const { return open; }
+        // Die Bilder gehen nach stdout; andere Ausgaben gehören dann nach stderr.
+        bool writesToStdout() const { return target == "-"; }
+
+        // Übergibt eine Generation; false, wenn das Bild ausgelassen wurde.
+        bool submit(const BitGrid &grid, long long generation);
+        // Wartet, bis alle übergebenen Bilder geschrieben sind.
+        void flush();
+
+        long long writtenCount();
+        long long droppedCount();
+        long long simulationNanoseconds();
+};
+
+#endif // FRAMEEXPORTER_H
@@ -1,4 +1,16 @@
 #include "Grid.h"
+#include "LifeKernels.h"
+#include "ThreadPool.h"
+#include "Hashlife.h"
+#include "SparseUniverse.h"
+#include "EvolveEngine.h"
+#include "AutoTuner.h"
+#include "WorldFile.h"
+#include "PatternIO.h"
+#include "Checkpointer.h"
+#include "CycleDetector.h"
+#include "Profiling.h"
+#include "Presenter.h"
 #include <iostream>
 #include <fstream>
 #include <thread>
@@ -6,8 +18,6 @@
 #include <string.h>
 #include <random>
 #include <ctime>
-#include "opencl.hpp"
-#include "utilities.hpp"
 
 // Der folgende Abschnitt inkludiert systemabhängige Header-Dateien,
 // um Plattformunterschiede zwischen Windows und Unix-basierten Systemen auszugleichen.
@@ -21,18 +31,33 @@
 const std::string kernel_path = "/home/users8/acgl/s4948503/Documents/abschluss3/game_of_life.cl";
 
 // Konstruktor ohne Parameter: Initialisiert ein leeres Grid-Objekt mit Höhe und Breite auf 0,
-// und aktiviert die Druckfunktion standardmäßig.
-Grid::Grid() : height(0), width(0), printEnabled(true) {}
+// und aktiviert die Druckfunktion standardmäßig. Die CPU-Version nutzt standardmäßig alle Hardware-Threads.
+Grid::Grid() : height(0), width(0), printEnabled(true), framesPerSecond(30), engineName("bitwise"), generation(0),
+      checkpointInterval(0), exportStride(0), resumed(false), cycleDetectionPeriod(16) {
+    engineParams.kernelPath = kernel_path;
+}
 
 // Konstruktor mit Parametern: Initialisiert ein Grid mit gegebener Höhe (h) und Breite (w).
-// Die aktuellen und nächsten Generationen werden als zweidimensionale Vektoren von booleschen Werten initialisiert.
+// Die aktuelle Generation wird als bitgepacktes Spielfeld (BitGrid) initialisiert, die nächste erst bei Bedarf.
 // Der printEnabled-Status wird auf true gesetzt.
 Grid::Grid(int h, int w) 
     : height(h), 
       width(w), 
-      currentGeneration(h, std::vector<bool>(w, false)),  // Initialisiere currentGeneration mit "false" (alle Zellen tot)
-      nextGeneration(h, std::vector<bool>(w, false)),    // Initialisiere nextGeneration ebenfalls mit "false"
-      printEnabled(true) {}
+      currentGeneration(h, w),  // Initialisiere currentGeneration mit "false" (alle Zellen tot)
+      nextGeneration(),         // nextGeneration legt erst die Engine an, die sie braucht (nicht "in-place")
+      printEnabled(true),
+      framesPerSecond(30),
+      engineName("bitwise"),
+      generation(0),
+      checkpointInterval(0),
+      exportStride(0),
+      resumed(false),
+      cycleDetectionPeriod(16) {
+    engineParams.kernelPath = kernel_path;  // Pfad zur OpenCL-Kernel-Datei
+}
+
+// Der Destruktor muss hier stehen, da OpenCLEngine im Header nur vorwärts deklariert ist.
+Grid::~Grid() = default;
 
 // Konvertiert einen eindimensionalen Index in ein zweidimensionales (x, y) Paar.
 // Dies ist nützlich, wenn die Zellen in einem eindimensionalen Array gespeichert werden.
@@ -43,7 +68,19 @@ std::pair<int, int> Grid::to2D(int p) const {
 
 // Lädt ein Zellenmuster aus einer Datei, um das Gitter (Grid) zu initialisieren.
 // Die Datei muss die Höhe, Breite und das Startmuster der Zellen enthalten.
+// Dateien im binären Weltformat werden an ihrer Kennung erkannt und eingeblendet,
+// RLE- und Plaintext-Muster (*.rle, *.cells) an ihrer Endung.
 void Grid::initializePattern(const std::string &filename) {
+    if (WorldFile::isWorldFile(filename)) {
+        loadBinary(filename);
+        return;
+    }
+    if (PatternIO::formatFromFilename(filename) != PatternIO::Format::Unknown) {
+        setSize(0, 0);  // die Größe ergibt sich aus dem Muster
+        importPattern(filename);
+        return;
+    }
+
     std::ifstream file(filename);  // Öffne die Datei zum Lesen
     if (!file.is_open()) {  // Überprüfen, ob die Datei erfolgreich geöffnet wurde
         // Fehlerbehandlung, falls die Datei nicht geöffnet werden konnte
@@ -55,63 +92,237 @@ void Grid::initializePattern(const std::string &filename) {
 
     // Lese die Höhe und Breite des Gitters aus der Datei
     file >> height >> width;
+    generation = 0;  // das Textformat enthält keine Generation
 
-    // Passe die Größe der currentGeneration und nextGeneration Vektoren entsprechend der neuen Höhe und Breite an
-    currentGeneration.resize(height, std::vector<bool>(width, false));
-    nextGeneration.resize(height, std::vector<bool>(width, false));
+    // Passe die Größe von currentGeneration an; nextGeneration wird von der Engine bei Bedarf angelegt
+    currentGeneration.resize(height, width);
+    nextGeneration.resize(0, 0);
 
     // Lese die Zellzustände aus der Datei und setze die entsprechenden Zellen in currentGeneration
     for (int i = 0; i < height; ++i) {  // Schleife über alle Zeilen
         for (int j = 0; j < width; ++j) {  // Schleife über alle Spalten
             int cell;
             file >> cell;  // Lese den Zellzustand (0 oder 1)
-            currentGeneration[i][j] = (cell == 1);  // Setze den Zustand in currentGeneration (true für lebend, false für tot)
+            currentGeneration.set(i, j, cell == 1);  // Setze den Zustand in currentGeneration (true für lebend, false für tot)
         }
     }
 
     file.close();  // Schließe die Datei, da sie nicht mehr benötigt wird
 }
 
-// Gibt das aktuelle Gitter auf der Konsole aus.
-// Lebende Zellen werden als 'O' und tote Zellen als '.' dargestellt.
-void Grid::print() const {
-    for (int i = 0; i < height; ++i) {  // Schleife über alle Zeilen
-        for (int j = 0; j < width; ++j) {  // Schleife über alle Spalten
-            // Ausgabe des aktuellen Zellzustands: 'O' für lebend, '.' für tot
-            std::cout << (currentGeneration[i][j] ? 'O' : '.');
-        }
-        std::cout << std::endl;  // Zeilenumbruch nach jeder Zeile
-    }
+// Gibt das aktuelle Gitter auf der Konsole aus (siehe TerminalRenderer).
+// Lebende Zellen werden als 'O' und tote Zellen als '.' dargestellt; größere Gitter werden verkleinert,
+// und im Terminal werden nach dem ersten Bild nur die veränderten Stellen neu geschrieben.
+void Grid::print(long long generationNumber) {
+    renderer.render(currentGeneration, generationNumber);
 }
 
 // Führt das Spiel über eine bestimmte Anzahl von Generationen aus und misst die dafür benötigte Zeit.
-// Zwischen den Generationen wird eine Verzögerung eingeführt, und das Ergebnis kann gedruckt werden.
-long long Grid::run(int generations, int delay_ms) {
+// Die Ausgabe läuft in einem eigenen Thread (siehe Presenter) und bremst die Simulation nicht;
+// delay_ms > 0 begrenzt die Simulation auf höchstens eine Generation pro delay_ms Millisekunden.
+long long Grid::run(int generations, int delay_ms, const std::string &engineChoice) {
+    // Die Engine wird über ihren Namen gewählt; "auto" nimmt die schnellste gemessene Engine.
+    // Das Abstimmen zählt nicht zur Laufzeit, es findet pro Maschine und Größe nur einmal statt.
+    EvolveEngine* evolver = acquireEngine(engineChoice.empty() ? engineName : engineChoice);
+    if (evolver == nullptr) {
+        return 0;
+    }
+
     // Erfasse den Startzeitpunkt der Berechnung
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    // Füge einige Muster zum Testen in das Gitter ein
-    addGlider(25, 25);        // Füge einen Glider an Position (25, 25) hinzu
-    addToad(100, 100);        // Füge ein Toad an Position (100, 100) hinzu
-    addBeacon(125, 125);      // Füge ein Beacon an Position (125, 125) hinzu
-    addRPentomino(150, 150);  // Füge ein R-Pentomino an Position (150, 150) hinzu
+    // Füge einige Muster zum Testen in das Gitter ein (nicht nach dem Fortsetzen einer Sicherung)
+    seedTestPatterns();
+
+    // attach() übernimmt den aktuellen Zustand (Thread-Pool, Kacheln, Hochladen auf das Gerät, ...).
+    if (!evolver->attach(currentGeneration, nextGeneration)) {
+        return 0;
+    }
+
+    // Engines mit mehreren Generationen pro Schritt (zeitliche Blockung, Hashlife) geben aus und
+    // prüfen die Stabilität nur an den Grenzen ihrer Schritte.
+    int block = evolver->generationsPerStep();
+
+    // Sicherungspunkte werden im Hintergrund geschrieben, die Simulation kopiert nur den Schnappschuss.
+    std::unique_ptr<Checkpointer> checkpointer;
+    if (checkpointInterval > 0) {
+        checkpointer.reset(new Checkpointer(checkpointPath, engineParams.rule));
+    }
+
+    // Periodische Endzustände werden an den Hashes erkannt, die jeder Schritt nebenbei liefert.
+    CycleDetector cycles(cycleDetectionPeriod);
+
+    // Bilder für Visualisierungen werden wie Sicherungen im Hintergrund verkleinert und geschrieben.
+    std::unique_ptr<FrameExporter> exporter;
+    if (exportStride > 0) {
+        exporter.reset(new FrameExporter(exportTarget, exportOptions));
+        if (!exporter->isOpen()) {
+            exporter.reset();
+        } else if (generation % exportStride == 0) {
+            exporter->submit(currentGeneration, generation);
+        }
+    }
+    // Gehen die Bilder nach stdout, gehören Meldungen nach stderr und die Ausgabe des Gitters entfällt.
+    bool framesOnStdout = exporter && exporter->writesToStdout();
+    std::ostream &report = framesOnStdout ? std::cerr : std::cout;
+
+    // Die Simulation übergibt fertige Generationen ohne Sperre an den Ausgabe-Thread, der sie mit
+    // fester Bildrate zeigt. Kopiert wird nur, wenn die vorige Generation schon abgeholt wurde.
+    std::unique_ptr<Presenter> presenter;
+    if (printEnabled && !framesOnStdout) {
+        frames.reset(height, width);
+        frames.publish(currentGeneration, generation);
+        presenter.reset(new Presenter(renderer, frames, framesPerSecond));
+        presenter->start();
+    }
+    std::string outcome;  // Meldung über Stabilität oder Periode, erst nach dem letzten Bild ausgeben
+    std::chrono::nanoseconds throttled(0);  // Wartezeit der Drosselung, zählt nicht zur Laufzeit
+    std::chrono::nanoseconds checkpointSync(0);  // Zurücklesen für Sicherungen (Geräte-Engines)
+    auto pace = std::chrono::steady_clock::now();
 
     // Führe die Simulation für die angegebene Anzahl von Generationen durch
-    for (int step = 0; step < generations; ++step) {
-        if (printEnabled) {  // Überprüfen, ob das Drucken aktiviert ist
-            clearScreen();  // Bildschirm löschen (für bessere Lesbarkeit)
-            std::cout << "Generation " << step + 1 << ":\n";
-            print();  // Das aktuelle Gitter ausgeben
+    for (int step = 0; step < generations; ) {
+        int count = generations - step < block ? generations - step : block;  // Generationen in diesem Schritt
+
+        // Jede Engine zählt die veränderten Zellen und bildet den Hash im selben Durchlauf,
+        // ein zusätzlicher Vergleich der beiden Generationen entfällt.
+        StepStats stats;
+        int advanced;
+        {
+            GOL_PROFILE_COUNTERS("step");
+            advanced = evolver->step(count, &stats);
+        }
+        if (advanced == 0) {
+            break;
+        }
+        step += advanced;
+        generation += advanced;
+
+        if (presenter && frames.wanted()) {  // Die Ausgabe hat das vorige Bild abgeholt
+            GOL_PROFILE_SCOPE("publish");
+            if (!evolver->sync()) {  // Geräte-Engines lesen die Generation erst jetzt zurück
+                break;
+            }
+            frames.publish(currentGeneration, generation);
+        }
+
+        if (checkpointDue(checkpointer.get(), advanced)) {
+            GOL_PROFILE_SCOPE("checkpoint");
+            // Das Zurücklesen vom Gerät kostet die Simulation ebenso Zeit wie die Kopie in submit().
+            auto before = std::chrono::steady_clock::now();
+            bool synced = evolver->sync();
+            checkpointSync += std::chrono::steady_clock::now() - before;
+            if (synced) {
+                checkpointer->submit(currentGeneration, generation);
+            }
         }
-        evolve_cpu();  // Führe die Evolution der Zellen auf der CPU durch
 
-        if (is_stable()) {  // Überprüfen, ob ein stabiler Zustand erreicht ist
-            std::cout << "\nStable configuration detected at generation " << step + 1 << ".\n";
+        if (exportDue(exporter.get(), advanced)) {
+            GOL_PROFILE_SCOPE("export");
+            if (evolver->sync()) {
+                exporter->submit(currentGeneration, generation);
+            }
+        }
+
+        if (stats.changed == 0) {  // Überprüfen, ob ein stabiler Zustand erreicht ist
+            outcome = "\nStable configuration detected at generation " + std::to_string(step) + ".\n";
             break;  // Beende die Schleife vorzeitig, wenn das Gitter stabil ist
         }
+        if (cycleDetectionPeriod > 0) {
+            int period = cycles.record(stats.hash, generation);
+            if (period > 0) {  // Überprüfen, ob sich ein früherer Zustand wiederholt
+                // Bei mehreren Generationen pro Schritt wird nur jede block-te Generation verglichen.
+                outcome = "\nPeriodic configuration (period " + std::string(block > 1 ? "dividing " : "")
+                        + std::to_string(period) + ") detected at generation " + std::to_string(step) + ".\n";
+                break;
+            }
+        }
+
+        // Optionale Drosselung: höchstens eine Generation pro delay_ms, gemessen ab dem vorigen Schritt.
+        if (delay_ms > 0) {
+            GOL_PROFILE_SCOPE("throttle");
+            pace += std::chrono::milliseconds(delay_ms) * advanced;
+            auto before = std::chrono::steady_clock::now();
+            if (pace > before) {
+                std::this_thread::sleep_until(pace);
+                throttled += std::chrono::steady_clock::now() - before;
+            } else {
+                pace = before;  // hinterher: nicht nachholen
+            }
+        }
+    }
+    evolver->sync();  // Endzustand für weitere Läufe auf dem Host
+
+    // Erfasse den Endzeitpunkt der Berechnung (das letzte Bild zählt nicht mehr dazu)
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    if (presenter) {
+        frames.publish(currentGeneration, generation);  // das letzte Bild zeigt immer den Endzustand
+        presenter->stop();
+        renderer.end();  // Terminal wiederherstellen, Meldungen erscheinen unter dem letzten Bild
+    }
+    report << outcome;
+
+    // Berechne die verstrichene Zeit in Millisekunden, ohne die Wartezeit der Drosselung
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time - throttled);
+
+    // Ausgabe der Gesamtzeit für die Berechnung der Generationen
+    report << "\nTotal calculation time for " << generations << " generations (" << evolver->name() << ", "
+              << engineBuiltParams.describe(engineBuiltName) << "): " << duration.count() << " ms\n";
+    evolver->finish();  // übrige Ereignisse für das Profil einsammeln
+    reportCheckpoints(checkpointer.get(), checkpointSync.count(), duration.count(), report);
+    reportExports(exporter.get(), duration.count(), report);
+    GOL_PROFILE_REPORT(evolver->name());
+
+    // Rückgabe der berechneten Dauer
+    return duration.count();
+}
+
+long long Grid::run_with_opencl(int generations, int delay_ms) {
+    // Diese Funktion führt das Spiel mit der OpenCL-Engine aus; die Generationen bleiben dabei auf dem
+    // Gerät und werden nur für Ausgabe, Sicherungen und am Ende zurückgelesen.
+    return run(generations, delay_ms, "opencl");
+}
+
+long long Grid::run_with_hashlife(long long generations) {
+    // Diese Funktion rechnet mit Hashlife in Sprüngen von Zweierpotenzen weiter, statt jede Generation
+    // einzeln zu berechnen. Höhe und Breite müssen Zweierpotenzen sein; ausgegeben wird nur das Endergebnis.
 
-        // Füge eine Verzögerung zwischen den Generationen ein, um die Ausgabe zu verlangsamen
-        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+    // Erfasse den Startzeitpunkt der Berechnung
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    if (!Hashlife::supports(height, width)) {
+        std::cerr << "Error: Hashlife requires power-of-two grid dimensions.\n";
+        return 0;
+    }
+    if (!Hashlife::supports(engineParams.rule)) {
+        std::cerr << "Error: Hashlife does not support rules with birth on 0 neighbours.\n";
+        return 0;
+    }
+
+    // Füge einige Muster zum Testen in das Gitter ein (nicht nach dem Fortsetzen einer Sicherung)
+    seedTestPatterns();
+
+    // Gitter in den Quadtree übernehmen, vorspringen und das Ergebnis zurückschreiben.
+    Hashlife hashlife;
+    hashlife.setRule(engineParams.rule);
+    {
+        GOL_PROFILE_SCOPE("hashlife.import");
+        hashlife.importGrid(currentGeneration);
+    }
+    {
+        GOL_PROFILE_COUNTERS("hashlife.advance");
+        hashlife.advance(generations);
+    }
+    {
+        GOL_PROFILE_SCOPE("hashlife.export");
+        hashlife.exportGrid(currentGeneration);
+    }
+    generation += generations;
+
+    if (printEnabled) {  // Überprüfen, ob das Drucken aktiviert ist
+        print(generations);  // Das Endergebnis ausgeben
+        renderer.end();
     }
 
     // Erfasse den Endzeitpunkt der Berechnung
@@ -120,42 +331,52 @@ long long Grid::run(int generations, int delay_ms) {
     // Berechne die verstrichene Zeit in Millisekunden
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-    // Ausgabe der Gesamtzeit für die Berechnung der Generationen
-    std::cout << "\nTotal calculation time (scalar) for " << generations << " generations: " << duration.count() << " ms\n";
+    // Ausgabe der Gesamtzeit für die Berechnung der Generationen mit Hashlife
+    std::cout << "\nTotal calculation time for " << generations << " generations (Hashlife, "
+              << hashlife.nodeCount() << " nodes): " << duration.count() << " ms\n";
+    GOL_PROFILE_REPORT("run_with_hashlife");
 
     // Rückgabe der berechneten Dauer
     return duration.count();
 }
 
-long long Grid::run_with_opencl(int generations, int delay_ms) {
-    // Diese Funktion führt das Spiel über eine bestimmte Anzahl von Generationen aus, nutzt dabei aber OpenCL zur Parallelisierung.
-    // Die benötigte Zeit für die Ausführung wird gemessen und zurückgegeben.
+long long Grid::run_unbounded(long long generations) {
+    // Diese Funktion rechnet auf der unbegrenzten Ebene statt auf dem Torus: das Gitter wird als Ausschnitt
+    // mit der linken oberen Ecke bei (0, 0) übernommen, Muster können es also verlassen, ohne zurückzukehren.
+    // Gespeichert und berechnet werden nur Chunks mit lebenden Zellen (siehe SparseUniverse.h); am Ende
+    // wird derselbe Ausschnitt zurückgeschrieben.
 
     // Erfasse den Startzeitpunkt der Berechnung
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    // Füge einige Muster zum Testen in das Gitter ein
-    addGlider(25, 25);        // Füge einen Glider an Position (25, 25) hinzu
-    addToad(100, 100);        // Füge ein Toad an Position (100, 100) hinzu
-    addBeacon(125, 125);      // Füge ein Beacon an Position (125, 125) hinzu
-    addRPentomino(150, 150);  // Füge ein R-Pentomino an Position (150, 150) hinzu
+    if (!SparseUniverse::supports(engineParams.rule)) {
+        std::cerr << "Error: the unbounded plane does not support rules with birth on 0 neighbours.\n";
+        return 0;
+    }
 
-    // Führe die Simulation für die angegebene Anzahl von Generationen durch
-    for (int step = 0; step < generations; ++step) {
-        if (printEnabled) {  // Überprüfen, ob das Drucken aktiviert ist
-            clearScreen();  // Bildschirm löschen (für bessere Lesbarkeit)
-            std::cout << "Generation " << step + 1 << ":\n";
-            print();  // Das aktuelle Gitter ausgeben
-        }
-        evolve();  // Führe die Evolution der Zellen mit OpenCL durch
+    // Füge einige Muster zum Testen in das Gitter ein (nicht nach dem Fortsetzen einer Sicherung)
+    seedTestPatterns();
 
-        if (is_stable()) {  // Überprüfen, ob ein stabiler Zustand erreicht ist
-            std::cout << "\nStable configuration detected at generation " << step + 1 << ".\n";
-            break;  // Beende die Schleife vorzeitig, wenn das Gitter stabil ist
-        }
+    SparseUniverse universe;
+    universe.setRule(engineParams.rule);
+    {
+        GOL_PROFILE_SCOPE("unbounded.import");
+        universe.importGrid(currentGeneration);
+    }
+    {
+        ThreadPool pool(engineParams.threads);
+        GOL_PROFILE_COUNTERS("unbounded.advance");
+        universe.advance(generations, &pool);
+    }
+    {
+        GOL_PROFILE_SCOPE("unbounded.export");
+        universe.exportGrid(currentGeneration);
+    }
+    generation += generations;
 
-        // Füge eine Verzögerung zwischen den Generationen ein, um die Ausgabe zu verlangsamen
-        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+    if (printEnabled) {  // Überprüfen, ob das Drucken aktiviert ist
+        print(generations);  // Den Ausschnitt des Endergebnisses ausgeben
+        renderer.end();
     }
 
     // Erfasse den Endzeitpunkt der Berechnung
@@ -164,8 +385,18 @@ long long Grid::run_with_opencl(int generations, int delay_ms) {
     // Berechne die verstrichene Zeit in Millisekunden
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-    // Ausgabe der Gesamtzeit für die Berechnung der Generationen mit OpenCL
-    std::cout << "\nTotal calculation time for " << generations << " generations (OpenCL): " << duration.count() << " ms\n";
+    // Ausgabe der Gesamtzeit sowie der Ausdehnung und des Speicherbedarfs des belebten Bereichs
+    std::cout << "\nTotal calculation time for " << generations << " generations (unbounded, "
+              << universe.chunkCount() << " chunks, " << universe.memoryBytes() / 1024 << " KiB): "
+              << duration.count() << " ms\n";
+    long long top, left, bottom, right;
+    if (universe.boundingBox(top, left, bottom, right)) {
+        std::cout << "Population " << universe.population() << " in rows " << top << ".." << bottom
+                  << ", columns " << left << ".." << right << "\n";
+    } else {
+        std::cout << "Population 0\n";
+    }
+    GOL_PROFILE_REPORT("run_unbounded");
 
     // Rückgabe der berechneten Dauer
     return duration.count();
@@ -173,6 +404,15 @@ long long Grid::run_with_opencl(int generations, int delay_ms) {
 
 bool Grid::load(const std::string &filename) {
     // Diese Funktion lädt den Zustand des Gitters aus einer Datei und setzt die Höhe und Breite des Gitters entsprechend.
+    // Das binäre Weltformat wird an seiner Kennung erkannt, ansonsten wird das Textformat gelesen.
+    if (WorldFile::isWorldFile(filename)) {
+        return loadBinary(filename);
+    }
+    if (PatternIO::formatFromFilename(filename) != PatternIO::Format::Unknown) {
+        setSize(0, 0);  // die Größe ergibt sich aus dem Muster
+        return importPattern(filename);
+    }
+
     std::ifstream file(filename);  // Öffne die Datei zum Lesen
     if (!file.is_open()) {  // Überprüfen, ob die Datei erfolgreich geöffnet wurde
         std::cerr << "Error opening file!" << std::endl;
@@ -181,17 +421,18 @@ bool Grid::load(const std::string &filename) {
 
     // Lese die Höhe und Breite des Gitters aus der Datei
     file >> height >> width;
+    generation = 0;  // das Textformat enthält keine Generation
 
-    // Passe die Größe der currentGeneration und nextGeneration Vektoren entsprechend der neuen Höhe und Breite an
-    currentGeneration.resize(height, std::vector<bool>(width, false));
-    nextGeneration.resize(height, std::vector<bool>(width, false));
+    // Passe die Größe von currentGeneration an; nextGeneration wird von der Engine bei Bedarf angelegt
+    currentGeneration.resize(height, width);
+    nextGeneration.resize(0, 0);
 
     // Lese die Zellzustände aus der Datei und setze die entsprechenden Zellen in currentGeneration
     for (int i = 0; i < height; ++i) {  // Schleife über alle Zeilen
         for (int j = 0; j < width; ++j) {  // Schleife über alle Spalten
             int cell;
             file >> cell;  // Lese den Zellzustand (0 oder 1)
-            currentGeneration[i][j] = (cell == 1);  // Setze den Zustand in currentGeneration (true für lebend, false für tot)
+            currentGeneration.set(i, j, cell == 1);  // Setze den Zustand in currentGeneration (true für lebend, false für tot)
         }
     }
 
@@ -213,7 +454,7 @@ bool Grid::save(const std::string &filename) const {
     // Schleife über alle Zellen und schreibe deren Zustand (0 oder 1) in die Datei
     for (int i = 0; i < height; ++i) {  // Schleife über alle Zeilen
         for (int j = 0; j < width; ++j) {  // Schleife über alle Spalten
-            file << (currentGeneration[i][j] ? 1 : 0) << " ";  // Schreibe 1 für lebende Zellen und 0 für tote Zellen
+            file << (currentGeneration.get(i, j) ? 1 : 0) << " ";  // Schreibe 1 für lebende Zellen und 0 für tote Zellen
         }
         file << "\n";  // Zeilenumbruch nach jeder Zeile
     }
@@ -222,14 +463,192 @@ bool Grid::save(const std::string &filename) const {
     return true;  // Rückgabe true, wenn der Speichervorgang erfolgreich war
 }
 
+bool Grid::importPattern(const std::string &filename, int rowOffset, int colOffset) {
+    // Diese Funktion setzt ein Muster im RLE- oder Plaintext-Format (*.rle, *.cells) an die Position
+    // (rowOffset, colOffset); über den Rand hinausragende Teile werden toroidal umgebrochen.
+    // Ist das Gitter noch leer, bekommt es die Größe des Musters. Eine Regel in der Kopfzeile (RLE)
+    // gehört zum Muster und wird wie bei loadBinary() übernommen.
+    PatternIO::Format format = PatternIO::formatFromFilename(filename);
+    if (format == PatternIO::Format::Unknown) {
+        std::cerr << "Error: unknown pattern format (expected .rle or .cells).\n";
+        return false;
+    }
+    std::ifstream file(filename, std::ios::binary);  // Öffne die Datei zum Lesen
+    if (!file.is_open()) {  // Überprüfen, ob die Datei erfolgreich geöffnet wurde
+        std::cerr << "Error opening file!" << std::endl;
+        return false;
+    }
+
+    Rule rule = engineParams.rule;
+    if (height == 0 || width == 0) {
+        int rows, cols;
+        if (!PatternIO::readSize(file, format, rows, cols, rule)) {
+            return false;
+        }
+        setSize(rows, cols);
+        file.clear();
+        file.seekg(0);  // die Zellen werden in einem zweiten Durchlauf gelesen
+    }
+
+    // Die Läufe werden direkt beim Lesen in das Gitter geschrieben, ohne die Datei zwischenzuspeichern.
+    if (format == PatternIO::Format::RLE) {
+        if (!PatternIO::readRle(file, currentGeneration, rowOffset, colOffset, rule)) {
+            return false;
+        }
+        engineParams.rule = rule;
+        return true;
+    }
+    return PatternIO::readCells(file, currentGeneration, rowOffset, colOffset);
+}
+
+bool Grid::exportPattern(const std::string &filename) const {
+    // Diese Funktion schreibt das Gitter im RLE- oder Plaintext-Format, je nach Dateiendung.
+    PatternIO::Format format = PatternIO::formatFromFilename(filename);
+    if (format == PatternIO::Format::Unknown) {
+        std::cerr << "Error: unknown pattern format (expected .rle or .cells).\n";
+        return false;
+    }
+    std::ofstream file(filename, std::ios::binary);  // Öffne die Datei zum Schreiben
+    if (!file.is_open()) {  // Überprüfen, ob die Datei erfolgreich geöffnet wurde
+        std::cerr << "Error opening file!" << std::endl;
+        return false;
+    }
+    if (format == PatternIO::Format::RLE) {
+        return PatternIO::writeRle(file, currentGeneration, engineParams.rule);
+    }
+    return PatternIO::writeCells(file, currentGeneration);
+}
+
+bool Grid::loadBinary(const std::string &filename) {
+    // Diese Funktion blendet eine Datei im binären Weltformat ein. Die eingeblendeten Seiten werden ohne
+    // Kopie als Speicher von currentGeneration verwendet; Änderungen bleiben privat und verändern die Datei nicht.
+    BitGrid loaded;
+    WorldFile::Info info;
+    if (!WorldFile::load(filename, loaded, info)) {
+        return false;
+    }
+    // Die Regel gehört zur Welt und wird mit ihr übernommen.
+    engineParams.rule = Rule(info.birthMask, info.survivalMask);
+
+    height = loaded.getHeight();
+    width = loaded.getWidth();
+    currentGeneration.swap(loaded);
+    nextGeneration.resize(0, 0);  // wird von der Engine bei Bedarf angelegt
+    generation = info.generation;
+    return true;
+}
+
+bool Grid::saveBinary(const std::string &filename) const {
+    // Diese Funktion speichert das Gitter im binären Weltformat: Kopf mit Größe, Generation und Regel,
+    // danach die bitgepackten Zeilen in ganzen Seiten und eine Prüfsumme.
+    WorldFile::Info info{generation, engineParams.rule.birthMask(), engineParams.rule.survivalMask()};
+    return WorldFile::save(filename, currentGeneration, info);
+}
+
+void Grid::setCheckpointing(const std::string &filename, int interval) {
+    // Diese Funktion schaltet periodische Sicherungspunkte ein: alle 'interval' Generationen wird der
+    // Zustand im binären Weltformat nach 'filename' geschrieben (0 schaltet sie aus).
+    checkpointPath = filename;
+    checkpointInterval = interval > 0 ? interval : 0;
+}
+
+void Grid::setFrameExport(const std::string &target, int stride, const FrameExporter::Options &options) {
+    // Diese Funktion legt fest, ob und wohin run() Bilder der Generationen schreibt.
+    exportTarget = target;
+    exportStride = stride > 0 ? stride : 0;
+    exportOptions = options;
+}
+
+bool Grid::resumeFromCheckpoint() {
+    // Diese Funktion lädt die letzte vollständige Sicherung samt Generationszähler.
+    // Der nächste Lauf fügt dann keine Testmuster hinzu, sondern rechnet einfach weiter.
+    if (checkpointPath.empty() || !loadBinary(checkpointPath)) {
+        return false;
+    }
+    resumed = true;
+    return true;
+}
+
+void Grid::seedTestPatterns() {
+    // Diese Funktion fügt die Testmuster der Läufe ein, außer direkt nach dem Fortsetzen einer Sicherung.
+    if (resumed) {
+        resumed = false;
+        return;
+    }
+    addGlider(25, 25);        // Füge einen Glider an Position (25, 25) hinzu
+    addToad(100, 100);        // Füge ein Toad an Position (100, 100) hinzu
+    addBeacon(125, 125);      // Füge ein Beacon an Position (125, 125) hinzu
+    addRPentomino(150, 150);  // Füge ein R-Pentomino an Position (150, 150) hinzu
+}
+
+bool Grid::checkpointDue(Checkpointer *checkpointer, int advanced) const {
+    // Diese Funktion prüft, ob seit dem letzten Schritt ein Vielfaches des Intervalls überschritten
+    // wurde (auch bei Blöcken mehrerer Generationen).
+    if (checkpointer == nullptr) {
+        return false;
+    }
+    return generation / checkpointInterval != (generation - advanced) / checkpointInterval;
+}
+
+void Grid::reportCheckpoints(Checkpointer *checkpointer, long long syncNanoseconds, long long runMilliseconds,
+                             std::ostream &out) {
+    // Diese Funktion wartet auf ausstehende Sicherungen und gibt aus, wie viel Zeit die Simulation dafür abgegeben hat:
+    // die Kopie des Schnappschusses und bei Geräte-Engines das Zurücklesen der Generation davor.
+    if (checkpointer == nullptr) {
+        return;
+    }
+    checkpointer->flush();
+    double syncMs = syncNanoseconds / 1e6;
+    double ms = checkpointer->simulationNanoseconds() / 1e6 + syncMs;
+    out << "Checkpoints: " << checkpointer->writtenCount() << " written, "
+        << checkpointer->skippedCount() << " skipped, " << ms << " ms on the simulation thread";
+    if (runMilliseconds > 0) {
+        out << " (" << 100.0 * ms / runMilliseconds << "%)";
+    }
+    if (syncMs > 0) {
+        out << ", " << syncMs << " ms of it reading back";
+    }
+    out << "\n";
+}
+
+bool Grid::exportDue(FrameExporter *exporter, int advanced) const {
+    // Diese Funktion prüft wie checkpointDue(), ob seit dem letzten Schritt ein Vielfaches der
+    // Schrittweite für Bilder überschritten wurde.
+    if (exporter == nullptr) {
+        return false;
+    }
+    return generation / exportStride != (generation - advanced) / exportStride;
+}
+
+void Grid::reportExports(FrameExporter *exporter, long long runMilliseconds, std::ostream &out) {
+    // Diese Funktion wartet auf ausstehende Bilder und gibt aus, wie viele geschrieben oder ausgelassen wurden.
+    if (exporter == nullptr) {
+        return;
+    }
+    exporter->flush();
+    double ms = exporter->simulationNanoseconds() / 1e6;
+    out << "Frames: " << exporter->writtenCount() << " written, " << exporter->droppedCount()
+        << " dropped, " << ms << " ms on the simulation thread";
+    if (runMilliseconds > 0) {
+        out << " (" << 100.0 * ms / runMilliseconds << "%)";
+    }
+    out << "\n";
+}
+
+long long Grid::getGeneration() const {
+    // Diese Funktion gibt die Anzahl der bisher berechneten Generationen zurück.
+    return generation;
+}
+
 void Grid::setSize(int h, int w) {
     // Diese Funktion setzt die Größe des Gitters auf die angegebenen Werte und initialisiert die Zellzustände.
     height = h;  // Setze die Höhe des Gitters
     width = w;   // Setze die Breite des Gitters
+    generation = 0;
 
-    // Passe die Größe der currentGeneration und nextGeneration Vektoren entsprechend der neuen Höhe und Breite an
-    currentGeneration.resize(height, std::vector<bool>(width, false));
-    nextGeneration.resize(height, std::vector<bool>(width, false));
+    // Passe die Größe von currentGeneration an; nextGeneration wird von der Engine bei Bedarf angelegt
+    currentGeneration.resize(height, width);
+    nextGeneration.resize(0, 0);
 }
 
 int Grid::getHeight() const { 
@@ -246,7 +665,7 @@ void Grid::setCell(int x, int y, bool state) {
     // Diese Funktion setzt den Zustand einer bestimmten Zelle im Gitter, basierend auf den gegebenen x- und y-Koordinaten.
     if (x >= 0 && x < height && y >= 0 && y < width) {
         // Überprüfen, ob die angegebenen Koordinaten innerhalb der Grenzen des Gitters liegen
-        currentGeneration[x][y] = state;  // Setze den Zustand der Zelle
+        currentGeneration.set(x, y, state);  // Setze den Zustand der Zelle
     } else {
         std::cerr << "Error: Coordinates out of bounds.\n";  // Fehlerausgabe, wenn die Koordinaten außerhalb der Grenzen liegen
     }
@@ -260,7 +679,7 @@ void Grid::setCell(int p, bool state) {
     
     if (x >= 0 && x < height && y >= 0 && y < width) {
         // Überprüfen, ob die berechneten Koordinaten innerhalb der Grenzen des Gitters liegen
-        currentGeneration[x][y] = state;  // Setze den Zustand der Zelle
+        currentGeneration.set(x, y, state);  // Setze den Zustand der Zelle
     } else {
         std::cerr << "Error: Index out of bounds.\n";  // Fehlerausgabe, wenn der Index außerhalb der Grenzen liegt
     }
@@ -269,7 +688,7 @@ bool Grid::getCell(int x, int y) const {
     // Diese Funktion gibt den Zustand einer bestimmten Zelle im Gitter zurück, basierend auf den gegebenen x- und y-Koordinaten.
     if (x >= 0 && x < height && y >= 0 && y < width) {
         // Überprüfen, ob die angegebenen Koordinaten innerhalb der Grenzen des Gitters liegen.
-        return currentGeneration[x][y];  // Rückgabe des Zustands der Zelle (true für lebend, false für tot).
+        return currentGeneration.get(x, y);  // Rückgabe des Zustands der Zelle (true für lebend, false für tot).
     } else {
         std::cerr << "Error: Coordinates out of bounds.\n";  // Fehlerausgabe, wenn die Koordinaten außerhalb der Grenzen liegen.
         return false;  // Rückgabe false, wenn die Koordinaten ungültig sind.
@@ -284,7 +703,7 @@ bool Grid::getCell(int p) const {
 
     if (x >= 0 && x < height && y >= 0 && y < width) {
         // Überprüfen, ob die berechneten Koordinaten innerhalb der Grenzen des Gitters liegen.
-        return currentGeneration[x][y];  // Rückgabe des Zustands der Zelle (true für lebend, false für tot).
+        return currentGeneration.get(x, y);  // Rückgabe des Zustands der Zelle (true für lebend, false für tot).
     } else {
         std::cerr << "Error: Index out of bounds.\n";  // Fehlerausgabe, wenn der Index außerhalb der Grenzen liegt.
         return false;  // Rückgabe false, wenn der Index ungültig ist.
@@ -378,186 +797,125 @@ void Grid::setPrintEnabled(bool enabled) {
     printEnabled = enabled;  // Setze den Wert von printEnabled auf den übergebenen Wert.
 }
 
-int Grid::countLiveNeighbors(int x, int y) const {
-    // Diese Funktion zählt die Anzahl der lebenden Nachbarn einer Zelle an den gegebenen x- und y-Koordinaten.
-    
-    int count = 0;  // Zähler für die lebenden Nachbarn, initialisiert mit 0.
-
-    // Schleifen über die benachbarten Zellen (inklusive diagonaler Nachbarn).
-    for (int dx = -1; dx <= 1; ++dx) {
-        for (int dy = -1; dy <= 1; ++dy) {
-            if (dx != 0 || dy != 0) {  // Ignoriere die Zelle selbst (dx == 0 und dy == 0).
-                // Berechne die Koordinaten des Nachbarn, wobei toroidale Randbedingungen angewendet werden.
-                int nx = (x + dx + height) % height;
-                int ny = (y + dy + width) % width;
-                
-                // Inkrementiere den Zähler, wenn der Nachbar lebendig ist.
-                count += currentGeneration[nx][ny] ? 1 : 0;
-            }
-        }
+bool Grid::setDisplayMode(const std::string &name) {
+    // Diese Funktion wählt die Darstellung der Ausgabe: text, blocks, braille oder auto.
+    TerminalRenderer::Mode mode;
+    if (!TerminalRenderer::parseMode(name, mode)) {
+        std::cerr << "Error: unknown display mode " << name << std::endl;
+        return false;
     }
+    renderer.setMode(mode);
+    return true;
+}
 
-    return count;  // Rückgabe der Anzahl der lebenden Nachbarn.
-}
-
-void Grid::evolve_cpu() {
-    // Diese Funktion berechnet die nächste Generation des Gitters auf der CPU,
-    // indem sie die Regeln des "Game of Life" für jede Zelle anwendet.
-
-    // Doppelte Schleifen über jede Zelle des Gitters (x, y).
-    for (int x = 0; x < height; ++x) {
-        for (int y = 0; y < width; ++y) {
-            int count = 0;  // Zähler für die lebenden Nachbarn, initialisiert mit 0.
-            
-            // Schleifen über die benachbarten Zellen, einschließlich diagonaler Nachbarn.
-            for (int dx = -1; dx <= 1; ++dx) {
-                for (int dy = -1; dy <= 1; ++dy) {
-                    if (dx != 0 || dy != 0) {  // Überspringe die Zelle selbst (dx == 0 und dy == 0).
-                        // Berechne die Koordinaten des Nachbarn, wobei toroidale Randbedingungen angewendet werden.
-                        int nx = (x + dx + height) % height;
-                        int ny = (y + dy + width) % width;
-                        // Inkrementiere den Zähler, wenn der Nachbar lebendig ist.
-                        count += (currentGeneration[nx][ny] == true);
-                    }
-                }
-            }
+void Grid::setFrameRate(int fps) {
+    // Diese Funktion legt fest, wie viele Bilder pro Sekunde die Ausgabe während run() höchstens zeigt.
+    framesPerSecond = fps > 0 ? fps : 30;
+}
 
-            // Wende die Regeln des "Game of Life" an:
-            // Eine lebende Zelle bleibt am Leben, wenn sie 2 oder 3 lebende Nachbarn hat.
-            // Eine tote Zelle wird wieder lebendig, wenn sie genau 3 lebende Nachbarn hat.
-            nextGeneration[x][y] = (currentGeneration[x][y] && (count == 2 || count == 3)) || (!currentGeneration[x][y] && count == 3);
-        }
-    }
+void Grid::setViewport(int row, int col, int scale) {
+    // Diese Funktion legt den ausgegebenen Ausschnitt fest: linke obere Zelle und Zellen pro
+    // Bildpunkt (0 = das ganze Gitter in das Terminal einpassen).
+    renderer.setViewport(row, col, scale);
+}
 
-    // Tausche die aktuelle und die nächste Generation, um die Berechnung der nächsten Generation zu ermöglichen.
-    currentGeneration.swap(nextGeneration);
+void Grid::setThreadCount(int threads) {
+    // Diese Funktion legt die Anzahl der CPU-Threads für run() fest (0 = alle Hardware-Threads).
+    engineParams.threads = threads < 0 ? 0 : threads;
 }
 
-void Grid::evolve() {
-    // Diese Funktion berechnet die nächste Generation des Gitters mit Hilfe von OpenCL,
-    // wobei die Berechnungen auf einer GPU oder einem anderen OpenCL-Gerät parallel ausgeführt werden.
+int Grid::getThreadCount() const {
+    // Diese Funktion gibt die tatsächlich verwendete Anzahl der CPU-Threads zurück.
+    return ThreadPool::resolveThreadCount(engineParams.threads);
+}
 
-    cl::Context context(CL_DEVICE_TYPE_DEFAULT);  // Erstelle einen OpenCL-Kontext für das Standardgerät.
-    
-    std::string kernel_code = util::loadProgram(kernel_path);  // Lade den OpenCL-Kernelcode aus einer Datei.
-    cl::Program::Sources sources;  // Erstelle ein Quellenobjekt für den Kernelcode.
-    sources.push_back({kernel_code.c_str(), kernel_code.length()});  // Füge den Kernelcode als Quelle hinzu.
-
-    cl::Program program(context, sources);  // Erstelle ein OpenCL-Programm aus den Quellen im gegebenen Kontext.
-
-    auto devices = context.getInfo<CL_CONTEXT_DEVICES>();  // Hole die Liste der Geräte im Kontext.
-    if (program.build(devices) != CL_SUCCESS) {  // Baue das Programm für die Geräte und überprüfe auf Fehler.
-        for (const auto& device : devices) {
-            // Wenn ein Fehler auftritt, gebe eine Fehlermeldung für jedes Gerät aus.
-            std::cerr << "Error building the kernel for device: "
-                      << device.getInfo<CL_DEVICE_NAME>() << std::endl;
-            std::cerr << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device) << std::endl;
-        }
-        return;  // Beende die Funktion, wenn der Build fehlschlägt.
+bool Grid::setEngine(const std::string &name) {
+    // Diese Funktion wählt die Berechnungsart von run() über ihren Namen (siehe EvolveEngine::names()).
+    // "auto" misst beim nächsten Lauf die verfügbaren Engines oder nimmt den gespeicherten Gewinner.
+    if (name != "auto" && !EvolveEngine::exists(name)) {
+        std::cerr << "Error: unknown engine " << name << std::endl;
+        return false;
     }
+    engineName = name;
+    return true;
+}
 
-    cl::Kernel kernel(program, "evolve");  // Erstelle einen Kernel aus dem Programm, der die Funktion "evolve" ausführt.
-
-    // Erstelle OpenCL-Puffer für die aktuellen und nächsten Generationen sowie für Debug-Informationen.
-    cl::Buffer buffer_current(context, CL_MEM_READ_WRITE, height * width * sizeof(char));
-    cl::Buffer buffer_next(context, CL_MEM_READ_WRITE, height * width * sizeof(char));
-    cl::Buffer buffer_debug(context, CL_MEM_READ_WRITE, height * width * 6 * sizeof(char));
-
-    cl::CommandQueue queue(context);  // Erstelle eine Befehlswarteschlange für das OpenCL-Gerät.
+const std::string &Grid::getEngine() const {
+    // Diese Funktion gibt den Namen der gewählten Berechnungsart zurück.
+    return engineName;
+}
 
-    // Flachlege das zweidimensionale Array der aktuellen Generation in ein eindimensionales Array.
-    std::vector<char> flat_current(height * width);
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            flat_current[i * width + j] = currentGeneration[i][j] ? '0' : '.';  // Lebende Zellen als '0', tote Zellen als '.'.
-        }
-    }
+void Grid::setGenerationsPerPass(int generations) {
+    // Diese Funktion legt fest, wie viele Generationen die zeitliche Blockung pro Durchlauf berechnet.
+    engineParams.generationsPerPass = generations > 0 ? generations : 1;
+}
 
-    cl_int err;
-    // Übertrage die flachen Daten der aktuellen Generation auf den GPU-Puffer.
-    err = queue.enqueueWriteBuffer(buffer_current, CL_TRUE, 0, height * width * sizeof(char), flat_current.data());
-    if (err != CL_SUCCESS) {
-        std::cerr << "Error writing buffer_current: " << err << std::endl;
-        return;
-    }
+int Grid::getGenerationsPerPass() const {
+    // Diese Funktion gibt die Anzahl der Generationen pro Durchlauf der zeitlichen Blockung zurück.
+    return engineParams.generationsPerPass;
+}
 
-    // Setze die Kernel-Argumente: Puffer für aktuelle und nächste Generation, Höhe, Breite und Debug-Puffer.
-    kernel.setArg(0, buffer_current);
-    kernel.setArg(1, buffer_next);
-    kernel.setArg(2, height);
-    kernel.setArg(3, width);
-    kernel.setArg(4, buffer_debug);
+void Grid::setOpenCLTuning(int localX, int localY, int cellsPerItem) {
+    // Diese Funktion legt Kachelgröße und Zellen pro Work-Item des OpenCL-Kernels fest.
+    // Ohne Aufruf wählt die Engine passende Werte für den Gerätetyp.
+    engineParams.localX = localX;
+    engineParams.localY = localY;
+    engineParams.cellsPerItem = cellsPerItem;
+}
 
-    // Definiere den globalen Arbeitsbereich, der der Größe des Gitters entspricht.
-    cl::NDRange global(height, width);
-    // Füge den Kernel zur Befehlswarteschlange hinzu und führe ihn auf der GPU aus.
-    err = queue.enqueueNDRangeKernel(kernel, cl::NullRange, global, cl::NullRange);
-    if (err != CL_SUCCESS) {
-        std::cerr << "Error enqueueing kernel: " << err << std::endl;
-        return;
+bool Grid::setRule(const std::string &text) {
+    // Diese Funktion legt die Regel aller Engines fest, z.B. "B36/S23" oder "highlife".
+    // Vorübersetzte Regeln verwenden eigene Kernel, alle anderen die allgemeine bitparallele Auswertung.
+    Rule rule;
+    if (!Rule::parse(text, rule)) {
+        std::cerr << "Error: invalid rule " << text << " (expected B/S notation such as B3/S23 or a name)" << std::endl;
+        return false;
     }
+    engineParams.rule = rule;
+    return true;
+}
 
-    queue.finish();  // Warte, bis alle Befehle in der Warteschlange ausgeführt wurden.
-
-    // Lese die Ergebnisse der nächsten Generation vom GPU-Puffer zurück in das flache Array.
-    std::vector<char> flat_next(height * width);
-    std::vector<char> debug_info(height * width * 6);
-    err = queue.enqueueReadBuffer(buffer_next, CL_TRUE, 0, height * width * sizeof(char), flat_next.data());
-    if (err != CL_SUCCESS) {
-        std::cerr << "Error reading buffer_next: " << err << std::endl;
-        return;
-    }
+const Rule &Grid::getRule() const {
+    // Diese Funktion gibt die Regel zurück, mit der das Gitter berechnet wird.
+    return engineParams.rule;
+}
 
-    // Lese Debug-Informationen vom GPU-Puffer (falls vorhanden).
-    err = queue.enqueueReadBuffer(buffer_debug, CL_TRUE, 0, height * width * 6 * sizeof(char), debug_info.data());
-    if (err != CL_SUCCESS) {
-        std::cerr << "Error reading buffer_debug: " << err << std::endl;
-        return;
-    }
+void Grid::setCycleDetection(int maxPeriod) {
+    // Diese Funktion legt fest, bis zu welcher Periode run() Oszillatoren erkennt und vorzeitig endet (0 = aus).
+    cycleDetectionPeriod = maxPeriod > 0 ? maxPeriod : 0;
+}
 
-    /*
-    // Optional: Ausgabe der Debug-Informationen nach dem Lesen vom GPU-Puffer.
-    std::cout << "Debug Information (after reading from buffer):\n";
-    for (int i = 0; i < height * width; ++i) {
-        std::cout << debug_info[i * 6] << debug_info[i * 6 + 1] << debug_info[i * 6 + 2]
-                  << debug_info[i * 6 + 3] << debug_info[i * 6 + 4] << debug_info[i * 6 + 5] << "\n";
-    }
-    */
+int Grid::getCycleDetection() const {
+    // Diese Funktion gibt die längste erkannte Periode zurück.
+    return cycleDetectionPeriod;
+}
 
-    // Übertrage die flachen Ergebnisse der nächsten Generation zurück in das zweidimensionale Array.
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            nextGeneration[i][j] = (flat_next[i * width + j] == '0');
+EvolveEngine* Grid::acquireEngine(const std::string &name) {
+    // Diese Funktion liefert die Engine mit dem angegebenen Namen und den aktuellen Parametern.
+    // Die zuletzt verwendete Engine wird wiederverwendet, solange sich beides nicht ändert.
+    std::string chosen = name;
+    EngineParams params = engineParams;
+    if (name == "auto") {
+        // Der Gewinner wird pro Maschine und Gittergröße gespeichert, gemessen wird nur beim ersten Mal.
+        AutoTuner tuner;
+        AutoTuner::Choice choice = tuner.select(height, width, engineParams);
+        if (choice.nsPerGeneration <= 0) {
+            std::cerr << "Error: auto-tuning found no working engine." << std::endl;
+            return nullptr;
         }
+        chosen = choice.engine;
+        params = choice.params;
+        std::cout << "Auto-tuned engine for " << height << "x" << width << ": " << chosen << " ("
+                  << params.describe(chosen) << ", " << choice.nsPerGeneration / 1e3 << " us/generation"
+                  << (choice.cached ? ", cached" : "") << ")\n";
     }
 
-    // Tausche die aktuelle und die nächste Generation, um die Berechnung der nächsten Generation zu ermöglichen.
-    currentGeneration.swap(nextGeneration);
-}
-
-bool Grid::is_stable() {
-    // Diese Funktion überprüft, ob das Gitter in einem stabilen Zustand ist,
-    // d.h. ob sich die aktuelle Generation nicht von der nächsten Generation unterscheidet.
-
-    // Doppelte Schleifen über jede Zelle des Gitters (x, y).
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            // Wenn eine Zelle ihren Zustand ändert, ist das Gitter nicht stabil.
-            if (nextGeneration[i][j] != currentGeneration[i][j]) {
-                return false;  // Rückgabe false, wenn das Gitter nicht stabil ist.
-            }
-        }
+    if (engine && engineBuiltName == chosen && engineBuiltParams == params) {
+        return engine.get();
     }
-    return true;  // Rückgabe true, wenn das Gitter stabil ist.
+    engine.reset(EvolveEngine::create(chosen, params));
+    engineBuiltName = chosen;
+    engineBuiltParams = params;
+    return engine.get();
 }
 
-void Grid::clearScreen() const {
-    // Diese Funktion löscht den Bildschirm, um die Ausgabe des Gitters zu aktualisieren.
-
-    #ifdef _WIN32
-        system("cls");  // Verwende den Befehl "cls" für Windows.
-    #else
-        int result = system("clear");  // Verwende den Befehl "clear" für Unix-basierte Systeme.
-        (void)result;  // Unterdrücke die Warnung über den ungenutzten Rückgabewert.
-    #endif
-}
@@ -3,31 +3,79 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <iosfwd>
+#include "BitGrid.h"
+#include "LifeKernels.h"
+#include "EvolveEngine.h"
+#include "TerminalRenderer.h"
+#include "Presenter.h"
+#include "FrameExporter.h"
+
+// Pfad zur OpenCL-Kernel-Datei (definiert in Grid.cpp); Voreinstellung von Grid und Ensemble.
+extern const std::string kernel_path;
+
+class Checkpointer;
 
 class Grid {
     private:
         int height, width;
-        std::vector<std::vector<bool>> currentGeneration;
-        std::vector<std::vector<bool>> nextGeneration;
+        BitGrid currentGeneration;
+        BitGrid nextGeneration;
         bool printEnabled;
+        TerminalRenderer renderer;  // Ausgabe der Generationen mit Ausschnitt und Verkleinerung
+        FrameExchange frames;       // Übergabe fertiger Generationen an den Ausgabe-Thread
+        int framesPerSecond;        // Bildrate der Ausgabe während run()
+        std::string engineName;     // Berechnungsart von run(), siehe EvolveEngine::names() oder "auto"
+        EngineParams engineParams;  // Threads, Generationen pro Durchlauf, OpenCL-Tuning, ...
+        long long generation;  // Anzahl der bisher berechneten Generationen (wird mit dem Binärformat gespeichert)
+        std::string checkpointPath;  // Datei für Sicherungspunkte
+        int checkpointInterval;      // Generationen zwischen zwei Sicherungen, 0 = aus
+        std::string exportTarget;               // Verzeichnis, "-" oder "|Programm" für Bilder
+        int exportStride;                       // Generationen zwischen zwei Bildern, 0 = aus
+        FrameExporter::Options exportOptions;
+        bool resumed;                // Zustand stammt aus einer Sicherung, keine Testmuster hinzufügen
+        int cycleDetectionPeriod;    // längste erkannte Periode eines Oszillators, 0 = aus
+        // Die zuletzt verwendete Engine bleibt erhalten, damit z.B. das OpenCL-Programm nicht bei
+        // jedem Lauf neu übersetzt wird; sie wird nur bei anderem Namen oder anderen Parametern ersetzt.
+        std::unique_ptr<EvolveEngine> engine;
+        std::string engineBuiltName;
+        EngineParams engineBuiltParams;
 
-        int countLiveNeighbors(int x, int y) const;
-        void evolve();
-        void evolve_cpu();
-        bool is_stable();
-        void clearScreen() const;
-        void print() const;
+        EvolveEngine* acquireEngine(const std::string &name);
+        void seedTestPatterns();
+        bool checkpointDue(Checkpointer *checkpointer, int advanced) const;
+        void reportCheckpoints(Checkpointer *checkpointer, long long syncNanoseconds, long long runMilliseconds,
+                               std::ostream &out);
+        bool exportDue(FrameExporter *exporter, int advanced) const;
+        void reportExports(FrameExporter *exporter, long long runMilliseconds, std::ostream &out);
+        void print(long long generationNumber);
         void randomize();
 
     public:
         Grid();
         Grid(int h, int w);
+        ~Grid();
         std::pair<int, int> to2D(int p) const;
         void initializePattern(const std::string &filename);
-        long long run(int generations, int delay_ms);
+        // Ohne engine wird die mit setEngine() gewählte Engine verwendet.
+        long long run(int generations, int delay_ms, const std::string &engine = std::string());
         long long run_with_opencl(int generations, int delay_ms);
+        long long run_with_hashlife(long long generations);
+        // Rechnet auf der unbegrenzten Ebene (SparseUniverse); das Gitter ist danach deren Ausschnitt ab (0, 0).
+        long long run_unbounded(long long generations);
         bool load(const std::string &filename);
         bool save(const std::string &filename) const;
+        bool importPattern(const std::string &filename, int rowOffset = 0, int colOffset = 0);
+        bool exportPattern(const std::string &filename) const;
+        bool loadBinary(const std::string &filename);
+        bool saveBinary(const std::string &filename) const;
+        long long getGeneration() const;
+        void setCheckpointing(const std::string &filename, int interval);
+        bool resumeFromCheckpoint();
+        // Schreibt während run() jede stride-te Generation als Bild (siehe FrameExporter); stride 0 = aus.
+        void setFrameExport(const std::string &target, int stride,
+                            const FrameExporter::Options &options = FrameExporter::Options());
         void setSize(int h, int w);
         int getHeight() const;
         int getWidth() const;
@@ -40,6 +88,21 @@ class Grid {
         void addBeacon(int x, int y);
         void addRPentomino(int x, int y);
         void setPrintEnabled(bool enabled);
+        bool setDisplayMode(const std::string &name);
+        void setViewport(int row, int col, int scale);
+        void setFrameRate(int fps);
+        void setThreadCount(int threads);
+        int getThreadCount() const;
+        bool setEngine(const std::string &name);
+        const std::string &getEngine() const;
+        void setGenerationsPerPass(int generations);
+        int getGenerationsPerPass() const;
+        void setOpenCLTuning(int localX, int localY, int cellsPerItem);
+        // Regel in B/S-Notation oder als Name (siehe Rule::parse()); false bei ungültiger Eingabe.
+        bool setRule(const std::string &text);
+        const Rule &getRule() const;
+        void setCycleDetection(int maxPeriod);
+        int getCycleDetection() const;
 };
 
 #endif // GRID_H
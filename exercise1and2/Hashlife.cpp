@@ -0,0 +1,291 @@
+#include "Hashlife.h"
+
+Hashlife::Hashlife(size_t maxNodeCount)
+    : maxNodes(maxNodeCount), root(DEAD), rootLevel(0), height(0), width(0), generation(0) {
+    reset();
+}
+
+bool Hashlife::supports(int h, int w) {
+    // Beide Kantenlängen müssen Zweierpotenzen sein, die größere mindestens 2.
+    auto powerOfTwo = [](int v) { return v > 0 && (v & (v - 1)) == 0; };
+    return powerOfTwo(h) && powerOfTwo(w) && (h >= 2 || w >= 2);
+}
+
+void Hashlife::reset() {
+    // Die beiden Blätter (tot, lebendig) haben feste Indizes.
+    nodes.clear();
+    nodes.push_back({0, 0, 0, 0, NONE, 0});
+    nodes.push_back({0, 0, 0, 0, NONE, 0});
+    table.clear();
+    slowResults.clear();
+    emptyNodes.assign(1, DEAD);
+}
+
+void Hashlife::setRule(const Rule &newRule) {
+    if (newRule == rule) {
+        return;
+    }
+    rule = newRule;
+    for (Node &node : nodes) {
+        node.result = NONE;
+    }
+    slowResults.clear();
+}
+
+uint32_t Hashlife::join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+    // Jeder Knoten existiert nur einmal: gleiche Kinder liefern denselben Index.
+    Key key{nw, ne, sw, se};
+    auto it = table.find(key);
+    if (it != table.end()) {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({nw, ne, sw, se, NONE, nodes[nw].level + 1});
+    table.emplace(key, index);
+    return index;
+}
+
+uint32_t Hashlife::empty(int level) {
+    while (static_cast<int>(emptyNodes.size()) <= level) {
+        uint32_t e = emptyNodes.back();
+        emptyNodes.push_back(join(e, e, e, e));
+    }
+    return emptyNodes[level];
+}
+
+uint32_t Hashlife::centre(uint32_t n) {
+    // Die mittleren 2^(level-1) x 2^(level-1) Zellen eines Knotens, ohne Zeitschritt.
+    Node node = nodes[n];
+    return join(nodes[node.nw].se, nodes[node.ne].sw, nodes[node.sw].ne, nodes[node.se].nw);
+}
+
+uint32_t Hashlife::baseResult(uint32_t n) {
+    // Ebene 2 (4 x 4 Zellen): die mittleren 2 x 2 Zellen werden direkt nach den Regeln berechnet.
+    int cells[4][4];
+    const uint32_t quadrants[2][2] = { { nodes[n].nw, nodes[n].ne }, { nodes[n].sw, nodes[n].se } };
+    for (int qr = 0; qr < 2; ++qr) {
+        for (int qc = 0; qc < 2; ++qc) {
+            const Node &q = nodes[quadrants[qr][qc]];
+            cells[2 * qr][2 * qc] = q.nw == ALIVE;
+            cells[2 * qr][2 * qc + 1] = q.ne == ALIVE;
+            cells[2 * qr + 1][2 * qc] = q.sw == ALIVE;
+            cells[2 * qr + 1][2 * qc + 1] = q.se == ALIVE;
+        }
+    }
+
+    uint32_t next[2][2];
+    for (int r = 1; r <= 2; ++r) {
+        for (int c = 1; c <= 2; ++c) {
+            int count = 0;
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    if (dr != 0 || dc != 0) {
+                        count += cells[r + dr][c + dc];
+                    }
+                }
+            }
+            next[r - 1][c - 1] = rule.next(cells[r][c] != 0, count) ? ALIVE : DEAD;
+        }
+    }
+    return join(next[0][0], next[0][1], next[1][0], next[1][1]);
+}
+
+uint32_t Hashlife::result(uint32_t n, int k) {
+    // Liefert die Mitte (Ebene level - 1) des Knotens n nach 2^k Generationen, 0 <= k <= level - 2.
+    Node node = nodes[n];
+    int level = static_cast<int>(node.level);
+    bool fullSpeed = (k == level - 2);
+
+    if (n == empty(level)) {
+        return empty(level - 1);
+    }
+    if (fullSpeed && node.result != NONE) {
+        return node.result;
+    }
+    uint64_t slowKey = (static_cast<uint64_t>(n) << 6) | static_cast<uint64_t>(k);
+    if (!fullSpeed) {
+        auto it = slowResults.find(slowKey);
+        if (it != slowResults.end()) {
+            return it->second;
+        }
+    }
+
+    uint32_t r;
+    if (level == 2) {
+        r = baseResult(n);
+    } else {
+        Node a = nodes[node.nw], b = nodes[node.ne], c = nodes[node.sw], d = nodes[node.se];
+
+        // Neun überlappende Teilquadrate der halben Kantenlänge.
+        uint32_t sub[3][3] = {
+            { node.nw, join(a.ne, b.nw, a.se, b.sw), node.ne },
+            { join(a.sw, a.se, c.nw, c.ne), join(a.se, b.sw, c.ne, d.nw), join(b.sw, b.se, d.nw, d.ne) },
+            { node.sw, join(c.ne, d.nw, c.se, d.sw), node.se },
+        };
+
+        // Volle Geschwindigkeit: zwei Halbschritte von je 2^(level-3) Generationen.
+        // Sonst wird im ersten Schritt nur die Mitte genommen und im zweiten um 2^k weitergerechnet.
+        uint32_t partial[3][3];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                partial[i][j] = fullSpeed ? result(sub[i][j], level - 3) : centre(sub[i][j]);
+            }
+        }
+
+        int nextK = fullSpeed ? level - 3 : k;
+        uint32_t q00 = result(join(partial[0][0], partial[0][1], partial[1][0], partial[1][1]), nextK);
+        uint32_t q01 = result(join(partial[0][1], partial[0][2], partial[1][1], partial[1][2]), nextK);
+        uint32_t q10 = result(join(partial[1][0], partial[1][1], partial[2][0], partial[2][1]), nextK);
+        uint32_t q11 = result(join(partial[1][1], partial[1][2], partial[2][1], partial[2][2]), nextK);
+        r = join(q00, q01, q10, q11);
+    }
+
+    if (fullSpeed) {
+        nodes[n].result = r;
+    } else {
+        slowResults.emplace(slowKey, r);
+    }
+    return r;
+}
+
+uint32_t Hashlife::build(const BitGrid &grid, int level, int row, int col) {
+    if (level == 0) {
+        return grid.get(row % height, col % width) ? ALIVE : DEAD;
+    }
+
+    // Große leere Bereiche werden wortweise erkannt und direkt als leerer Knoten eingesetzt.
+    int size = 1 << level;
+    if (size >= 64 && size <= height && size <= width) {
+        int r0 = row % height;
+        int w0 = (col % width) / 64;
+        bool isEmpty = true;
+        for (int r = r0; r < r0 + size && isEmpty; ++r) {
+            const uint64_t* words = grid.row(r);
+            for (int k = w0; k < w0 + size / 64; ++k) {
+                if (words[k] != 0) {
+                    isEmpty = false;
+                    break;
+                }
+            }
+        }
+        if (isEmpty) {
+            return empty(level);
+        }
+    }
+
+    int half = size / 2;
+    uint32_t nw = build(grid, level - 1, row, col);
+    uint32_t ne = build(grid, level - 1, row, col + half);
+    uint32_t sw = build(grid, level - 1, row + half, col);
+    uint32_t se = build(grid, level - 1, row + half, col + half);
+    return join(nw, ne, sw, se);
+}
+
+void Hashlife::write(uint32_t n, int level, int row, int col, BitGrid &grid) const {
+    if (row >= height || col >= width) {
+        return;  // außerhalb des Gitters (periodische Kopie)
+    }
+    if (level < static_cast<int>(emptyNodes.size()) && n == emptyNodes[level]) {
+        return;
+    }
+    if (level == 0) {
+        grid.set(row, col, n == ALIVE);
+        return;
+    }
+    int half = 1 << (level - 1);
+    const Node &node = nodes[n];
+    write(node.nw, level - 1, row, col, grid);
+    write(node.ne, level - 1, row, col + half, grid);
+    write(node.sw, level - 1, row + half, col, grid);
+    write(node.se, level - 1, row + half, col + half, grid);
+}
+
+bool Hashlife::importGrid(const BitGrid &grid) {
+    if (!supports(grid.getHeight(), grid.getWidth())) {
+        return false;
+    }
+    height = grid.getHeight();
+    width = grid.getWidth();
+
+    // Das Gitter wird periodisch auf ein L x L Quadrat gekachelt.
+    int size = height > width ? height : width;
+    rootLevel = 0;
+    while ((1 << rootLevel) < size) {
+        ++rootLevel;
+    }
+
+    reset();
+    root = build(grid, rootLevel, 0, 0);
+    generation = 0;
+    return true;
+}
+
+void Hashlife::exportGrid(BitGrid &grid) const {
+    if (grid.getHeight() != height || grid.getWidth() != width) {
+        grid.resize(height, width);
+    } else {
+        grid.clear();
+    }
+    write(root, rootLevel, 0, 0, grid);
+}
+
+void Hashlife::stepPowerOfTwo(int k) {
+    // Vier Kopien des periodischen Quadrats ergeben einen Knoten doppelter Kantenlänge; dessen
+    // Ergebnis ist das Quadrat nach 2^k Generationen, aber um L/2 verschoben. Die Mitte von vier
+    // Kopien dieses Ergebnisses verschiebt um weitere L/2 und stellt damit die Lage wieder her.
+    uint32_t doubled = join(root, root, root, root);
+    uint32_t shifted = result(doubled, k);
+    Node s = nodes[shifted];
+    root = join(s.se, s.sw, s.ne, s.nw);
+    generation += 1LL << k;
+}
+
+void Hashlife::advance(long long generations) {
+    while (generations > 0) {
+        // Größte Zweierpotenz, die noch passt und die der Torus in einem Schritt erlaubt.
+        int k = 0;
+        while (k + 1 <= maxStepLog2() && (1LL << (k + 1)) <= generations) {
+            ++k;
+        }
+        if (nodes.size() > maxNodes) {
+            collectGarbage();
+        }
+        stepPowerOfTwo(k);
+        generations -= 1LL << k;
+    }
+}
+
+uint32_t Hashlife::copyReachable(uint32_t n, std::vector<uint32_t> &remap, std::vector<Node> &target) {
+    if (remap[n] != NONE) {
+        return remap[n];
+    }
+    Node node = nodes[n];
+    uint32_t nw = copyReachable(node.nw, remap, target);
+    uint32_t ne = copyReachable(node.ne, remap, target);
+    uint32_t sw = copyReachable(node.sw, remap, target);
+    uint32_t se = copyReachable(node.se, remap, target);
+    remap[n] = static_cast<uint32_t>(target.size());
+    target.push_back({nw, ne, sw, se, NONE, node.level});
+    return remap[n];
+}
+
+void Hashlife::collectGarbage() {
+    // Behält nur die vom aktuellen Quadrat erreichbaren Knoten; gemerkte Ergebnisse werden verworfen.
+    std::vector<uint32_t> remap(nodes.size(), NONE);
+    std::vector<Node> target;
+    target.reserve(nodes.size() / 4 + 2);
+    target.push_back(nodes[DEAD]);
+    target.push_back(nodes[ALIVE]);
+    remap[DEAD] = DEAD;
+    remap[ALIVE] = ALIVE;
+
+    root = copyReachable(root, remap, target);
+
+    nodes.swap(target);
+    table.clear();
+    for (uint32_t i = 2; i < nodes.size(); ++i) {
+        table.emplace(Key{nodes[i].nw, nodes[i].ne, nodes[i].sw, nodes[i].se}, i);
+    }
+    slowResults.clear();
+    emptyNodes.assign(1, DEAD);
+}
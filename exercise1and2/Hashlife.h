@@ -0,0 +1,95 @@
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include "BitGrid.h"
+#include "Rule.h"
+
+// Hashlife-Engine für sehr lange Läufe: das Spielfeld wird als kanonischer Quadtree gespeichert,
+// gleiche Teilbäume existieren nur einmal, und das Ergebnis (die Mitte eines Knotens nach
+// 2^k Generationen) wird pro Knoten gemerkt. Dadurch kann in Zweierpotenzen vorgesprungen werden.
+//
+// Der Torus wird abgebildet, indem das Gitter periodisch auf ein L x L Quadrat (L = Zweierpotenz)
+// gekachelt wird; Höhe und Breite müssen deshalb Zweierpotenzen sein (siehe supports()).
+class Hashlife {
+    private:
+        struct Node {
+            uint32_t nw, ne, sw, se;  // Kinder (Indizes in nodes), bei Blättern unbenutzt
+            uint32_t result;          // gemerktes Ergebnis für 2^(level-2) Generationen
+            uint32_t level;           // Kantenlänge 2^level
+        };
+
+        struct Key {
+            uint32_t nw, ne, sw, se;
+            bool operator==(const Key &other) const {
+                return nw == other.nw && ne == other.ne && sw == other.sw && se == other.se;
+            }
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key &k) const {
+                uint64_t h = k.nw * 0x9E3779B97F4A7C15ULL;
+                h ^= (h >> 29) + k.ne * 0xBF58476D1CE4E5B9ULL;
+                h ^= (h >> 31) + k.sw * 0x94D049BB133111EBULL;
+                h ^= (h >> 30) + k.se * 0x9E3779B97F4A7C15ULL;
+                return static_cast<size_t>(h ^ (h >> 32));
+            }
+        };
+
+        static constexpr uint32_t NONE = 0xFFFFFFFFu;
+        static constexpr uint32_t DEAD = 0;   // Blatt: tote Zelle
+        static constexpr uint32_t ALIVE = 1;  // Blatt: lebende Zelle
+
+        std::vector<Node> nodes;
+        std::unordered_map<Key, uint32_t, KeyHash> table;   // kanonische Knoten
+        std::unordered_map<uint64_t, uint32_t> slowResults; // Ergebnisse für kleinere Sprünge (Knoten, k)
+        std::vector<uint32_t> emptyNodes;                   // leerer Knoten je Ebene
+        size_t maxNodes;
+        Rule rule;
+
+        uint32_t root;      // aktuelles L x L Quadrat
+        int rootLevel;
+        int height, width;
+        long long generation;
+
+        void reset();
+        uint32_t join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+        uint32_t empty(int level);
+        uint32_t centre(uint32_t n);
+        uint32_t baseResult(uint32_t n);
+        uint32_t result(uint32_t n, int k);
+        uint32_t build(const BitGrid &grid, int level, int row, int col);
+        void write(uint32_t n, int level, int row, int col, BitGrid &grid) const;
+        void stepPowerOfTwo(int k);
+        void collectGarbage();
+        uint32_t copyReachable(uint32_t n, std::vector<uint32_t> &remap, std::vector<Node> &target);
+
+    public:
+        explicit Hashlife(size_t maxNodeCount = 1u << 22);
+
+        // Hashlife braucht Zweierpotenzen als Kantenlängen, damit die Periode des Torus in den Quadtree passt.
+        static bool supports(int h, int w);
+        // Leerer Raum muss leer bleiben, sonst wären leere Teilbäume nicht mehr ihr eigenes Ergebnis.
+        static bool supports(const Rule &rule) { return rule.keepsEmptySpaceEmpty(); }
+
+        // Wechselt die Regel; gemerkte Ergebnisse der alten Regel werden verworfen.
+        void setRule(const Rule &newRule);
+
+        // Übernimmt ein toroidales Gitter; gibt false zurück, wenn die Größe nicht unterstützt wird.
+        bool importGrid(const BitGrid &grid);
+        // Schreibt den aktuellen Zustand zurück in ein Gitter der importierten Größe.
+        void exportGrid(BitGrid &grid) const;
+
+        // Rechnet beliebig viele Generationen weiter, zerlegt in Sprünge von Zweierpotenzen.
+        void advance(long long generations);
+
+        long long getGeneration() const { return generation; }
+        size_t nodeCount() const { return nodes.size(); }
+        // Größter einzelner Sprung (2^maxStepLog2() Generationen) für das importierte Gitter.
+        int maxStepLog2() const { return rootLevel - 1; }
+};
+
+#endif // HASHLIFE_H
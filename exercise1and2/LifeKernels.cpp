@@ -0,0 +1,472 @@
+#include "LifeKernels.h"
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GOL_X86_SIMD 1
+#endif
+
+// Westnachbarn von Wort k: jede Zelle sieht das Bit eine Spalte weiter links.
+// Für Wort 0 kommt das unterste Bit aus der letzten gültigen Spalte der Zeile (toroidaler Rand).
+static inline uint64_t westWord(const uint64_t* r, int k, int n, int tailBits) {
+    uint64_t carry = (k > 0) ? (r[k - 1] >> 63) : ((r[n - 1] >> (tailBits - 1)) & 1ULL);
+    return (r[k] << 1) | carry;
+}
+
+// Ostnachbarn von Wort k: jede Zelle sieht das Bit eine Spalte weiter rechts.
+// Für das letzte Wort landet Spalte 0 an der Position der letzten gültigen Spalte.
+static inline uint64_t eastWord(const uint64_t* r, int k, int n, int tailBits) {
+    if (k < n - 1) {
+        return (r[k] >> 1) | (r[k + 1] << 63);
+    }
+    return (r[k] >> 1) | ((r[0] & 1ULL) << (tailBits - 1));
+}
+
+// Berechnet ein einzelnes Wort mit vollständiger Randbehandlung.
+template <class Logic>
+static inline uint64_t edgeWord(const Logic &logic, const uint64_t* up, const uint64_t* mid, const uint64_t* down,
+                                int k, int n, int tailBits) {
+    return ruleWord(logic, westWord(up, k, n, tailBits), up[k], eastWord(up, k, n, tailBits),
+                    westWord(mid, k, n, tailBits), mid[k], eastWord(mid, k, n, tailBits),
+                    westWord(down, k, n, tailBits), down[k], eastWord(down, k, n, tailBits));
+}
+
+// Inneres Wort k (0 < k < n - 1): die Nachbarbits kommen direkt aus den angrenzenden Wörtern.
+template <class Logic>
+static GOL_KERNEL_INLINE uint64_t innerWord(const Logic &logic, const uint64_t* up, const uint64_t* mid,
+                                            const uint64_t* down, int k) {
+    return ruleWord(logic, (up[k] << 1) | (up[k - 1] >> 63), up[k], (up[k] >> 1) | (up[k + 1] << 63),
+                    (mid[k] << 1) | (mid[k - 1] >> 63), mid[k], (mid[k] >> 1) | (mid[k + 1] << 63),
+                    (down[k] << 1) | (down[k - 1] >> 63), down[k], (down[k] >> 1) | (down[k + 1] << 63));
+}
+
+// Die inneren Wörter [begin, end) einer Zeile; jeder Kernel wird pro Regelauswertung instanziiert.
+template <class Logic>
+static void innerPortable(const Logic &logic, const uint64_t* up, const uint64_t* mid, const uint64_t* down,
+                          uint64_t* out, int begin, int end) {
+    for (int k = begin; k < end; ++k) {
+        out[k] = innerWord(logic, up, mid, down, k);
+    }
+}
+
+#ifdef GOL_X86_SIMD
+
+// SSE4.2: zwei Wörter (128 Zellen) pro Schritt.
+// Die West- und Ostnachbarn entstehen aus unausgerichteten Ladezugriffen um ein Wort versetzt.
+__attribute__((target("sse4.2")))
+static inline void neighboursSse42(const uint64_t* r, int k, __m128i &w, __m128i &c, __m128i &e) {
+    c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + k));
+    __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + k - 1));
+    __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + k + 1));
+    w = _mm_or_si128(_mm_slli_epi64(c, 1), _mm_srli_epi64(prev, 63));
+    e = _mm_or_si128(_mm_srli_epi64(c, 1), _mm_slli_epi64(next, 63));
+}
+
+// Die Addiererkette und die Regel sind dieselben Vorlagen wie für einzelne Wörter; die
+// Bitoperatoren wirken auf die Vektortypen elementweise.
+template <class Logic>
+__attribute__((target("sse4.2")))
+static void innerSse42(const Logic &logic, const uint64_t* up, const uint64_t* mid, const uint64_t* down,
+                       uint64_t* out, int begin, int end) {
+    int k = begin;
+    for (; k + 2 <= end; k += 2) {
+        __m128i uw, uc, ue, mw, mc, me, dw, dc, de;
+        neighboursSse42(up, k, uw, uc, ue);
+        neighboursSse42(mid, k, mw, mc, me);
+        neighboursSse42(down, k, dw, dc, de);
+        __m128i result;
+        ruleWord(logic, uw, uc, ue, mw, mc, me, dw, dc, de, result);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), result);
+    }
+    for (; k < end; ++k) {
+        out[k] = innerWord(logic, up, mid, down, k);
+    }
+}
+
+// AVX2: vier Wörter (256 Zellen) pro Schritt.
+__attribute__((target("avx2")))
+static inline void neighboursAvx2(const uint64_t* r, int k, __m256i &w, __m256i &c, __m256i &e) {
+    c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + k));
+    __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + k - 1));
+    __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + k + 1));
+    w = _mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(prev, 63));
+    e = _mm256_or_si256(_mm256_srli_epi64(c, 1), _mm256_slli_epi64(next, 63));
+}
+
+template <class Logic>
+__attribute__((target("avx2")))
+static void innerAvx2(const Logic &logic, const uint64_t* up, const uint64_t* mid, const uint64_t* down,
+                      uint64_t* out, int begin, int end) {
+    int k = begin;
+    for (; k + 4 <= end; k += 4) {
+        __m256i uw, uc, ue, mw, mc, me, dw, dc, de;
+        neighboursAvx2(up, k, uw, uc, ue);
+        neighboursAvx2(mid, k, mw, mc, me);
+        neighboursAvx2(down, k, dw, dc, de);
+        __m256i result;
+        ruleWord(logic, uw, uc, ue, mw, mc, me, dw, dc, de, result);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), result);
+    }
+    for (; k < end; ++k) {
+        out[k] = innerWord(logic, up, mid, down, k);
+    }
+}
+
+// AVX-512: acht Wörter (512 Zellen) pro Schritt. Die Volladdierer werden mit vpternlogq
+// in je zwei Befehlen berechnet (0x96 = XOR von drei Operanden, 0xE8 = Mehrheitsfunktion).
+__attribute__((target("avx512f")))
+static inline void neighboursAvx512(const uint64_t* r, int k, __m512i &w, __m512i &c, __m512i &e) {
+    c = _mm512_loadu_si512(r + k);
+    __m512i prev = _mm512_loadu_si512(r + k - 1);
+    __m512i next = _mm512_loadu_si512(r + k + 1);
+    w = _mm512_or_si512(_mm512_slli_epi64(c, 1), _mm512_srli_epi64(prev, 63));
+    e = _mm512_or_si512(_mm512_srli_epi64(c, 1), _mm512_slli_epi64(next, 63));
+}
+
+template <class Logic>
+__attribute__((target("avx512f")))
+static void innerAvx512(const Logic &logic, const uint64_t* up, const uint64_t* mid, const uint64_t* down,
+                        uint64_t* out, int begin, int end) {
+    int k = begin;
+    for (; k + 8 <= end; k += 8) {
+        __m512i uw, uc, ue, mw, mc, me, dw, dc, de;
+        neighboursAvx512(up, k, uw, uc, ue);
+        neighboursAvx512(mid, k, mw, mc, me);
+        neighboursAvx512(down, k, dw, dc, de);
+
+        __m512i u0 = _mm512_ternarylogic_epi64(uw, uc, ue, 0x96);
+        __m512i u1 = _mm512_ternarylogic_epi64(uw, uc, ue, 0xE8);
+        __m512i m0 = _mm512_xor_si512(mw, me);
+        __m512i m1 = _mm512_and_si512(mw, me);
+        __m512i d0 = _mm512_ternarylogic_epi64(dw, dc, de, 0x96);
+        __m512i d1 = _mm512_ternarylogic_epi64(dw, dc, de, 0xE8);
+
+        NeighbourSum<__v8di> sum;  // __v8di: __m512i ohne may_alias, das als Vorlagenargument verloren ginge
+        sum.ones = _mm512_ternarylogic_epi64(u0, m0, d0, 0x96);
+        __m512i c0 = _mm512_ternarylogic_epi64(u0, m0, d0, 0xE8);
+        sum.setTwos(u1, m1, d1, c0);
+
+        __m512i result;
+        logic.cells(sum, mc, result);
+        _mm512_storeu_si512(out + k, result);
+    }
+    for (; k < end; ++k) {
+        out[k] = innerWord(logic, up, mid, down, k);
+    }
+}
+
+#endif // GOL_X86_SIMD
+
+// Berechnet die Wörter [begin, end) einer Zeile: Randwörter mit toroidaler Behandlung, dazwischen Inner.
+template <class Logic, void (*Inner)(const Logic &, const uint64_t*, const uint64_t*, const uint64_t*, uint64_t*, int, int)>
+static void rowRange(const Rule &rule, const uint64_t* up, const uint64_t* mid, const uint64_t* down, uint64_t* out,
+                     int n, int width, int begin, int end) {
+    const Logic logic(rule);
+    int tailBits = width - 64 * (n - 1);
+    uint64_t tailMask = tailBits == 64 ? ~0ULL : ((1ULL << tailBits) - 1);
+
+    // Das erste und das letzte Wort brauchen die toroidale Randbehandlung.
+    if (begin == 0) {
+        out[0] = edgeWord(logic, up, mid, down, 0, n, tailBits);
+    }
+
+    // Innere Wörter mit dem beim Start gewählten SIMD-Kernel.
+    int innerBegin = begin > 1 ? begin : 1;
+    int innerEnd = end < n - 1 ? end : n - 1;
+    if (innerBegin < innerEnd) {
+        Inner(logic, up, mid, down, out, innerBegin, innerEnd);
+    }
+
+    if (end == n) {
+        if (n > 1) {
+            out[n - 1] = edgeWord(logic, up, mid, down, n - 1, n, tailBits);
+        }
+        // Bits hinter der letzten Spalte bleiben immer 0 (auch bei Regeln mit Geburt ohne Nachbarn).
+        out[n - 1] &= tailMask;
+    }
+}
+
+typedef void (*RowKernel)(const Rule &rule, const uint64_t* up, const uint64_t* mid, const uint64_t* down,
+                          uint64_t* out, int n, int width, int begin, int end);
+
+// Liefert für eine Regelauswertung den Zeilenkernel der SIMD-Stufe (siehe visitRule()).
+struct RowKernelFor {
+    SimdLevel level;
+
+    template <class Logic>
+    RowKernel operator()(const Logic &) const {
+        switch (level) {
+#ifdef GOL_X86_SIMD
+            case SimdLevel::AVX512: return rowRange<Logic, innerAvx512<Logic>>;
+            case SimdLevel::AVX2:   return rowRange<Logic, innerAvx2<Logic>>;
+            case SimdLevel::SSE42:  return rowRange<Logic, innerSse42<Logic>>;
+#endif
+            default: return rowRange<Logic, innerPortable<Logic>>;
+        }
+    }
+};
+
+// Zählt veränderte Zellen und summiert den Hash über count Wörter (siehe accumulateWords()).
+typedef void (*StatsKernel)(const uint64_t* before, const uint64_t* after, int count, uint64_t position, StepStats &stats);
+
+static void statsPortable(const uint64_t* before, const uint64_t* after, int count, uint64_t position, StepStats &stats) {
+    for (int k = 0; k < count; ++k) {
+        stats.changed += __builtin_popcountll(before[k] ^ after[k]);
+        stats.hash += hashWord(after[k], position + k);
+    }
+}
+
+#ifdef GOL_X86_SIMD
+
+// Wie statsPortable(), aber mit dem POPCNT-Befehl statt der Bitmasken-Folge.
+__attribute__((target("popcnt")))
+static void statsPopcnt(const uint64_t* before, const uint64_t* after, int count, uint64_t position, StepStats &stats) {
+    for (int k = 0; k < count; ++k) {
+        stats.changed += __builtin_popcountll(before[k] ^ after[k]);
+        stats.hash += hashWord(after[k], position + k);
+    }
+}
+
+// AVX-512: acht Wörter pro Schritt. Die Positionsfaktoren werden fortlaufend addiert statt multipliziert,
+// die beiden Teilprodukte des Hashs liefert vpmuludq.
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static void statsAvx512(const uint64_t* before, const uint64_t* after, int count, uint64_t position, StepStats &stats) {
+    const uint64_t factor = 0x9E3779B97F4A7C15ULL;
+    const __m512i lowMul = _mm512_set1_epi64(0x85EBCA6BLL);
+    const __m512i highMul = _mm512_set1_epi64(0xC2B2AE35LL);
+    const __m512i stride = _mm512_set1_epi64(static_cast<long long>(8 * factor));
+    __m512i weights = _mm512_set_epi64(
+        static_cast<long long>((position + 7) * factor), static_cast<long long>((position + 6) * factor),
+        static_cast<long long>((position + 5) * factor), static_cast<long long>((position + 4) * factor),
+        static_cast<long long>((position + 3) * factor), static_cast<long long>((position + 2) * factor),
+        static_cast<long long>((position + 1) * factor), static_cast<long long>(position * factor));
+    __m512i changed = _mm512_setzero_si512();
+    __m512i hash = _mm512_setzero_si512();
+
+    int k = 0;
+    for (; k + 8 <= count; k += 8) {
+        __m512i b = _mm512_loadu_si512(before + k);
+        __m512i a = _mm512_loadu_si512(after + k);
+        changed = _mm512_add_epi64(changed, _mm512_popcnt_epi64(_mm512_xor_si512(a, b)));
+
+        __m512i x = _mm512_xor_si512(a, weights);
+        __m512i h = _mm512_add_epi64(_mm512_mul_epu32(x, lowMul), _mm512_mul_epu32(_mm512_srli_epi64(x, 32), highMul));
+        hash = _mm512_add_epi64(hash, _mm512_xor_si512(h, _mm512_srli_epi64(h, 29)));
+        weights = _mm512_add_epi64(weights, stride);
+    }
+    alignas(64) uint64_t changedLanes[8], hashLanes[8];
+    _mm512_store_si512(changedLanes, changed);
+    _mm512_store_si512(hashLanes, hash);
+    for (int i = 0; i < 8; ++i) {
+        stats.changed += changedLanes[i];
+        stats.hash += hashLanes[i];
+    }
+    statsPopcnt(before + k, after + k, count - k, position + k, stats);
+}
+
+#endif // GOL_X86_SIMD
+
+static bool cpuSupports(SimdLevel level) {
+#ifdef GOL_X86_SIMD
+    switch (level) {
+        case SimdLevel::AVX512: return __builtin_cpu_supports("avx512f");
+        case SimdLevel::AVX2:   return __builtin_cpu_supports("avx2");
+        case SimdLevel::SSE42:  return __builtin_cpu_supports("sse4.2");
+        case SimdLevel::Portable: return true;
+    }
+    return false;
+#else
+    return level == SimdLevel::Portable;
+#endif
+}
+
+static StatsKernel statsKernelFor(SimdLevel level) {
+#ifdef GOL_X86_SIMD
+    // Die Zählung braucht zusätzlich VPOPCNTDQ bzw. POPCNT, die nicht zu jeder Stufe gehören.
+    if (level == SimdLevel::AVX512 && __builtin_cpu_supports("avx512vpopcntdq")) {
+        return statsAvx512;
+    }
+    if (level != SimdLevel::Portable && __builtin_cpu_supports("popcnt")) {
+        return statsPopcnt;
+    }
+#endif
+    (void)level;
+    return statsPortable;
+}
+
+SimdLevel detectSimdLevel() {
+    // Die breiteste unterstützte Stufe gewinnt, so bekommt jeder Knoten aus derselben Binärdatei den passenden Kernel.
+    const SimdLevel order[] = { SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE42 };
+    for (SimdLevel level : order) {
+        if (cpuSupports(level)) {
+            return level;
+        }
+    }
+    return SimdLevel::Portable;
+}
+
+// Aktuell gewählte Stufe und der zugehörige Kernel; werden beim ersten Zugriff per CPUID bestimmt.
+static SimdLevel &currentLevel() {
+    static SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+// Zeilenkernel aller Regelauswertungen für eine SIMD-Stufe: Index 0 ist MaskedRule für Regeln ohne
+// eigene Kernel, Index i + 1 die vorübersetzte Regel rulePresets[i].
+struct RowKernelTable {
+    RowKernel kernels[RULE_PRESET_COUNT + 1];
+};
+
+static RowKernelTable rowKernelsFor(SimdLevel level) {
+    RowKernelTable table;
+    RowKernelFor select{level};
+    table.kernels[0] = select(MaskedRule(Rule()));
+    for (int i = 0; i < RULE_PRESET_COUNT; ++i) {
+        table.kernels[i + 1] = visitRule(Rule(rulePresets[i].birth, rulePresets[i].survival), select);
+    }
+    return table;
+}
+
+static RowKernelTable &currentRowKernels() {
+    static RowKernelTable table = rowKernelsFor(currentLevel());
+    return table;
+}
+
+static StatsKernel &currentStatsKernel() {
+    static StatsKernel kernel = statsKernelFor(currentLevel());
+    return kernel;
+}
+
+SimdLevel activeSimdLevel() {
+    return currentLevel();
+}
+
+bool setSimdLevel(SimdLevel level) {
+    if (!cpuSupports(level)) {
+        return false;
+    }
+    currentLevel() = level;
+    currentRowKernels() = rowKernelsFor(level);
+    currentStatsKernel() = statsKernelFor(level);
+    return true;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512: return "AVX-512";
+        case SimdLevel::AVX2:   return "AVX2";
+        case SimdLevel::SSE42:  return "SSE4.2";
+        case SimdLevel::Portable: return "portable";
+    }
+    return "unknown";
+}
+
+// Liest 64 Zellen ab Spalte col (0 <= col < width) einer Zeile; hinter der letzten Spalte geht es
+// toroidal bei Spalte 0 weiter. Bei schmalen Gittern wird dabei auch mehrfach umgebrochen.
+uint64_t wrappedWord(const uint64_t* row, int width, int col) {
+    if ((col & 63) == 0 && col + 64 <= width) {
+        return row[col >> 6];  // häufigster Fall: ausgerichtetes Wort innerhalb der Zeile
+    }
+
+    uint64_t bits = 0;
+    int filled = 0;
+    while (filled < 64) {
+        int take = width - col < 64 - filled ? width - col : 64 - filled;
+        int word = col >> 6;
+        int offset = col & 63;
+        uint64_t chunk = row[word] >> offset;
+        if (offset != 0 && offset + take > 64) {
+            chunk |= row[word + 1] << (64 - offset);
+        }
+        if (take < 64) {
+            chunk &= (1ULL << take) - 1;
+        }
+        bits |= chunk << filled;
+        filled += take;
+        col = 0;
+    }
+    return bits;
+}
+
+void evolveRowRange(const uint64_t* up, const uint64_t* mid, const uint64_t* down, uint64_t* out, int n, int width,
+                    int begin, int end, const Rule &rule) {
+    currentRowKernels().kernels[rule.presetIndex() + 1](rule, up, mid, down, out, n, width, begin, end);
+}
+
+void evolveRow(const uint64_t* up, const uint64_t* mid, const uint64_t* down, uint64_t* out, int n, int width,
+               const Rule &rule) {
+    evolveRowRange(up, mid, down, out, n, width, 0, n, rule);
+}
+
+void accumulateWords(const uint64_t* before, const uint64_t* after, int count, uint64_t position, StepStats &stats) {
+    currentStatsKernel()(before, after, count, position, stats);
+}
+
+void evolveRows(const BitGrid &src, BitGrid &dst, int rowBegin, int rowEnd, const Rule &rule, StepStats *stats) {
+    int height = src.getHeight();
+    int width = src.getWidth();
+    int n = src.getWordsPerRow();
+
+    StepStats local;
+    for (int x = rowBegin; x < rowEnd; ++x) {
+        // Die Zeilen darüber und darunter werden toroidal bestimmt.
+        const uint64_t* up = src.row((x - 1 + height) % height);
+        const uint64_t* mid = src.row(x);
+        const uint64_t* down = src.row((x + 1) % height);
+        uint64_t* out = dst.row(x);
+        evolveRow(up, mid, down, out, n, width, rule);
+        if (stats != nullptr) {
+            accumulateWords(mid, out, n, static_cast<uint64_t>(x) * n, local);
+        }
+    }
+    if (stats != nullptr) {
+        *stats += local;
+    }
+}
+
+void evolveGeneration(const BitGrid &src, BitGrid &dst, const Rule &rule, StepStats *stats) {
+    if (src.getHeight() == 0 || src.getWidth() == 0) {
+        return;
+    }
+    evolveRows(src, dst, 0, src.getHeight(), rule, stats);
+}
+
+void evolveRowsInPlace(BitGrid &grid, int rowBegin, int rowEnd, const uint64_t* above, const uint64_t* below,
+                       uint64_t* scratch, const Rule &rule, StepStats *stats) {
+    int width = grid.getWidth();
+    int n = grid.getWordsPerRow();
+    uint64_t* ring[2] = { scratch, scratch + n };  // ursprüngliche Zeilen x - 1 und x im Wechsel
+
+    StepStats local;
+    const uint64_t* up = above;
+    for (int x = rowBegin; x < rowEnd; ++x) {
+        // Zeile x wird vor dem Überschreiben gesichert; sie ist der obere Nachbar der nächsten Zeile.
+        // Zeile x + 1 ist noch unverändert, nur die letzte Zeile des Bandes braucht die Kopie below.
+        uint64_t* out = grid.row(x);
+        uint64_t* mid = ring[(x - rowBegin) & 1];
+        std::copy(out, out + n, mid);
+        const uint64_t* down = x + 1 < rowEnd ? grid.row(x + 1) : below;
+        evolveRow(up, mid, down, out, n, width, rule);
+        if (stats != nullptr) {
+            accumulateWords(mid, out, n, static_cast<uint64_t>(x) * n, local);
+        }
+        up = mid;
+    }
+    if (stats != nullptr) {
+        *stats += local;
+    }
+}
+
+void evolveGenerationInPlace(BitGrid &grid, const Rule &rule, StepStats *stats) {
+    int height = grid.getHeight();
+    int n = grid.getWordsPerRow();
+    if (height == 0 || n == 0) {
+        return;
+    }
+    // Für den Torus: die letzte Zeile über Zeile 0 und Zeile 0 unter der letzten, bevor sie überschrieben wird.
+    std::vector<uint64_t> rows(4 * static_cast<size_t>(n));
+    std::copy(grid.row(height - 1), grid.row(height - 1) + n, rows.begin());
+    std::copy(grid.row(0), grid.row(0) + n, rows.begin() + n);
+    evolveRowsInPlace(grid, 0, height, rows.data(), rows.data() + n, rows.data() + 2 * n, rule, stats);
+}
@@ -0,0 +1,265 @@
+#ifndef LIFEKERNELS_H
+#define LIFEKERNELS_H
+
+#include <cstdint>
+#include "BitGrid.h"
+#include "Rule.h"
+
+// Die Regelauswertung wird in die SIMD-Kernel (mit eigenem target-Attribut) eingefügt. Vektoren
+// werden dabei nur per Referenz übergeben: als Wert hinge die Aufrufkonvention vom Befehlssatz ab,
+// den die Vorlagen selbst nicht haben (GCC und Clang melden das als psabi-Warnung bzw. -Fehler).
+#define GOL_KERNEL_INLINE inline __attribute__((always_inline))
+
+// Wortparallele Summe der acht Nachbarn: die Nachbarzahl (0..8) von 64 Zellen auf einmal, mit
+// SIMD-Typen für V entsprechend mehr, als Bits ones, twos, fours, eights. Die Zweierstelle entsteht
+// aus den vier Bits u1, m1, d1, c0 mit dem Gewicht 2, zusammengefasst zu (p + q) + 2 * (pp + qq).
+template <typename V>
+struct NeighbourSum {
+    V ones, twos, fours, eights;
+    V p, q;    // u1 ^ m1, d1 ^ c0
+    V pp, qq;  // u1 & m1, d1 & c0
+
+    GOL_KERNEL_INLINE void setTwos(const V &u1, const V &m1, const V &d1, const V &c0) {
+        p = u1 ^ m1;
+        q = d1 ^ c0;
+        pp = u1 & m1;
+        qq = d1 & c0;
+        twos = p ^ q;
+        fours = pp ^ qq ^ (p & q);  // pp bzw. qq schließen p & q aus
+        eights = pp & qq;           // alle acht Nachbarn leben
+    }
+};
+
+// Die Nachbarn werden als neun Wörter übergeben (West, Mitte, Ost für die Zeile darüber,
+// die eigene Zeile und die Zeile darunter) und mit Halb- und Volladdierern bitweise summiert.
+template <typename V>
+GOL_KERNEL_INLINE void neighbourSum(const V &upW, const V &upC, const V &upE, const V &midW, const V &midE,
+                                    const V &downW, const V &downC, const V &downE, NeighbourSum<V> &sum) {
+    // Volladdierer für die drei Nachbarn der oberen Zeile (Summe 0..3 als Bits u1 u0).
+    V u0 = upW ^ upC ^ upE;
+    V u1 = (upW & upC) | (upE & (upW ^ upC));
+    // Halbaddierer für die zwei Nachbarn der eigenen Zeile (Summe 0..2 als Bits m1 m0).
+    V m0 = midW ^ midE;
+    V m1 = midW & midE;
+    // Volladdierer für die drei Nachbarn der unteren Zeile (Summe 0..3 als Bits d1 d0).
+    V d0 = downW ^ downC ^ downE;
+    V d1 = (downW & downC) | (downE & (downW ^ downC));
+
+    // Einerstelle der Gesamtsumme und Übertrag in die Zweierstelle.
+    sum.ones = u0 ^ m0 ^ d0;
+    V c0 = (u0 & m0) | (d0 & (u0 ^ m0));
+    sum.setTwos(u1, m1, d1, c0);
+}
+
+// Wertet eine Wahrheitstabelle mit Entries Einträgen über die Eingänge ones, twos, fours und mid
+// (Eintrag ones + 2 * twos + 4 * fours + 8 * mid) als Multiplexer-Baum aus. Die Tabelle ist ein
+// Vorlagenparameter: konstante Teilbäume und Eingänge, von denen die Tabelle nicht abhängt,
+// fallen schon bei der Übersetzung weg.
+template <uint32_t Table, int Entries>
+struct TruthTable {
+    static const uint32_t HALF_MASK = (1u << (Entries / 2)) - 1;
+    static const uint32_t LOW = Table & HALF_MASK;            // Eingang 0
+    static const uint32_t HIGH = (Table >> (Entries / 2)) & HALF_MASK;  // Eingang 1
+
+    template <typename V>
+    static GOL_KERNEL_INLINE const V &input(const NeighbourSum<V> &sum, const V &mid) {
+        return Entries == 16 ? mid : Entries == 8 ? sum.fours : Entries == 4 ? sum.twos : sum.ones;
+    }
+
+    template <typename V>
+    static GOL_KERNEL_INLINE void eval(const NeighbourSum<V> &sum, const V &mid, V &out) {
+        if (LOW == HIGH) {
+            TruthTable<LOW, Entries / 2>::eval(sum, mid, out);
+            return;
+        }
+        V high, low;
+        TruthTable<HIGH, Entries / 2>::eval(sum, mid, high);
+        TruthTable<LOW, Entries / 2>::eval(sum, mid, low);
+        const V &select = input(sum, mid);
+        out = (select & high) | (~select & low);
+    }
+};
+
+template <uint32_t Table>
+struct TruthTable<Table, 1> {
+    template <typename V>
+    static GOL_KERNEL_INLINE void eval(const NeighbourSum<V> &sum, const V &, V &out) {
+        out = sum.ones & ~sum.ones;  // 0
+        if (Table & 1) {
+            out = ~out;
+        }
+    }
+};
+
+// Regel als Vorlagenparameter: der Übersetzer reduziert die Auswertung auf die Terme dieser Regel,
+// im Kernel bleibt keine Tabelle und keine Verzweigung übrig.
+template <uint32_t Birth, uint32_t Survival>
+struct FixedRule {
+    FixedRule() {}
+    explicit FixedRule(const Rule &) {}
+
+    template <typename V>
+    GOL_KERNEL_INLINE void cells(const NeighbourSum<V> &sum, const V &mid, V &result) const {
+        if (Birth == 0x008 && Survival == 0x00C) {
+            // B3/S23: die Summe ist genau dann 2 oder 3, wenn von u1, m1, d1, c0 genau eines
+            // gesetzt ist; Geburt bei 3, Überleben bei 2 oder 3 Nachbarn.
+            result = (sum.p ^ sum.q) & ~(sum.pp | sum.qq) & (sum.ones | mid);
+            return;
+        }
+        // Nachbarzahlen 0..7 lebender und toter Zellen als Tabelle; bei 8 Nachbarn sind ones, twos und
+        // fours 0, die Tabelle liefert also den Wert für 0 Nachbarn, der bei Bedarf umgedreht wird.
+        TruthTable<(Birth & 0xFF) | ((Survival & 0xFF) << 8), 16>::eval(sum, mid, result);
+        const bool deadEights = ((Birth >> 8) ^ Birth) & 1;
+        const bool liveEights = ((Survival >> 8) ^ Survival) & 1;
+        if (deadEights && liveEights) {
+            result ^= sum.eights;
+        } else if (deadEights) {
+            result ^= sum.eights & ~mid;
+        } else if (liveEights) {
+            result ^= sum.eights & mid;
+        }
+    }
+};
+
+// Beliebige Regel ohne eigene Kernel: derselbe Multiplexer-Baum wie bei FixedRule, aber vollständig
+// und mit Blättern aus lauter Nullen oder Einsen, die pro Zeile einmal aus der Regel gebildet werden.
+// Das kostet einige Operationen mehr, aber ebenfalls keine Verzweigung und keinen Tabellenzugriff pro Zelle.
+struct MaskedRule {
+    long long leaves[16];  // Eintrag ones + 2 * twos + 4 * fours + 8 * mid: 0 oder ~0
+    long long deadEights;  // ~0, wenn 8 Nachbarn für tote Zellen anders wirken als 0
+    long long liveEights;  // dasselbe für lebende Zellen
+
+    explicit MaskedRule(const Rule &rule) {
+        uint32_t table = (rule.birthMask() & 0xFF) | ((rule.survivalMask() & 0xFF) << 8);
+        for (int i = 0; i < 16; ++i) {
+            leaves[i] = -static_cast<long long>((table >> i) & 1);
+        }
+        deadEights = -static_cast<long long>(((rule.birthMask() >> 8) ^ rule.birthMask()) & 1);
+        liveEights = -static_cast<long long>(((rule.survivalMask() >> 8) ^ rule.survivalMask()) & 1);
+    }
+
+    template <typename V>
+    GOL_KERNEL_INLINE void cells(const NeighbourSum<V> &sum, const V &mid, V &result) const {
+        V byOnes[8], byTwos[4], byFours[2];
+        for (int i = 0; i < 8; ++i) {
+            byOnes[i] = (sum.ones & leaves[2 * i + 1]) | (~sum.ones & leaves[2 * i]);
+        }
+        for (int i = 0; i < 4; ++i) {
+            byTwos[i] = (sum.twos & byOnes[2 * i + 1]) | (~sum.twos & byOnes[2 * i]);
+        }
+        for (int i = 0; i < 2; ++i) {
+            byFours[i] = (sum.fours & byTwos[2 * i + 1]) | (~sum.fours & byTwos[2 * i]);
+        }
+        result = (mid & byFours[1]) | (~mid & byFours[0]);
+        result ^= sum.eights & ((mid & liveEights) | (~mid & deadEights));
+    }
+};
+
+// Nächster Zustand von 64 Zellen (bzw. eines SIMD-Vektors) nach der Regel logic.
+template <class Logic, typename V>
+GOL_KERNEL_INLINE void ruleWord(const Logic &logic, const V &upW, const V &upC, const V &upE,
+                                const V &midW, const V &mid, const V &midE,
+                                const V &downW, const V &downC, const V &downE, V &result) {
+    NeighbourSum<V> sum;
+    neighbourSum(upW, upC, upE, midW, midE, downW, downC, downE, sum);
+    logic.cells(sum, mid, result);
+}
+
+// Dasselbe für einzelne Wörter mit Rückgabewert.
+template <class Logic>
+GOL_KERNEL_INLINE uint64_t ruleWord(const Logic &logic, uint64_t upW, uint64_t upC, uint64_t upE,
+                                    uint64_t midW, uint64_t mid, uint64_t midE,
+                                    uint64_t downW, uint64_t downC, uint64_t downE) {
+    uint64_t result;
+    ruleWord<Logic, uint64_t>(logic, upW, upC, upE, midW, mid, midE, downW, downC, downE, result);
+    return result;
+}
+
+// Ruft visitor(logic) mit der passenden Auswertung der Regel auf: FixedRule für vorübersetzte
+// Regeln, sonst MaskedRule. Die Regel wird so einmal pro Aufruf statt einmal pro Zelle unterschieden;
+// visitor instanziiert seinen Kernel für jede Auswertung.
+#define GOL_RULE_CASE(i) \
+    case i: return visitor(FixedRule<rulePresets[i].birth, rulePresets[i].survival>());
+
+template <typename Visitor>
+inline auto visitRule(const Rule &rule, Visitor &&visitor) -> decltype(visitor(MaskedRule(rule))) {
+    static_assert(RULE_PRESET_COUNT == 10, "visitRule() must list every preset");
+    switch (rule.presetIndex()) {
+        GOL_RULE_CASE(0) GOL_RULE_CASE(1) GOL_RULE_CASE(2) GOL_RULE_CASE(3) GOL_RULE_CASE(4)
+        GOL_RULE_CASE(5) GOL_RULE_CASE(6) GOL_RULE_CASE(7) GOL_RULE_CASE(8) GOL_RULE_CASE(9)
+        default: return visitor(MaskedRule(rule));
+    }
+}
+
+#undef GOL_RULE_CASE
+
+// Nebenprodukt eines Schritts: Anzahl der veränderten Zellen und ein 64-Bit-Hash des neuen Zustands.
+// Beide Werte sind Summen über die Wörter des Gitters und lassen sich daher für Bänder, Kacheln
+// oder Work-Groups einzeln berechnen und am Ende einfach addieren.
+struct StepStats {
+    uint64_t changed;
+    uint64_t hash;
+
+    StepStats() : changed(0), hash(0) {}
+    StepStats &operator+=(const StepStats &other) {
+        changed += other.changed;
+        hash += other.hash;
+        return *this;
+    }
+};
+
+// Beitrag eines Wortes zum Hash; position ist der Wortindex im Gitter (Zeile * Wörter pro Zeile + Wort).
+// Zwei 32x32-Bit-Multiplikationen mit anschließender Faltung genügen für die Erkennung von
+// Wiederholungen und lassen sich auch mit AVX-512F ohne 64-Bit-Multiplikation vektorisieren.
+inline uint64_t hashWord(uint64_t word, uint64_t position) {
+    uint64_t x = word ^ (position * 0x9E3779B97F4A7C15ULL);
+    uint64_t h = (x & 0xFFFFFFFFULL) * 0x85EBCA6BULL + (x >> 32) * 0xC2B2AE35ULL;
+    return h ^ (h >> 29);
+}
+
+// Ergänzt die Statistik um count Wörter einer gerade berechneten Zeile, solange sie noch im Cache liegt:
+// before und after sind die Wörter vor und nach dem Schritt, position der Gitterindex von after[0].
+// Nutzt wie die Zeilenkernel die beim Start gewählte SIMD-Stufe.
+void accumulateWords(const uint64_t* before, const uint64_t* after, int count, uint64_t position, StepStats &stats);
+
+// Befehlssatzstufen der handvektorisierten Kernel. Beim Start wird per CPUID die breiteste
+// Stufe gewählt, die der Prozessor unterstützt; Portable ist die wortweise Variante ohne SIMD.
+enum class SimdLevel { Portable, SSE42, AVX2, AVX512 };
+
+SimdLevel detectSimdLevel();
+SimdLevel activeSimdLevel();
+// Erzwingt eine Stufe (z.B. für Vergleiche); gibt false zurück, wenn die CPU sie nicht unterstützt.
+bool setSimdLevel(SimdLevel level);
+const char* simdLevelName(SimdLevel level);
+
+// Berechnet eine Zeile der nächsten Generation aus den drei Zeilen up, mid und down.
+// n ist die Anzahl der Wörter pro Zeile, width die Anzahl der Spalten; der Rand der Zeile
+// wird toroidal behandelt, auch wenn width kein Vielfaches von 64 ist.
+void evolveRow(const uint64_t* up, const uint64_t* mid, const uint64_t* down, uint64_t* out, int n, int width,
+               const Rule &rule);
+
+// Wie evolveRow(), berechnet aber nur die Wörter [begin, end) der Zeile (z.B. für Kacheln).
+void evolveRowRange(const uint64_t* up, const uint64_t* mid, const uint64_t* down, uint64_t* out, int n, int width,
+                    int begin, int end, const Rule &rule);
+
+// Liest 64 Zellen ab Spalte col (0 <= col < width) einer Zeile und setzt sie toroidal fort.
+uint64_t wrappedWord(const uint64_t* row, int width, int col);
+
+// Berechnet die Zeilen [rowBegin, rowEnd) der nächsten Generation von src in dst.
+// Mit stats werden veränderte Zellen und Hash im selben Durchlauf mitgezählt.
+void evolveRows(const BitGrid &src, BitGrid &dst, int rowBegin, int rowEnd, const Rule &rule, StepStats *stats = nullptr);
+
+// Berechnet die komplette nächste Generation von src in dst.
+void evolveGeneration(const BitGrid &src, BitGrid &dst, const Rule &rule, StepStats *stats = nullptr);
+
+// Berechnet die Zeilen [rowBegin, rowEnd) der nächsten Generation direkt in grid, ohne zweiten Puffer.
+// above und below sind Kopien der ursprünglichen Zeilen rowBegin - 1 und rowEnd (toroidal), die ein
+// anderes Band schon überschrieben haben kann. Die ursprüngliche Zeile über der aktuellen hält ein
+// Ring aus zwei Zeilen in scratch (2 * getWordsPerRow() Wörter).
+void evolveRowsInPlace(BitGrid &grid, int rowBegin, int rowEnd, const uint64_t* above, const uint64_t* below,
+                       uint64_t* scratch, const Rule &rule, StepStats *stats = nullptr);
+
+// Berechnet die komplette nächste Generation in grid; zusätzlich belegt werden nur vier Zeilen.
+void evolveGenerationInPlace(BitGrid &grid, const Rule &rule, StepStats *stats = nullptr);
+
+#endif // LIFEKERNELS_H
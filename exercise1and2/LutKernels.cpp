@@ -0,0 +1,112 @@
+#include "LutKernels.h"
+#include "LifeKernels.h"
+#include <vector>
+
+// Berechnet die Tabelle für alle 65536 Belegungen eines 4x4-Blocks.
+std::vector<uint8_t> buildLookupTable(const Rule &rule) {
+    std::vector<uint8_t> table(1 << 16);
+    for (int block = 0; block < (1 << 16); ++block) {
+        uint8_t result = 0;
+        for (int r = 1; r <= 2; ++r) {
+            for (int c = 1; c <= 2; ++c) {
+                int count = 0;
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        if (dr != 0 || dc != 0) {
+                            count += (block >> (4 * (r + dr) + c + dc)) & 1;
+                        }
+                    }
+                }
+                bool alive = (block >> (4 * r + c)) & 1;
+                if (rule.next(alive, count)) {
+                    result |= 1 << (2 * (r - 1) + (c - 1));
+                }
+            }
+        }
+        table[block] = result;
+    }
+    return table;
+}
+
+void evolveRowPairsLut(const BitGrid &src, BitGrid &dst, const uint8_t* table, int pairBegin, int pairEnd,
+                       StepStats *stats) {
+    int height = src.getHeight();
+    int width = src.getWidth();
+    int n = src.getWordsPerRow();
+    if (height == 0 || width == 0) {
+        return;
+    }
+    uint64_t tailMask = src.tailMask();
+
+    // Vier Hilfszeilen, um eine Spalte nach rechts verschoben: Bit j + 1 entspricht der Spalte j,
+    // Bit 0 der Spalte -1 (toroidal). Damit liegen die 4 Spalten eines Blocks immer an Bit 2p.
+    std::vector<uint64_t> shifted(4 * static_cast<size_t>(n + 1));
+    StepStats local;
+
+    for (int pair = pairBegin; pair < pairEnd; ++pair) {
+        int top = 2 * pair;
+        bool single = (top + 1 == height);  // ungerade Höhe: nur eine Ausgabezeile
+
+        for (int r = 0; r < 4; ++r) {
+            const uint64_t* line = src.row(((top - 1 + r) % height + height) % height);
+            uint64_t* out = &shifted[static_cast<size_t>(r) * (n + 1)];
+            int col = width - 1;
+            for (int k = 0; k <= n; ++k) {
+                out[k] = wrappedWord(line, width, col);
+                col = (col + 64) % width;
+            }
+        }
+        const uint64_t* r0 = &shifted[0];
+        const uint64_t* r1 = r0 + (n + 1);
+        const uint64_t* r2 = r1 + (n + 1);
+        const uint64_t* r3 = r2 + (n + 1);
+
+        uint64_t* outTop = dst.row(top);
+        uint64_t* outBottom = single ? nullptr : dst.row(top + 1);
+        for (int k = 0; k < n; ++k) {
+            uint64_t upper = 0, lower = 0;
+            // 32 Blöcke pro Wort; der letzte Block reicht zwei Bits in das nächste Hilfswort.
+            for (int p = 0; p < 32; ++p) {
+                int shift = 2 * p;
+                uint32_t index;
+                if (p < 31) {
+                    index = static_cast<uint32_t>((r0[k] >> shift) & 0xF)
+                          | static_cast<uint32_t>((r1[k] >> shift) & 0xF) << 4
+                          | static_cast<uint32_t>((r2[k] >> shift) & 0xF) << 8
+                          | static_cast<uint32_t>((r3[k] >> shift) & 0xF) << 12;
+                } else {
+                    index = static_cast<uint32_t>((r0[k] >> 62) | ((r0[k + 1] & 3) << 2))
+                          | static_cast<uint32_t>((r1[k] >> 62) | ((r1[k + 1] & 3) << 2)) << 4
+                          | static_cast<uint32_t>((r2[k] >> 62) | ((r2[k + 1] & 3) << 2)) << 8
+                          | static_cast<uint32_t>((r3[k] >> 62) | ((r3[k + 1] & 3) << 2)) << 12;
+                }
+                uint64_t cells = table[index];
+                upper |= (cells & 3) << shift;
+                lower |= (cells >> 2) << shift;
+            }
+            // Bits hinter der letzten Spalte bleiben immer 0.
+            if (k == n - 1) {
+                upper &= tailMask;
+                lower &= tailMask;
+            }
+            outTop[k] = upper;
+            if (outBottom != nullptr) {
+                outBottom[k] = lower;
+            }
+        }
+
+        if (stats != nullptr) {
+            accumulateWords(src.row(top), outTop, n, static_cast<uint64_t>(top) * n, local);
+            if (outBottom != nullptr) {
+                accumulateWords(src.row(top + 1), outBottom, n, static_cast<uint64_t>(top + 1) * n, local);
+            }
+        }
+    }
+    if (stats != nullptr) {
+        *stats += local;
+    }
+}
+
+void evolveGenerationLut(const BitGrid &src, BitGrid &dst, const uint8_t* table, StepStats *stats) {
+    evolveRowPairsLut(src, dst, table, 0, lutRowPairs(src.getHeight()), stats);
+}
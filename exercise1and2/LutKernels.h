@@ -0,0 +1,31 @@
+#ifndef LUTKERNELS_H
+#define LUTKERNELS_H
+
+#include <cstdint>
+#include <vector>
+#include "BitGrid.h"
+#include "LifeKernels.h"
+
+// Tabellengestützte Auswertung der Regeln: ein 4x4-Block von Zellen (16 Bit) wird über eine
+// Tabelle mit 65536 Einträgen direkt auf die 2x2 mittleren Zellen der nächsten Generation
+// abgebildet. Die Engine braucht keine SIMD-Befehle und dient als Vergleichsbasis für die
+// wortparallelen Kernel.
+
+// Tabelle 4x4 -> 2x2 für eine Regel. Index: Bit 4 * r + c ist die Zelle in Zeile r, Spalte c des Blocks.
+// Ergebnis: Bit 0/1 sind die Zellen (1,1)/(1,2), Bit 2/3 die Zellen (2,1)/(2,2).
+// Die Engine berechnet die Tabelle einmal und übergibt sie bei jedem Schritt.
+std::vector<uint8_t> buildLookupTable(const Rule &rule);
+
+// Anzahl der Zeilenpaare, in die evolveRowPairsLut() ein Gitter der Höhe height zerlegt.
+inline int lutRowPairs(int height) { return (height + 1) / 2; }
+
+// Berechnet die Zeilenpaare [pairBegin, pairEnd) (Zeilen 2p und 2p + 1) der nächsten Generation.
+// Bei ungerader Höhe besteht das letzte Paar nur aus einer Zeile. Mit stats werden veränderte
+// Zellen und Hash wie bei evolveRows() mitgezählt.
+void evolveRowPairsLut(const BitGrid &src, BitGrid &dst, const uint8_t* table, int pairBegin, int pairEnd,
+                       StepStats *stats = nullptr);
+
+// Berechnet die komplette nächste Generation von src in dst.
+void evolveGenerationLut(const BitGrid &src, BitGrid &dst, const uint8_t* table, StepStats *stats = nullptr);
+
+#endif // LUTKERNELS_H
@@ -0,0 +1,167 @@
+#include "DistributedGrid.h"
+#include "LifeKernels.h"
+#include <mpi.h>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+
+static void printUsage(const char* program) {
+    std::cout << "Usage: mpirun -np N " << program << " [options]\n"
+              << "  --size HxW           grid size (default: 4096x4096)\n"
+              << "  --weak               HxW is the block of one process (weak scaling)\n"
+              << "  --generations n      generations to compute (default: 100)\n"
+              << "  --halo k             halo depth = generations per exchange, 1..64 (default: 1)\n"
+              << "  --rule r             rule in B/S notation or by name (default: B3/S23 or the rule of --load)\n"
+              << "  --density d          initial live-cell fraction (default: 0.35)\n"
+              << "  --seed n             seed for the random start state (default: 42)\n"
+              << "  --threads n          CPU threads per process (default: 1)\n"
+              << "  --stop-when-stable   check for a still life after every exchange\n"
+              << "  --load file          start from a binary world file (parallel read)\n"
+              << "  --save file          write the result as a binary world file (parallel write)\n";
+}
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+    int rank = 0, processes = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &processes);
+
+    int height = 4096, width = 4096, generations = 100, halo = 1, threads = 1;
+    double density = 0.35;
+    uint64_t seed = 42;
+    bool weak = false, stopWhenStable = false, ruleGiven = false;
+    std::string loadPath, savePath;
+    Rule rule;
+
+    // Alle Prozesse lesen dieselben Argumente; Meldungen gibt nur Prozess 0 aus.
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--help" || option == "-h") {
+            if (rank == 0) {
+                printUsage(argv[0]);
+            }
+            MPI_Finalize();
+            return 0;
+        }
+        if (option == "--weak") {
+            weak = true;
+            continue;
+        }
+        if (option == "--stop-when-stable") {
+            stopWhenStable = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            if (rank == 0) {
+                std::cerr << "Error: missing value for " << option << std::endl;
+                printUsage(argv[0]);
+            }
+            MPI_Finalize();
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        bool ok = true;
+        if (option == "--size") {
+            char separator = 0;
+            std::istringstream parser(value);
+            ok = (parser >> height >> separator >> width) && separator == 'x' && height > 0 && width > 0;
+        } else if (option == "--generations") {
+            generations = std::atoi(value.c_str());
+        } else if (option == "--halo") {
+            halo = std::atoi(value.c_str());
+            ok = halo >= 1 && halo <= 64;
+        } else if (option == "--rule") {
+            ok = Rule::parse(value, rule);
+            ruleGiven = true;
+        } else if (option == "--density") {
+            density = std::atof(value.c_str());
+        } else if (option == "--seed") {
+            seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (option == "--threads") {
+            threads = std::atoi(value.c_str());
+        } else if (option == "--load") {
+            loadPath = value;
+        } else if (option == "--save") {
+            savePath = value;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            if (rank == 0) {
+                std::cerr << "Error: invalid option " << option << " " << value << std::endl;
+                printUsage(argv[0]);
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    int status = 0;
+    {
+        // Der Destruktor gibt den kartesischen Kommunikator frei und muss vor MPI_Finalize() laufen.
+        DistributedGrid grid(MPI_COMM_WORLD, halo, threads);
+        bool ready;
+        if (!loadPath.empty()) {
+            ready = grid.load(loadPath);
+            if (ruleGiven) {
+                grid.setRule(rule);  // eine ausdrücklich angegebene Regel ersetzt die der Datei
+            }
+        } else {
+            if (weak) {
+                // Schwache Skalierung: jeder Prozess behält einen Block der angegebenen Größe.
+                int layout[2] = {0, 0};
+                MPI_Dims_create(processes, 2, layout);
+                height *= layout[0];
+                width *= layout[1];
+            }
+            grid.setRule(rule);
+            ready = grid.setSize(height, width);
+            if (ready) {
+                grid.fillRandom(density, seed);
+            }
+        }
+
+        if (!ready) {
+            status = 1;
+        } else {
+            if (rank == 0) {
+                std::cout << "MPI: " << processes << " processes (" << grid.getProcessRows() << "x" << grid.getProcessCols()
+                          << " blocks), " << grid.getHeight() << "x" << grid.getWidth() << ", halo " << grid.getHalo()
+                          << ", " << grid.getRule().describe() << ", " << simdLevelName(activeSimdLevel()) << " kernel\n";
+            }
+
+            MPI_Barrier(MPI_COMM_WORLD);
+            double start = MPI_Wtime();
+            int done = 0;
+            bool stable = false;
+            while (done < generations && !stable) {
+                done += grid.step(generations - done, stopWhenStable);
+                if (stopWhenStable) {
+                    stable = grid.reduceStats().changed == 0;
+                }
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+            double seconds = MPI_Wtime() - start;
+
+            DistributedGrid::Stats stats = grid.reduceStats();
+            if (rank == 0) {
+                double cells = static_cast<double>(grid.getHeight()) * grid.getWidth() * done;
+                std::cout << std::fixed << std::setprecision(3)
+                          << "Generations: " << done << (stable ? " (stable)" : "") << ", time: " << seconds * 1e3
+                          << " ms, " << (seconds > 0 ? cells / seconds / 1e9 : 0) << " Gcells/s, population: "
+                          << stats.population << "\n";
+                // Eine Zeile im Format der Messreihen in exercise3/times.txt.
+                std::cout << "scaling: " << processes << " " << grid.getHeight() << " " << grid.getWidth() << " "
+                          << done << " " << static_cast<long long>(seconds * 1e3 + 0.5) << "\n";
+            }
+            if (!savePath.empty() && !grid.save(savePath)) {
+                status = 1;
+            }
+        }
+    }
+
+    MPI_Finalize();
+    return status;
+}
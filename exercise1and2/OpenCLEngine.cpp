@@ -0,0 +1,293 @@
+#include "OpenCLEngine.h"
+#include "Profiling.h"
+#include <iostream>
+#include <sstream>
+#include "utilities.hpp"
+
+OpenCLEngine::OpenCLEngine()
+    : current(0), height(0), width(0),
+      contextReady(false), programReady(false), buffersReady(false), tuningSet(false),
+      tuning{16, 8, 4} {}
+
+OpenCLEngine::Tuning OpenCLEngine::defaultTuning(const cl::Device &device) {
+    Tuning t;
+    if (device.getInfo<CL_DEVICE_TYPE>() & CL_DEVICE_TYPE_CPU) {
+        // CPU-Geräte: wenige Work-Items mit langen Streifen, die der Compiler vektorisieren kann.
+        t = {16, 4, 16};
+    } else {
+        // GPUs: viele Work-Items mit wenigen Zellen, damit alle Recheneinheiten ausgelastet sind.
+        t = {32, 8, 2};
+    }
+
+    // Die Gruppe darf nicht größer sein, als das Gerät erlaubt.
+    size_t maxGroup = device.getInfo<CL_DEVICE_MAX_WORK_GROUP_SIZE>();
+    while (maxGroup > 0 && static_cast<size_t>(t.localX) * t.localY > maxGroup && t.localY > 1) {
+        t.localY /= 2;
+    }
+    return t;
+}
+
+void OpenCLEngine::setTuning(const Tuning &t) {
+    tuning = t;
+    tuningSet = true;
+    programReady = false;  // die -D Optionen ändern sich, das Programm muss neu gebaut werden
+}
+
+void OpenCLEngine::setRule(const Rule &newRule) {
+    if (newRule != rule) {
+        rule = newRule;
+        programReady = false;
+    }
+}
+
+bool OpenCLEngine::buildProgram() {
+    GOL_PROFILE_SCOPE("opencl.build");
+    std::string kernel_code = util::loadProgram(kernelPath);  // Lade den OpenCL-Kernelcode aus einer Datei.
+    cl::Program::Sources sources;
+    sources.push_back({kernel_code.c_str(), kernel_code.length()});
+    program = cl::Program(context, sources);
+
+    // Die Kachelgröße wird zur Übersetzungszeit festgelegt, damit der lokale Speicher statisch ist.
+    std::ostringstream options;
+    options << "-D LOCAL_X=" << tuning.localX
+            << " -D LOCAL_Y=" << tuning.localY
+            << " -D CELLS_PER_ITEM=" << tuning.cellsPerItem
+            << " -D BIRTH_MASK=" << rule.birthMask()
+            << " -D SURVIVAL_MASK=" << rule.survivalMask();
+#ifdef GOL_OPENCL_DEBUG
+    options << " -D GOL_DEBUG";
+#endif
+
+    std::vector<cl::Device> devices{device};
+    if (program.build(devices, options.str().c_str()) != CL_SUCCESS) {
+        std::cerr << "Error building the kernel for device: "
+                  << device.getInfo<CL_DEVICE_NAME>() << std::endl;
+        std::cerr << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device) << std::endl;
+        return false;
+    }
+    kernel = cl::Kernel(program, "evolve");
+    programReady = true;
+    return true;
+}
+
+bool OpenCLEngine::initialize(const std::string &path, int h, int w) {
+    if (!contextReady) {
+        // Kontext und Warteschlange werden nur beim ersten Aufruf erzeugt.
+        GOL_PROFILE_SCOPE("opencl.context");
+        context = cl::Context(CL_DEVICE_TYPE_DEFAULT);
+        auto devices = context.getInfo<CL_CONTEXT_DEVICES>();
+        if (devices.empty()) {
+            std::cerr << "Error: no OpenCL device available." << std::endl;
+            return false;
+        }
+        device = devices[0];
+#ifdef GOL_PROFILING
+        queue = cl::CommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE);  // für die Zeitstempel der Ereignisse
+#else
+        queue = cl::CommandQueue(context, device);
+#endif
+        contextReady = true;
+    }
+
+    if (!tuningSet) {
+        tuning = defaultTuning(device);
+        tuningSet = true;
+    }
+
+    if (!programReady || path != kernelPath) {
+        kernelPath = path;
+        if (!buildProgram()) {
+            return false;
+        }
+        buffersReady = buffersReady && h == height && w == width;
+        if (buffersReady) {
+            // Neues Kernel-Objekt: die festen Argumente müssen neu gesetzt werden.
+            kernel.setArg(2, height);
+            kernel.setArg(3, width);
+#ifdef GOL_OPENCL_DEBUG
+            kernel.setArg(5, debugBuffer);
+#endif
+            // Die Kachelgröße kann sich geändert haben und damit die Anzahl der Gruppen.
+            resizeStats();
+        }
+    }
+
+    if (buffersReady && h == height && w == width) {
+        return true;  // Programm und Puffer passen bereits.
+    }
+
+    // Puffer für die neue Gittergröße anlegen.
+    GOL_PROFILE_SCOPE("opencl.buffers");
+    height = h;
+    width = w;
+    size_t cells = static_cast<size_t>(height) * width;
+    buffers[0] = cl::Buffer(context, CL_MEM_READ_WRITE, cells * sizeof(cl_uchar));
+    buffers[1] = cl::Buffer(context, CL_MEM_READ_WRITE, cells * sizeof(cl_uchar));
+    hostBuffer.resize(cells);
+    current = 0;
+
+    // Argumente, die sich zwischen den Generationen nicht ändern.
+    kernel.setArg(2, height);
+    kernel.setArg(3, width);
+#ifdef GOL_OPENCL_DEBUG
+    debugBuffer = cl::Buffer(context, CL_MEM_READ_WRITE, cells * 6 * sizeof(char));
+    kernel.setArg(5, debugBuffer);
+#endif
+    resizeStats();
+
+    buffersReady = true;
+    return true;
+}
+
+size_t OpenCLEngine::groupCount(size_t &groupsX, size_t &groupsY) const {
+    // Jede Gruppe berechnet eine Kachel von (localX * cellsPerItem) x localY Zellen.
+    size_t tileW = static_cast<size_t>(tuning.localX) * tuning.cellsPerItem;
+    size_t tileH = static_cast<size_t>(tuning.localY);
+    groupsX = (width + tileW - 1) / tileW;
+    groupsY = (height + tileH - 1) / tileH;
+    return groupsX * groupsY;
+}
+
+void OpenCLEngine::resizeStats() {
+    // Der Statistikpuffer hängt von Gittergröße und Kachelgröße ab.
+    size_t groupsX, groupsY;
+    size_t entries = 2 * groupCount(groupsX, groupsY);
+    if (entries == 0) {
+        entries = 2;
+    }
+    if (hostStats.size() != entries) {
+        statsBuffer = cl::Buffer(context, CL_MEM_READ_WRITE, entries * sizeof(cl_ulong));
+        hostStats.resize(entries);
+    }
+    kernel.setArg(4, statsBuffer);
+}
+
+bool OpenCLEngine::upload(const BitGrid &grid) {
+    // Lebende Zellen als 1, tote Zellen als 0 (ein Byte pro Zelle).
+    {
+        GOL_PROFILE_SCOPE("opencl.flatten");
+        for (int i = 0; i < height; ++i) {
+            for (int j = 0; j < width; ++j) {
+                hostBuffer[static_cast<size_t>(i) * width + j] = grid.get(i, j) ? 1 : 0;
+            }
+        }
+    }
+
+    GOL_PROFILE_SCOPE("opencl.upload");
+#ifdef GOL_PROFILING
+    cl::Event event;
+    cl_int err = queue.enqueueWriteBuffer(buffers[current], CL_TRUE, 0, hostBuffer.size() * sizeof(cl_uchar), hostBuffer.data(), nullptr, &event);
+    pendingEvents.push_back({"opencl.write.queued", "opencl.write.submitted", "opencl.write.executed", event});
+#else
+    cl_int err = queue.enqueueWriteBuffer(buffers[current], CL_TRUE, 0, hostBuffer.size() * sizeof(cl_uchar), hostBuffer.data());
+#endif
+    if (err != CL_SUCCESS) {
+        std::cerr << "Error writing buffer_current: " << err << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool OpenCLEngine::step() {
+    // Nur die Pufferargumente werden vertauscht, Programm und Puffer bleiben bestehen.
+    kernel.setArg(0, buffers[current]);
+    kernel.setArg(1, buffers[1 - current]);
+
+    size_t groupsX, groupsY;
+    groupCount(groupsX, groupsY);
+    cl::NDRange global(groupsX * tuning.localX, groupsY * tuning.localY);
+    cl::NDRange local(tuning.localX, tuning.localY);
+
+    GOL_PROFILE_SCOPE("opencl.enqueue");
+#ifdef GOL_PROFILING
+    cl::Event event;
+    cl_int err = queue.enqueueNDRangeKernel(kernel, cl::NullRange, global, local, nullptr, &event);
+    pendingEvents.push_back({"opencl.kernel.queued", "opencl.kernel.submitted", "opencl.kernel.executed", event});
+#else
+    cl_int err = queue.enqueueNDRangeKernel(kernel, cl::NullRange, global, local);
+#endif
+    if (err != CL_SUCCESS) {
+        std::cerr << "Error enqueueing kernel: " << err << std::endl;
+        return false;
+    }
+
+    // Die Warteschlange arbeitet in Reihenfolge, daher ist hier kein finish() nötig.
+    current = 1 - current;
+    return true;
+}
+
+bool OpenCLEngine::finish() {
+    cl_int err = queue.finish();
+    if (err != CL_SUCCESS) {
+        std::cerr << "Error finishing the command queue: " << err << std::endl;
+        return false;
+    }
+#ifdef GOL_PROFILING
+    collectEvents();
+#endif
+    return true;
+}
+
+#ifdef GOL_PROFILING
+void OpenCLEngine::collectEvents() {
+    // Die Zeitstempel des Geräts sind in Nanosekunden; ausgewertet werden nur abgeschlossene Befehle,
+    // der Aufrufer hat vorher blockierend gewartet.
+    for (PendingEvent &pending : pendingEvents) {
+        pending.event.wait();
+        cl_ulong queued = pending.event.getProfilingInfo<CL_PROFILING_COMMAND_QUEUED>();
+        cl_ulong submit = pending.event.getProfilingInfo<CL_PROFILING_COMMAND_SUBMIT>();
+        cl_ulong start = pending.event.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+        cl_ulong end = pending.event.getProfilingInfo<CL_PROFILING_COMMAND_END>();
+        GOL_PROFILE_RECORD(pending.queued, static_cast<long long>(submit - queued));
+        GOL_PROFILE_RECORD(pending.submitted, static_cast<long long>(start - submit));
+        GOL_PROFILE_RECORD(pending.executed, static_cast<long long>(end - start));
+    }
+    pendingEvents.clear();
+}
+#endif
+
+bool OpenCLEngine::download(BitGrid &grid) {
+    {
+        GOL_PROFILE_SCOPE("opencl.download");
+#ifdef GOL_PROFILING
+        cl::Event event;
+        cl_int err = queue.enqueueReadBuffer(buffers[current], CL_TRUE, 0, hostBuffer.size() * sizeof(cl_uchar), hostBuffer.data(), nullptr, &event);
+        pendingEvents.push_back({"opencl.read.queued", "opencl.read.submitted", "opencl.read.executed", event});
+        collectEvents();
+#else
+        cl_int err = queue.enqueueReadBuffer(buffers[current], CL_TRUE, 0, hostBuffer.size() * sizeof(cl_uchar), hostBuffer.data());
+#endif
+        if (err != CL_SUCCESS) {
+            std::cerr << "Error reading buffer_next: " << err << std::endl;
+            return false;
+        }
+    }
+
+    GOL_PROFILE_SCOPE("opencl.unflatten");
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            grid.set(i, j, hostBuffer[static_cast<size_t>(i) * width + j] != 0);
+        }
+    }
+    return true;
+}
+
+bool OpenCLEngine::readStats(StepStats &stats) {
+    // Blockierendes Lesen: die Warteschlange arbeitet in Reihenfolge, der letzte Kernel ist danach fertig.
+    GOL_PROFILE_SCOPE("opencl.readStats");
+    cl_int err = queue.enqueueReadBuffer(statsBuffer, CL_TRUE, 0, hostStats.size() * sizeof(cl_ulong), hostStats.data());
+    if (err != CL_SUCCESS) {
+        std::cerr << "Error reading stats buffer: " << err << std::endl;
+        return false;
+    }
+#ifdef GOL_PROFILING
+    collectEvents();
+#endif
+
+    stats = StepStats();
+    for (size_t i = 0; i + 1 < hostStats.size(); i += 2) {
+        stats.changed += hostStats[i];
+        stats.hash += hostStats[i + 1];
+    }
+    return true;
+}
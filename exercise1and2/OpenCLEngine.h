@@ -0,0 +1,97 @@
+#ifndef OPENCLENGINE_H
+#define OPENCLENGINE_H
+
+#include <string>
+#include <vector>
+#include "opencl.hpp"
+#include "BitGrid.h"
+#include "LifeKernels.h"
+
+// Zustandsbehaftete OpenCL-Engine: Kontext, Programm, Kernel, Befehlswarteschlange und die
+// beiden Generationspuffer werden nur einmal angelegt. Die Generationen bleiben zwischen den
+// Schritten auf dem Gerät; pro Schritt werden nur die Kernel-Argumente vertauscht (Ping-Pong).
+// Daten werden nur auf ausdrücklichen Wunsch (upload/download) zwischen Host und Gerät kopiert.
+class OpenCLEngine {
+    public:
+        // Abstimmbare Kernel-Parameter; werden als -D Optionen in das Programm übersetzt.
+        struct Tuning {
+            int localX;        // Work-Items pro Gruppe in Spaltenrichtung
+            int localY;        // Work-Items pro Gruppe in Zeilenrichtung (= Kachelhöhe)
+            int cellsPerItem;  // nebeneinanderliegende Zellen pro Work-Item
+        };
+
+    private:
+        cl::Context context;
+        cl::Device device;
+        cl::CommandQueue queue;
+        cl::Program program;
+        cl::Kernel kernel;
+        cl::Buffer buffers[2];   // Ping-Pong-Puffer für aktuelle und nächste Generation
+        cl::Buffer statsBuffer;  // zwei Werte pro Gruppe: veränderte Zellen und Hash-Anteil
+#ifdef GOL_OPENCL_DEBUG
+        cl::Buffer debugBuffer;  // nur mit GOL_OPENCL_DEBUG vorhanden
+#endif
+        int current;             // Index des Puffers mit der aktuellen Generation
+        int height, width;
+        bool contextReady;
+        bool programReady;
+        bool buffersReady;
+        bool tuningSet;
+        Tuning tuning;
+        Rule rule;
+        std::string kernelPath;
+        std::vector<cl_uchar> hostBuffer;  // wiederverwendeter Puffer für Upload und Download
+        std::vector<cl_ulong> hostStats;   // wiederverwendeter Puffer für readStats()
+#ifdef GOL_PROFILING
+        // Ereignisse eingereihter Befehle; ihre Zeitstempel werden nach dem nächsten blockierenden
+        // Aufruf ausgewertet, damit das Messen die Warteschlange nicht zusätzlich anhält.
+        struct PendingEvent {
+            const char* queued;     // eingereiht -> an das Gerät übergeben
+            const char* submitted;  // übergeben -> gestartet
+            const char* executed;   // gestartet -> fertig
+            cl::Event event;
+        };
+        std::vector<PendingEvent> pendingEvents;
+        void collectEvents();
+#endif
+
+        size_t groupCount(size_t &groupsX, size_t &groupsY) const;
+        void resizeStats();
+
+        bool buildProgram();
+
+    public:
+        OpenCLEngine();
+
+        // Standardwerte je Gerätetyp: CPU-Geräte (z.B. pocl) bekommen breite Streifen pro
+        // Work-Item, GPUs viele schmale Work-Items.
+        static Tuning defaultTuning(const cl::Device &device);
+
+        // Setzt die Kernel-Parameter; ein bereits gebautes Programm wird beim nächsten
+        // initialize() mit den neuen Werten neu gebaut.
+        void setTuning(const Tuning &t);
+        const Tuning &getTuning() const { return tuning; }
+
+        // Setzt die Regel; sie wird als -D Optionen übersetzt, ein Wechsel baut das Programm neu.
+        void setRule(const Rule &newRule);
+
+        // Baut das Programm aus path und legt die Puffer für ein h x w Gitter an.
+        // Wird bei gleicher Größe erneut aufgerufen, passiert nichts.
+        bool initialize(const std::string &path, int h, int w);
+        bool isReady() const { return programReady && buffersReady; }
+
+        // Kopiert eine Generation vom Host auf das Gerät.
+        bool upload(const BitGrid &grid);
+        // Berechnet eine Generation auf dem Gerät, ohne Daten zum Host zu übertragen.
+        bool step();
+        // Wartet, bis alle eingereihten Befehle auf dem Gerät abgeschlossen sind (z.B. für Zeitmessungen).
+        bool finish();
+        // Liest die aktuelle Generation vom Gerät in grid zurück.
+        bool download(BitGrid &grid);
+        // Liest veränderte Zellen und Hash des letzten step() zurück (wenige Bytes pro Gruppe statt
+        // des ganzen Gitters). Der Hash wird pro Zelle gebildet und ist daher nicht mit dem der
+        // CPU-Engines vergleichbar, wohl aber mit früheren Generationen derselben Engine.
+        bool readStats(StepStats &stats);
+};
+
+#endif // OPENCLENGINE_H
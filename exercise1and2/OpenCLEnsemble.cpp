@@ -0,0 +1,224 @@
+#include "OpenCLEnsemble.h"
+#include "Profiling.h"
+#include <iostream>
+#include <sstream>
+#include "utilities.hpp"
+
+OpenCLEnsemble::OpenCLEnsemble()
+    : current(0), rowCount(0), batchCount(0), worldCount(0), rowWords(0), sliceWords(0), ready(false) {}
+
+// Puffer der Länge 0 sind nicht erlaubt; leere Teile bekommen daher ein Element.
+static size_t bufferBytes(size_t count, size_t size) {
+    return (count > 0 ? count : 1) * size;
+}
+
+// Schreibt einen Vektor in einen Puffer; leere Vektoren werden übersprungen.
+template <class T>
+static bool writeVector(cl::CommandQueue &queue, const cl::Buffer &buffer, const std::vector<T> &values) {
+    return values.empty()
+        || queue.enqueueWriteBuffer(buffer, CL_FALSE, 0, values.size() * sizeof(T), values.data()) == CL_SUCCESS;
+}
+
+bool OpenCLEnsemble::initialize(const std::string &path, const Rule &newRule) {
+    if (ready && path == kernelPath && newRule == rule) {
+        return true;
+    }
+    GOL_PROFILE_SCOPE("opencl.ensemble.build");
+    context = cl::Context(CL_DEVICE_TYPE_DEFAULT);
+    auto devices = context.getInfo<CL_CONTEXT_DEVICES>();
+    if (devices.empty()) {
+        std::cerr << "Error: no OpenCL device available." << std::endl;
+        return false;
+    }
+    device = devices[0];
+    queue = cl::CommandQueue(context, device);
+
+    // Die Ensemble-Kernel stehen in derselben Datei wie der Kernel für einzelne Gitter.
+    std::string kernel_code = util::loadProgram(path);
+    cl::Program::Sources sources;
+    sources.push_back({kernel_code.c_str(), kernel_code.length()});
+    program = cl::Program(context, sources);
+    // Die Regel wird wie bei OpenCLEngine als Konstante in die Kernel übersetzt.
+    std::ostringstream options;
+    options << "-D BIRTH_MASK=" << newRule.birthMask() << " -D SURVIVAL_MASK=" << newRule.survivalMask();
+    std::vector<cl::Device> buildDevices{device};
+    if (program.build(buildDevices, options.str().c_str()) != CL_SUCCESS) {
+        std::cerr << "Error building the kernel for device: "
+                  << device.getInfo<CL_DEVICE_NAME>() << std::endl;
+        std::cerr << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device) << std::endl;
+        return false;
+    }
+    rowsKernel = cl::Kernel(program, "ensemble_rows");
+    slicesKernel = cl::Kernel(program, "ensemble_slices");
+    reduceKernel = cl::Kernel(program, "ensemble_reduce");
+    kernelPath = path;
+    rule = newRule;
+    ready = true;
+    return true;
+}
+
+bool OpenCLEnsemble::upload(const std::vector<uint64_t> &rows, const std::vector<uint64_t> &slices, const Layout &layout,
+                            const std::vector<cl_uchar> &stable, const std::vector<cl_long> &worldGenerations) {
+    GOL_PROFILE_SCOPE("opencl.ensemble.upload");
+    rowWords = rows.size();
+    sliceWords = slices.size();
+    rowCount = static_cast<cl_uint>(layout.rowWorld.size());
+    batchCount = static_cast<cl_uint>(layout.batchOffset.size());
+    worldCount = static_cast<cl_uint>(layout.worldBatch.size());
+    if (worldCount == 0) {
+        return true;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        rowBuffers[i] = cl::Buffer(context, CL_MEM_READ_WRITE, bufferBytes(rowWords, sizeof(cl_ulong)));
+        sliceBuffers[i] = cl::Buffer(context, CL_MEM_READ_WRITE, bufferBytes(sliceWords, sizeof(cl_ulong)));
+    }
+    rowWorld = cl::Buffer(context, CL_MEM_READ_ONLY, bufferBytes(rowCount, sizeof(cl_uint)));
+    batchOffset = cl::Buffer(context, CL_MEM_READ_ONLY, bufferBytes(batchCount, sizeof(cl_ulong)));
+    batchHeight = cl::Buffer(context, CL_MEM_READ_ONLY, bufferBytes(batchCount, sizeof(cl_int)));
+    batchWidth = cl::Buffer(context, CL_MEM_READ_ONLY, bufferBytes(batchCount, sizeof(cl_int)));
+    worldBatch = cl::Buffer(context, CL_MEM_READ_ONLY, worldCount * sizeof(cl_int));
+    worldLane = cl::Buffer(context, CL_MEM_READ_ONLY, worldCount * sizeof(cl_int));
+    worldFirstRow = cl::Buffer(context, CL_MEM_READ_ONLY, worldCount * sizeof(cl_uint));
+    worldHeight = cl::Buffer(context, CL_MEM_READ_ONLY, worldCount * sizeof(cl_int));
+    worldWidth = cl::Buffer(context, CL_MEM_READ_ONLY, worldCount * sizeof(cl_int));
+    worldOffset = cl::Buffer(context, CL_MEM_READ_ONLY, worldCount * sizeof(cl_ulong));
+    rowChanged = cl::Buffer(context, CL_MEM_READ_WRITE, bufferBytes(rowCount, sizeof(cl_uint)));
+    batchChanged = cl::Buffer(context, CL_MEM_READ_WRITE, bufferBytes(2 * static_cast<size_t>(batchCount), sizeof(cl_uint)));
+    status = cl::Buffer(context, CL_MEM_READ_WRITE, worldCount * sizeof(cl_uchar));
+    generations = cl::Buffer(context, CL_MEM_READ_WRITE, worldCount * sizeof(cl_long));
+    current = 0;
+
+    // Beide Zellpuffer bekommen den Startzustand, da stabile Welten nicht mehr geschrieben werden.
+    bool ok = writeVector(queue, rowBuffers[0], rows) && writeVector(queue, rowBuffers[1], rows)
+           && writeVector(queue, sliceBuffers[0], slices) && writeVector(queue, sliceBuffers[1], slices)
+           && writeVector(queue, rowWorld, layout.rowWorld)
+           && writeVector(queue, batchOffset, layout.batchOffset)
+           && writeVector(queue, batchHeight, layout.batchHeight)
+           && writeVector(queue, batchWidth, layout.batchWidth)
+           && writeVector(queue, worldBatch, layout.worldBatch)
+           && writeVector(queue, worldLane, layout.worldLane)
+           && writeVector(queue, worldFirstRow, layout.worldFirstRow)
+           && writeVector(queue, worldHeight, layout.worldHeight)
+           && writeVector(queue, worldWidth, layout.worldWidth)
+           && writeVector(queue, worldOffset, layout.worldOffset)
+           && writeVector(queue, status, stable)
+           && writeVector(queue, generations, worldGenerations)
+           && queue.finish() == CL_SUCCESS;
+    if (!ok) {
+        std::cerr << "Error uploading the ensemble" << std::endl;
+        return false;
+    }
+    return setArguments();
+}
+
+bool OpenCLEnsemble::setArguments() {
+    // Feste Argumente; nur die Zellpuffer werden pro Generation vertauscht.
+    rowsKernel.setArg(2, rowWorld);
+    rowsKernel.setArg(3, worldFirstRow);
+    rowsKernel.setArg(4, worldHeight);
+    rowsKernel.setArg(5, worldWidth);
+    rowsKernel.setArg(6, worldOffset);
+    rowsKernel.setArg(7, status);
+    rowsKernel.setArg(8, rowChanged);
+    rowsKernel.setArg(9, rowCount);
+
+    slicesKernel.setArg(2, batchOffset);
+    slicesKernel.setArg(3, batchHeight);
+    slicesKernel.setArg(4, batchWidth);
+    slicesKernel.setArg(5, batchCount);
+    slicesKernel.setArg(6, static_cast<cl_ulong>(sliceWords));
+    slicesKernel.setArg(7, batchChanged);
+
+    reduceKernel.setArg(0, rowChanged);
+    reduceKernel.setArg(1, batchChanged);
+    reduceKernel.setArg(2, worldBatch);
+    reduceKernel.setArg(3, worldLane);
+    reduceKernel.setArg(4, worldFirstRow);
+    reduceKernel.setArg(5, worldHeight);
+    reduceKernel.setArg(6, status);
+    reduceKernel.setArg(7, generations);
+    reduceKernel.setArg(8, worldCount);
+    return true;
+}
+
+int OpenCLEnsemble::run(int steps, int checkInterval) {
+    if (worldCount == 0) {
+        return 0;
+    }
+    const size_t groupSize = 64;
+    cl::NDRange rowRange((rowCount + groupSize - 1) / groupSize * groupSize);
+    cl::NDRange sliceRange((sliceWords + groupSize - 1) / groupSize * groupSize);
+    cl::NDRange worldRange((worldCount + groupSize - 1) / groupSize * groupSize);
+    cl::NDRange local(groupSize);
+    std::vector<cl_uchar> hostStatus(worldCount);
+
+    int done = 0;
+    while (done < steps) {
+        cl_int err = CL_SUCCESS;
+        if (rowCount > 0) {
+            rowsKernel.setArg(0, rowBuffers[current]);
+            rowsKernel.setArg(1, rowBuffers[1 - current]);
+            err = queue.enqueueNDRangeKernel(rowsKernel, cl::NullRange, rowRange, local);
+        }
+        if (err == CL_SUCCESS && batchCount > 0) {
+            slicesKernel.setArg(0, sliceBuffers[current]);
+            slicesKernel.setArg(1, sliceBuffers[1 - current]);
+            err = queue.enqueueFillBuffer(batchChanged, static_cast<cl_uint>(0), 0,
+                                          2 * static_cast<size_t>(batchCount) * sizeof(cl_uint));
+            if (err == CL_SUCCESS) {
+                err = queue.enqueueNDRangeKernel(slicesKernel, cl::NullRange, sliceRange, local);
+            }
+        }
+        if (err == CL_SUCCESS) {
+            err = queue.enqueueNDRangeKernel(reduceKernel, cl::NullRange, worldRange, local);
+        }
+        if (err != CL_SUCCESS) {
+            std::cerr << "Error enqueueing the ensemble kernels: " << err << std::endl;
+            return -1;
+        }
+        current = 1 - current;
+        ++done;
+
+        // Gelegentlich nachsehen, ob noch eine Welt läuft; dafür reicht ein Byte pro Welt.
+        if (checkInterval > 0 && done % checkInterval == 0 && done < steps) {
+            err = queue.enqueueReadBuffer(status, CL_TRUE, 0, worldCount * sizeof(cl_uchar), hostStatus.data());
+            if (err != CL_SUCCESS) {
+                std::cerr << "Error reading the ensemble status: " << err << std::endl;
+                return -1;
+            }
+            bool running = false;
+            for (cl_uchar s : hostStatus) {
+                running = running || s == 0;
+            }
+            if (!running) {
+                break;
+            }
+        }
+    }
+    return done;
+}
+
+bool OpenCLEnsemble::download(std::vector<uint64_t> &rows, std::vector<uint64_t> &slices, std::vector<cl_uchar> &stable,
+                              std::vector<cl_long> &worldGenerations) {
+    GOL_PROFILE_SCOPE("opencl.ensemble.download");
+    if (worldCount == 0) {
+        return true;
+    }
+    rows.resize(rowWords);
+    slices.resize(sliceWords);
+    stable.resize(worldCount);
+    worldGenerations.resize(worldCount);
+    bool ok = (rowWords == 0 || queue.enqueueReadBuffer(rowBuffers[current], CL_FALSE, 0, rowWords * sizeof(cl_ulong),
+                                                        rows.data()) == CL_SUCCESS)
+           && (sliceWords == 0 || queue.enqueueReadBuffer(sliceBuffers[current], CL_FALSE, 0, sliceWords * sizeof(cl_ulong),
+                                                          slices.data()) == CL_SUCCESS)
+           && queue.enqueueReadBuffer(status, CL_FALSE, 0, worldCount * sizeof(cl_uchar), stable.data()) == CL_SUCCESS
+           && queue.enqueueReadBuffer(generations, CL_FALSE, 0, worldCount * sizeof(cl_long), worldGenerations.data()) == CL_SUCCESS
+           && queue.finish() == CL_SUCCESS;
+    if (!ok) {
+        std::cerr << "Error reading the ensemble" << std::endl;
+        return false;
+    }
+    return true;
+}
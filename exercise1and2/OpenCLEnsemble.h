@@ -0,0 +1,73 @@
+#ifndef OPENCLENSEMBLE_H
+#define OPENCLENSEMBLE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "opencl.hpp"
+#include "Rule.h"
+
+// Geräteseite von Ensemble: Zeilen-Layout und Scheiben-Layout liegen je in einem Pufferpaar auf
+// dem Gerät. Ein Schritt besteht aus einer festen Anzahl von Kernel-Starts für alle Welten
+// zusammen: ensemble_rows berechnet jede Zeile der Zeilen-Welten (ein Work-Item pro Zeile),
+// ensemble_slices jedes Wort der verschränkten Gruppen (ein Work-Item pro Wort, also dieselbe
+// Zelle in bis zu 64 Welten), ensemble_reduce zählt pro Welt die Generation und setzt das
+// Stabilitätsflag.
+class OpenCLEnsemble {
+    public:
+        // Beschreibung der Welten, wie sie hochgeladen wird (ein Eintrag pro Zeile, Gruppe bzw. Welt).
+        struct Layout {
+            std::vector<cl_uint> rowWorld;        // Welt jeder Zeile über alle Zeilen-Welten
+            std::vector<cl_ulong> batchOffset;    // erstes Wort jeder Gruppe, aufsteigend
+            std::vector<cl_int> batchHeight, batchWidth;
+            std::vector<cl_int> worldBatch;       // Gruppe jeder Welt, -1 im Zeilen-Layout
+            std::vector<cl_int> worldLane;        // Bit der Welt in ihrer Gruppe
+            std::vector<cl_uint> worldFirstRow;   // erste Zeile jeder Zeilen-Welt
+            std::vector<cl_int> worldHeight, worldWidth;
+            std::vector<cl_ulong> worldOffset;    // erstes Wort jeder Zeilen-Welt
+        };
+
+    private:
+        cl::Context context;
+        cl::Device device;
+        cl::CommandQueue queue;
+        cl::Program program;
+        cl::Kernel rowsKernel, slicesKernel, reduceKernel;
+        cl::Buffer rowBuffers[2];    // Ping-Pong-Puffer des Zeilen-Layouts
+        cl::Buffer sliceBuffers[2];  // Ping-Pong-Puffer des Scheiben-Layouts
+        cl::Buffer rowWorld, worldFirstRow, worldHeight, worldWidth, worldOffset;
+        cl::Buffer batchOffset, batchHeight, batchWidth, worldBatch, worldLane;
+        cl::Buffer rowChanged;       // ein Flag pro Zeile
+        cl::Buffer batchChanged;     // veränderte Bits pro Gruppe als zwei uint
+        cl::Buffer status;           // ein Byte pro Welt: 1 = stabil
+        cl::Buffer generations;      // berechnete Generationen pro Welt
+        int current;
+        cl_uint rowCount, batchCount, worldCount;
+        size_t rowWords, sliceWords;
+        bool ready;
+        std::string kernelPath;
+        Rule rule;                   // Regel des gebauten Programms
+
+        bool setArguments();
+
+    public:
+        OpenCLEnsemble();
+
+        // Legt Kontext und Programm an (nur beim ersten Aufruf bzw. bei einem anderen Pfad oder
+        // einer anderen Regel; danach muss neu hochgeladen werden).
+        bool initialize(const std::string &path, const Rule &newRule);
+
+        // Lädt Zellen, Aufbau und Zustand aller Welten auf das Gerät.
+        bool upload(const std::vector<uint64_t> &rows, const std::vector<uint64_t> &slices, const Layout &layout,
+                    const std::vector<cl_uchar> &stable, const std::vector<cl_long> &worldGenerations);
+
+        // Rechnet bis zu 'steps' Generationen; alle checkInterval Generationen wird nachgesehen, ob
+        // noch eine Welt läuft. Gibt die Anzahl der gestarteten Generationen zurück (-1 bei einem Fehler).
+        int run(int steps, int checkInterval);
+
+        // Liest Zellen und Zustand aller Welten zurück.
+        bool download(std::vector<uint64_t> &rows, std::vector<uint64_t> &slices, std::vector<cl_uchar> &stable,
+                      std::vector<cl_long> &worldGenerations);
+};
+
+#endif // OPENCLENSEMBLE_H
@@ -0,0 +1,297 @@
+#include "PatternIO.h"
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <cstdio>
+#include <cctype>
+
+// Rechnet eine Koordinate toroidal in den Bereich [0, size) um.
+static int wrapCoordinate(long long value, int size) {
+    long long r = value % size;
+    return static_cast<int>(r < 0 ? r + size : r);
+}
+
+// Setzt 'length' lebende Zellen ab (row, col); Läufe über den rechten Rand gehen bei Spalte 0 weiter.
+static void setRun(BitGrid &grid, long long row, long long col, long long length) {
+    int width = grid.getWidth();
+    uint64_t* line = grid.row(wrapCoordinate(row, grid.getHeight()));
+    int c = wrapCoordinate(col, width);
+    if (length > width) {
+        length = width;  // ein Lauf über die ganze Breite füllt die Zeile bereits
+    }
+    while (length > 0) {
+        int end = static_cast<int>(std::min<long long>(width, c + length));
+        length -= end - c;
+        // Wortweise Masken statt einzelner Bits.
+        while (c < end) {
+            int k = c >> 6;
+            int first = c & 63;
+            int last = std::min(end - 64 * k, 64);
+            uint64_t mask = (last == 64 ? ~0ULL : ((1ULL << last) - 1)) & ~((1ULL << first) - 1);
+            line[k] |= mask;
+            c = 64 * k + last;
+        }
+        c = 0;
+    }
+}
+
+// Sucht ab Spalte from die nächste Zelle mit dem Zustand alive; width, wenn es keine mehr gibt.
+static int nextCell(const uint64_t* line, int width, int from, bool alive) {
+    int n = (width + 63) / 64;
+    int k = from >> 6;
+    if (k >= n) {
+        return width;
+    }
+    uint64_t word = (alive ? line[k] : ~line[k]) & (~0ULL << (from & 63));
+    while (word == 0) {
+        if (++k >= n) {
+            return width;
+        }
+        word = alive ? line[k] : ~line[k];
+    }
+    int col = 64 * k + __builtin_ctzll(word);
+    return col < width ? col : width;
+}
+
+PatternIO::Format PatternIO::formatFromFilename(const std::string &filename) {
+    auto endsWith = [&](const std::string &suffix) {
+        if (filename.size() < suffix.size()) {
+            return false;
+        }
+        return std::equal(suffix.rbegin(), suffix.rend(), filename.rbegin(),
+                          [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+    };
+    if (endsWith(".rle")) {
+        return Format::RLE;
+    }
+    if (endsWith(".cells")) {
+        return Format::Cells;
+    }
+    return Format::Unknown;
+}
+
+// Liest Kommentarzeilen bis zur Kopfzeile "x = m, y = n, rule = ..." und wertet diese aus.
+static bool readRleHeader(std::istream &in, int &rows, int &cols, Rule &rule) {
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;  // Leer- und Kommentarzeilen
+        }
+        if (std::sscanf(line.c_str() + start, "x = %d , y = %d", &cols, &rows) != 2 || rows < 0 || cols < 0) {
+            std::cerr << "Error: invalid RLE header: " << line << std::endl;
+            return false;
+        }
+
+        // Die Regel ist optional; Rule::parse() versteht B/S- und S/B-Schreibweise sowie Namen.
+        // Eine Topologie hinter ':' (z.B. ":T64,64") entfällt, gerechnet wird immer auf dem Torus.
+        size_t key = line.find("rule");
+        size_t equals = key != std::string::npos ? line.find('=', key) : std::string::npos;
+        if (equals != std::string::npos) {
+            std::string value;
+            for (size_t i = equals + 1; i < line.size() && line[i] != ',' && line[i] != ':'; ++i) {
+                if (!std::isspace(static_cast<unsigned char>(line[i]))) {
+                    value += line[i];
+                }
+            }
+            if (!Rule::parse(value, rule)) {
+                std::cerr << "Error: unsupported pattern rule " << value << "." << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+    std::cerr << "Error: RLE header missing." << std::endl;
+    return false;
+}
+
+bool PatternIO::readSize(std::istream &in, Format format, int &rows, int &cols, Rule &rule) {
+    if (format == Format::RLE) {
+        return readRleHeader(in, rows, cols, rule);
+    }
+
+    // Plaintext hat keine Kopfzeile: Zeilen zählen und die längste Zeile merken.
+    std::streambuf* buffer = in.rdbuf();
+    rows = 0;
+    cols = 0;
+    int length = 0;
+    bool lineStart = true, comment = false;
+    for (int c = buffer->sbumpc(); c != std::char_traits<char>::eof(); c = buffer->sbumpc()) {
+        if (c == '\n') {
+            rows += comment ? 0 : 1;
+            lineStart = true;
+            comment = false;
+            length = 0;
+            continue;
+        }
+        if (lineStart && c == '!') {
+            comment = true;
+        }
+        lineStart = false;
+        if (!comment && c != '\r') {
+            cols = std::max(cols, ++length);
+        }
+    }
+    if (!lineStart && !comment) {
+        ++rows;  // letzte Zeile ohne Zeilenumbruch
+    }
+    return true;
+}
+
+bool PatternIO::readRle(std::istream &in, BitGrid &grid, int rowOffset, int colOffset, Rule &rule) {
+    int rows, cols;
+    if (!readRleHeader(in, rows, cols, rule)) {
+        return false;
+    }
+    if (grid.getHeight() == 0 || grid.getWidth() == 0) {
+        return true;
+    }
+
+    // Läufe werden direkt beim Lesen in das Gitter geschrieben.
+    std::streambuf* buffer = in.rdbuf();
+    long long row = 0, col = 0, count = 0;
+    for (int c = buffer->sbumpc(); c != std::char_traits<char>::eof(); c = buffer->sbumpc()) {
+        if (c >= '0' && c <= '9') {
+            count = count * 10 + (c - '0');
+            continue;
+        }
+        long long run = count > 0 ? count : 1;
+        if (c == 'b' || c == '.') {
+            col += run;
+        } else if (c == '$') {
+            row += run;
+            col = 0;
+        } else if (c == '!') {
+            return true;
+        } else if (std::isalpha(c)) {
+            // 'o' und die Buchstaben der Mehrzustandsvariante gelten als lebend.
+            setRun(grid, rowOffset + row, colOffset + col, run);
+            col += run;
+        } else if (c == '#') {
+            // Kommentar hinter den Daten: bis zum Zeilenende überspringen.
+            while (c != '\n' && c != std::char_traits<char>::eof()) {
+                c = buffer->sbumpc();
+            }
+        }
+        count = 0;  // Leerzeichen und Zeilenumbrüche zwischen den Läufen werden ignoriert
+    }
+    std::cerr << "Warning: RLE pattern not terminated by '!'." << std::endl;
+    return true;
+}
+
+bool PatternIO::readCells(std::istream &in, BitGrid &grid, int rowOffset, int colOffset) {
+    if (grid.getHeight() == 0 || grid.getWidth() == 0) {
+        return true;
+    }
+
+    std::streambuf* buffer = in.rdbuf();
+    long long row = 0, col = 0;
+    bool lineStart = true, comment = false;
+    for (int c = buffer->sbumpc(); c != std::char_traits<char>::eof(); c = buffer->sbumpc()) {
+        if (c == '\n') {
+            if (!comment) {
+                ++row;
+            }
+            col = 0;
+            lineStart = true;
+            comment = false;
+            continue;
+        }
+        if (lineStart && c == '!') {
+            comment = true;  // Zeilen mit '!' am Anfang enthalten Name und Beschreibung
+        }
+        lineStart = false;
+        if (comment || c == '\r') {
+            continue;
+        }
+        if (c == 'O' || c == 'o' || c == '*') {
+            setRun(grid, rowOffset + row, colOffset + col, 1);
+        }
+        ++col;
+    }
+    return true;
+}
+
+// Schreibt die Läufe einer RLE-Datei und bricht die Zeilen nach höchstens 70 Zeichen um.
+class RleWriter {
+    private:
+        std::ostream &out;
+        int lineLength;
+
+    public:
+        explicit RleWriter(std::ostream &stream) : out(stream), lineLength(0) {}
+
+        void emit(long long count, char tag) {
+            int length = 1;
+            for (long long v = count; count > 1 && v > 0; v /= 10) {
+                ++length;
+            }
+            if (lineLength + length > 70) {
+                out.put('\n');
+                lineLength = 0;
+            }
+            if (count > 1) {
+                out << count;
+            }
+            out.put(tag);
+            lineLength += length;
+        }
+};
+
+bool PatternIO::writeRle(std::ostream &out, const BitGrid &grid, const Rule &rule) {
+    int height = grid.getHeight();
+    int width = grid.getWidth();
+    out << "x = " << width << ", y = " << height << ", rule = " << rule.toString() << "\n";
+
+    // Leere Zeilen und tote Zellen am Zeilenende werden nicht ausgegeben, sondern als '$' zusammengefasst.
+    RleWriter writer(out);
+    long long pendingRows = 0;
+    for (int x = 0; x < height; ++x) {
+        const uint64_t* line = grid.row(x);
+        int col = 0;
+        while (true) {
+            int start = nextCell(line, width, col, true);
+            if (start >= width) {
+                break;
+            }
+            int end = nextCell(line, width, start, false);
+            if (pendingRows > 0) {
+                writer.emit(pendingRows, '$');
+                pendingRows = 0;
+            }
+            if (start > col) {
+                writer.emit(start - col, 'b');
+            }
+            writer.emit(end - start, 'o');
+            col = end;
+        }
+        ++pendingRows;
+    }
+    writer.emit(1, '!');
+    out.put('\n');
+    return static_cast<bool>(out);
+}
+
+bool PatternIO::writeCells(std::ostream &out, const BitGrid &grid) {
+    int height = grid.getHeight();
+    int width = grid.getWidth();
+    out << "!Name: exported\n";
+
+    std::ostreambuf_iterator<char> sink(out);
+    for (int x = 0; x < height; ++x) {
+        const uint64_t* line = grid.row(x);
+        int col = 0;
+        while (true) {
+            int start = nextCell(line, width, col, true);
+            if (start >= width) {
+                break;  // tote Zellen am Zeilenende werden weggelassen
+            }
+            int end = nextCell(line, width, start, false);
+            sink = std::fill_n(sink, start - col, '.');
+            sink = std::fill_n(sink, end - start, 'O');
+            col = end;
+        }
+        out.put('\n');
+    }
+    return static_cast<bool>(out);
+}
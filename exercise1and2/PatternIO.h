@@ -0,0 +1,36 @@
+#ifndef PATTERNIO_H
+#define PATTERNIO_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include "BitGrid.h"
+#include "Rule.h"
+
+// Lesen und Schreiben der üblichen Musterformate RLE (*.rle) und Plaintext (*.cells).
+// Beide Richtungen arbeiten zeichenweise auf dem Stream: beim Lesen werden die Läufe direkt in
+// das Gitter geschrieben, beim Schreiben werden die Läufe wortweise gesucht und sofort ausgegeben.
+// Der Speicherbedarf hängt daher nicht von der Größe der Datei ab.
+class PatternIO {
+    public:
+        enum class Format { Unknown, RLE, Cells };
+
+        // Bestimmt das Format anhand der Dateiendung.
+        static Format formatFromFilename(const std::string &filename);
+
+        // Liest nur Größe und Regel des Musters (RLE: aus der Kopfzeile, Plaintext: durch einmaliges
+        // Durchlesen). Ohne Angabe in der Datei, also immer bei Plaintext, bleibt rule unverändert.
+        static bool readSize(std::istream &in, Format format, int &rows, int &cols, Rule &rule);
+
+        // Setzt die lebenden Zellen des Musters, verschoben um (rowOffset, colOffset), in das Gitter.
+        // Was über den Rand hinausragt, wird toroidal umgebrochen; tote Zellen des Musters lassen
+        // das Gitter unverändert. readRle() liefert in rule die Regel der Kopfzeile, falls angegeben.
+        static bool readRle(std::istream &in, BitGrid &grid, int rowOffset, int colOffset, Rule &rule);
+        static bool readCells(std::istream &in, BitGrid &grid, int rowOffset, int colOffset);
+
+        // Die Regel steht in der Kopfzeile; Plaintext kennt keine Regel.
+        static bool writeRle(std::ostream &out, const BitGrid &grid, const Rule &rule);
+        static bool writeCells(std::ostream &out, const BitGrid &grid);
+};
+
+#endif // PATTERNIO_H
@@ -0,0 +1,72 @@
+#include "Presenter.h"
+#include "TerminalRenderer.h"
+#include <chrono>
+
+FrameExchange::FrameExchange() : generations{0, 0, 0}, middle(1), back(0), front(2) {}
+
+void FrameExchange::reset(int height, int width) {
+    for (int i = 0; i < 3; ++i) {
+        frames[i].resize(height, width);
+        generations[i] = 0;
+    }
+    middle.store(1, std::memory_order_relaxed);
+    back = 0;
+    front = 2;
+}
+
+void FrameExchange::publish(const BitGrid &grid, long long generation) {
+    frames[back] = grid;  // gleiche Größe: nur Kopieren, kein Anlegen
+    generations[back] = generation;
+    // release: der Inhalt ist sichtbar, bevor der Verbraucher den Puffer bekommt.
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+bool FrameExchange::acquire() {
+    if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+        return false;
+    }
+    front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+    return true;
+}
+
+Presenter::Presenter(TerminalRenderer &target, FrameExchange &frames, int fps)
+    : renderer(target), exchange(frames), framesPerSecond(fps > 0 ? fps : 30), stopping(false), shown(0) {}
+
+Presenter::~Presenter() {
+    stop();
+}
+
+void Presenter::start() {
+    stopping.store(false, std::memory_order_relaxed);
+    thread = std::thread(&Presenter::loop, this);
+}
+
+void Presenter::stop() {
+    if (thread.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        thread.join();
+    }
+}
+
+void Presenter::loop() {
+    auto period = std::chrono::nanoseconds(1000000000LL / framesPerSecond);
+    auto next = std::chrono::steady_clock::now();
+    while (!stopping.load(std::memory_order_acquire)) {
+        if (exchange.acquire()) {
+            renderer.render(exchange.latest(), exchange.latestGeneration());
+            ++shown;
+        }
+        // Feste Taktung; ist ein Bild länger als eine Periode, wird nicht nachgeholt.
+        next += period;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+    // Die letzte Generation des Laufs wird immer gezeigt.
+    if (exchange.acquire()) {
+        renderer.render(exchange.latest(), exchange.latestGeneration());
+        ++shown;
+    }
+}
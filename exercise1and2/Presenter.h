@@ -0,0 +1,65 @@
+#ifndef PRESENTER_H
+#define PRESENTER_H
+
+#include <atomic>
+#include <thread>
+#include "BitGrid.h"
+
+class TerminalRenderer;
+
+// Dreifachpuffer für fertige Generationen zwischen Simulation (Erzeuger) und Ausgabe (Verbraucher),
+// ohne Sperren: Jede Seite besitzt einen Puffer, der dritte liegt in der Mitte. publish() tauscht
+// den geschriebenen Puffer atomar gegen die Mitte, acquire() die Mitte gegen den gelesenen Puffer.
+// Keine Seite wartet je auf die andere; liest die Ausgabe langsamer, werden Generationen übersprungen.
+class FrameExchange {
+    private:
+        static const int FRESH = 4;  // Bit im Mittelindex: ungelesene Generation liegt bereit
+
+        BitGrid frames[3];
+        long long generations[3];
+        std::atomic<int> middle;  // Index des mittleren Puffers, ggf. mit FRESH
+        int back;                 // gehört dem Erzeuger
+        int front;                // gehört dem Verbraucher
+
+    public:
+        FrameExchange();
+
+        // Legt die Puffer an; nur aufrufen, solange kein anderer Thread zugreift.
+        void reset(int height, int width);
+
+        // Erzeuger: true, wenn die zuletzt übergebene Generation bereits abgeholt wurde. Damit kann
+        // die Simulation das Kopieren (und bei Geräte-Engines das Zurücklesen) meistens auslassen.
+        bool wanted() const { return (middle.load(std::memory_order_acquire) & FRESH) == 0; }
+        void publish(const BitGrid &grid, long long generation);
+
+        // Verbraucher: holt die neueste Generation, false wenn seit dem letzten Aufruf keine kam.
+        bool acquire();
+        const BitGrid &latest() const { return frames[front]; }
+        long long latestGeneration() const { return generations[front]; }
+};
+
+// Gibt in einem eigenen Thread mit fester Bildrate die jeweils neueste Generation aus FrameExchange
+// aus. Die Simulation wartet so nie auf das Terminal, und die Ausgabe zeigt nicht mehr Bilder, als
+// ein Mensch sehen kann.
+class Presenter {
+    private:
+        TerminalRenderer &renderer;
+        FrameExchange &exchange;
+        int framesPerSecond;
+        std::atomic<bool> stopping;
+        long long shown;  // ausgegebene Bilder
+        std::thread thread;
+
+        void loop();
+
+    public:
+        Presenter(TerminalRenderer &renderer, FrameExchange &exchange, int framesPerSecond);
+        ~Presenter();
+
+        void start();
+        // Gibt die zuletzt übergebene Generation noch aus und beendet den Thread.
+        void stop();
+        long long framesShown() const { return shown; }
+};
+
+#endif // PRESENTER_H
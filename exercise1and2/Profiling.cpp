@@ -0,0 +1,202 @@
+#include "Profiling.h"
+
+#ifdef GOL_PROFILING
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+Profiler &Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Phase &Profiler::phase(const char* name) {
+    // Wenige Phasen: lineare Suche ist schneller als eine Hashtabelle und behält die Reihenfolge.
+    for (Phase &p : phases) {
+        if (p.name == name) {
+            return p;
+        }
+    }
+    phases.push_back({name, 0, 0, 0, 0, false, 0, 0, 0});
+    return phases.back();
+}
+
+void Profiler::record(const char* name, long long ns) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Phase &p = phase(name);
+    if (p.count == 0 || ns < p.minNs) {
+        p.minNs = ns;
+    }
+    if (ns > p.maxNs) {
+        p.maxNs = ns;
+    }
+    p.totalNs += ns;
+    ++p.count;
+}
+
+void Profiler::recordCounters(const char* name, uint64_t cycles, uint64_t instructions, uint64_t cacheMisses) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Phase &p = phase(name);
+    p.hasCounters = true;
+    p.cycles += cycles;
+    p.instructions += instructions;
+    p.cacheMisses += cacheMisses;
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    phases.clear();
+}
+
+void Profiler::writeSummary(std::ostream &out, const std::string &title) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    out << "\nProfile (" << title << "):\n"
+        << std::left << std::setw(24) << "phase" << std::right << std::setw(9) << "count"
+        << std::setw(13) << "total ms" << std::setw(12) << "mean us" << std::setw(12) << "min us"
+        << std::setw(12) << "max us" << "\n";
+    out << std::fixed << std::setprecision(3);
+    for (const Phase &p : phases) {
+        double mean = p.count > 0 ? static_cast<double>(p.totalNs) / p.count : 0;
+        out << std::left << std::setw(24) << p.name << std::right << std::setw(9) << p.count
+            << std::setw(13) << p.totalNs / 1e6 << std::setw(12) << mean / 1e3
+            << std::setw(12) << p.minNs / 1e3 << std::setw(12) << p.maxNs / 1e3 << "\n";
+        if (p.hasCounters) {
+            double ipc = p.cycles > 0 ? static_cast<double>(p.instructions) / p.cycles : 0;
+            out << "    " << p.cycles << " cycles, " << p.instructions << " instructions (IPC " << ipc
+                << "), " << p.cacheMisses << " LLC misses\n";
+        }
+    }
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+}
+
+bool Profiler::writeJson(std::ostream &out, const std::string &title) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    out << "{\n  \"title\": \"" << title << "\",\n  \"phases\": [";
+    for (size_t i = 0; i < phases.size(); ++i) {
+        const Phase &p = phases[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": \"" << p.name << "\", \"count\": " << p.count << ", \"totalNs\": " << p.totalNs
+            << ", \"minNs\": " << p.minNs << ", \"maxNs\": " << p.maxNs;
+        if (p.hasCounters) {
+            out << ", \"cycles\": " << p.cycles << ", \"instructions\": " << p.instructions
+                << ", \"llcMisses\": " << p.cacheMisses;
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+void Profiler::report(const std::string &title) {
+    writeSummary(std::cout, title);
+
+    const char* path = std::getenv("GOL_PROFILE_JSON");
+    if (path != nullptr && *path != '\0') {
+        std::ofstream file(path);
+        if (!file.is_open() || !writeJson(file, title)) {
+            std::cerr << "Error writing profile to " << path << std::endl;
+        }
+    }
+    reset();
+}
+
+#ifdef __linux__
+
+// Zählergruppe eines Threads: Takte als Gruppenführer, Befehle und LLC-Fehlzugriffe als Mitglieder.
+struct PerfGroup {
+    int fds[3];
+    bool available;
+
+    PerfGroup() : fds{-1, -1, -1}, available(false) {
+        const uint64_t configs[3] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES };
+        for (int i = 0; i < 3; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = i == 0 ? 1 : 0;  // die Gruppe wird über den Führer ein- und ausgeschaltet
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0));
+            if (fds[i] < 0) {
+                std::cerr << "Note: hardware counters unavailable (perf_event_open: " << std::strerror(errno) << ")\n";
+                close();
+                return;
+            }
+        }
+        available = true;
+    }
+
+    ~PerfGroup() { close(); }
+
+    void close() {
+        for (int &fd : fds) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        available = false;
+    }
+
+    void start() {
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    bool stop(uint64_t values[3]) {
+        ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t buffer[4];  // Anzahl der Zähler, dann die Werte
+        if (read(fds[0], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) || buffer[0] != 3) {
+            return false;
+        }
+        for (int i = 0; i < 3; ++i) {
+            values[i] = buffer[i + 1];
+        }
+        return true;
+    }
+};
+
+static PerfGroup &threadCounters() {
+    thread_local PerfGroup group;
+    return group;
+}
+
+ScopedCounters::ScopedCounters(const char* phaseName) : name(phaseName), timer(phaseName), active(false) {
+    PerfGroup &group = threadCounters();
+    if (group.available) {
+        group.start();
+        active = true;
+    }
+}
+
+ScopedCounters::~ScopedCounters() {
+    uint64_t values[3];
+    if (active && threadCounters().stop(values)) {
+        Profiler::instance().recordCounters(name, values[0], values[1], values[2]);
+    }
+}
+
+#else
+
+// Ohne perf_event_open wird nur die Zeit gemessen.
+ScopedCounters::ScopedCounters(const char* phaseName) : name(phaseName), timer(phaseName), active(false) {}
+ScopedCounters::~ScopedCounters() {}
+
+#endif // __linux__
+
+#endif // GOL_PROFILING
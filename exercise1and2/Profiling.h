@@ -0,0 +1,100 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+// Leichtgewichtige Messpunkte für einzelne Phasen der Läufe (Kontext, Übersetzen, Hochladen,
+// Kernel, Zurücklesen, Ausgabe, Warten, ...). Nur mit -DGOL_PROFILING vorhanden (make main-profile);
+// ohne das Makro werden alle GOL_PROFILE_*-Makros zu nichts und Profiling.cpp bleibt leer.
+//
+//   GOL_PROFILE_SCOPE("opencl.upload");     misst die Zeit bis zum Ende des Blocks
+//   GOL_PROFILE_COUNTERS("cpu.step");      zusätzlich Takte, Befehle und LLC-Fehlzugriffe (Linux)
+//   GOL_PROFILE_RECORD("opencl.kernel.exec", ns);  übernimmt eine anderswo gemessene Dauer
+//   GOL_PROFILE_REPORT("run");             gibt die Zusammenfassung aus und setzt sie zurück
+//
+// Liegt in der Umgebungsvariable GOL_PROFILE_JSON ein Dateiname, schreibt GOL_PROFILE_REPORT
+// die Zusammenfassung zusätzlich als JSON dorthin.
+
+#ifdef GOL_PROFILING
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <ostream>
+#include <cstdint>
+
+class Profiler {
+    public:
+        struct Phase {
+            std::string name;
+            long long count;
+            long long totalNs, minNs, maxNs;
+            // Hardware-Zähler; nur bei GOL_PROFILE_COUNTERS und wenn perf_event_open verfügbar ist.
+            bool hasCounters;
+            uint64_t cycles, instructions, cacheMisses;
+        };
+
+        static Profiler &instance();
+
+        void record(const char* name, long long ns);
+        void recordCounters(const char* name, uint64_t cycles, uint64_t instructions, uint64_t cacheMisses);
+        void reset();
+
+        void writeSummary(std::ostream &out, const std::string &title) const;
+        bool writeJson(std::ostream &out, const std::string &title) const;
+        // Zusammenfassung ausgeben, bei gesetztem GOL_PROFILE_JSON auch als Datei, danach zurücksetzen.
+        void report(const std::string &title);
+
+    private:
+        mutable std::mutex mutex;
+        std::vector<Phase> phases;  // in der Reihenfolge des ersten Auftretens
+
+        Phase &phase(const char* name);
+};
+
+// Misst die Zeit vom Anlegen bis zum Verlassen des Blocks.
+class ScopedTimer {
+    private:
+        const char* name;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit ScopedTimer(const char* phaseName)
+            : name(phaseName), start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            Profiler::instance().record(name, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+};
+
+// Zählt per perf_event_open Takte, Befehle und LLC-Fehlzugriffe des aufrufenden Threads im Block
+// (nur Benutzermodus, damit es auch mit perf_event_paranoid = 2 geht). Die Zähler werden einmal
+// pro Thread geöffnet und dann nur noch zurückgesetzt und gelesen. Arbeiter-Threads des Pools
+// werden nicht mitgezählt; für Vergleiche daher mit einem Thread messen.
+class ScopedCounters {
+    private:
+        const char* name;
+        ScopedTimer timer;
+        bool active;
+
+    public:
+        explicit ScopedCounters(const char* phaseName);
+        ~ScopedCounters();
+};
+
+#define GOL_PROFILE_CONCAT_(a, b) a##b
+#define GOL_PROFILE_CONCAT(a, b) GOL_PROFILE_CONCAT_(a, b)
+#define GOL_PROFILE_SCOPE(name) ScopedTimer GOL_PROFILE_CONCAT(golProfileScope, __LINE__)(name)
+#define GOL_PROFILE_COUNTERS(name) ScopedCounters GOL_PROFILE_CONCAT(golProfileCounters, __LINE__)(name)
+#define GOL_PROFILE_RECORD(name, ns) Profiler::instance().record(name, ns)
+#define GOL_PROFILE_REPORT(title) Profiler::instance().report(title)
+
+#else
+
+#define GOL_PROFILE_SCOPE(name) ((void)0)
+#define GOL_PROFILE_COUNTERS(name) ((void)0)
+#define GOL_PROFILE_RECORD(name, ns) ((void)0)
+#define GOL_PROFILE_REPORT(title) ((void)0)
+
+#endif // GOL_PROFILING
+
+#endif // PROFILING_H
@@ -0,0 +1,98 @@
+#include "Rule.h"
+#include <cctype>
+
+// Sucht die vorübersetzte Regel mit diesen Masken.
+static int findPreset(uint32_t birth, uint32_t survival) {
+    for (int i = 0; i < RULE_PRESET_COUNT; ++i) {
+        if (rulePresets[i].birth == birth && rulePresets[i].survival == survival) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+Rule::Rule() : birth(rulePresets[0].birth), survival(rulePresets[0].survival), preset(0) {}
+
+Rule::Rule(uint32_t birthMask, uint32_t survivalMask)
+    : birth(birthMask & 0x1FF), survival(survivalMask & 0x1FF), preset(findPreset(birth, survival)) {}
+
+// Liest die Ziffern 0..8 ab pos bis zum nächsten '/' oder zum Ende als Maske; false bei anderen Zeichen.
+static bool parseCounts(const std::string &text, size_t &pos, uint32_t &mask) {
+    mask = 0;
+    for (; pos < text.size() && text[pos] != '/'; ++pos) {
+        if (text[pos] < '0' || text[pos] > '8') {
+            return false;
+        }
+        mask |= 1u << (text[pos] - '0');
+    }
+    return true;
+}
+
+bool Rule::parse(const std::string &text, Rule &rule) {
+    std::string lower;
+    for (char c : text) {
+        if (c != ' ' && c != '-' && c != '&') {  // "Day & Night", "life-without-death"
+            lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    for (int i = 0; i < RULE_PRESET_COUNT; ++i) {
+        if (lower == rulePresets[i].name) {
+            rule = Rule(rulePresets[i].birth, rulePresets[i].survival);
+            return true;
+        }
+    }
+    if (lower == "life") {
+        rule = Rule();
+        return true;
+    }
+
+    size_t slash = lower.find('/');
+    if (slash == std::string::npos || lower.find('/', slash + 1) != std::string::npos) {
+        return false;
+    }
+    uint32_t first = 0, second = 0;
+    size_t pos = 0;
+    bool lettered = !lower.empty() && (lower[0] == 'b' || lower[0] == 's');
+    char firstLetter = lettered ? lower[pos++] : 0;
+    if (!parseCounts(lower, pos, first)) {
+        return false;
+    }
+    ++pos;  // '/'
+    if (lettered) {
+        // Der zweite Teil muss mit dem jeweils anderen Buchstaben beginnen.
+        if (pos >= lower.size() || (lower[pos] != 'b' && lower[pos] != 's') || lower[pos] == firstLetter) {
+            return false;
+        }
+        ++pos;
+    }
+    if (!parseCounts(lower, pos, second)) {
+        return false;
+    }
+
+    // Ohne Buchstaben gilt die klassische Form Überleben/Geburt.
+    rule = firstLetter == 'b' ? Rule(first, second) : Rule(second, first);
+    return true;
+}
+
+std::string Rule::toString() const {
+    std::string text = "B";
+    for (int n = 0; n <= 8; ++n) {
+        if (birth & (1u << n)) {
+            text += static_cast<char>('0' + n);
+        }
+    }
+    text += "/S";
+    for (int n = 0; n <= 8; ++n) {
+        if (survival & (1u << n)) {
+            text += static_cast<char>('0' + n);
+        }
+    }
+    return text;
+}
+
+std::string Rule::describe() const {
+    if (preset < 0) {
+        return toString();
+    }
+    return std::string(rulePresets[preset].name) + " (" + toString() + ")";
+}
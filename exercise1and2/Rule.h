@@ -0,0 +1,72 @@
+#ifndef RULE_H
+#define RULE_H
+
+#include <string>
+#include <cstdint>
+
+// Vorübersetzte Regeln: für jede gibt es eigene Kernel, in denen die Regel als Konstante steckt
+// (siehe FixedRule in LifeKernels.h). Bit n der Masken steht für n lebende Nachbarn.
+struct RulePreset {
+    const char* name;
+    uint32_t birth;
+    uint32_t survival;
+};
+
+static constexpr RulePreset rulePresets[] = {
+    { "conway",           0x008, 0x00C },  // B3/S23
+    { "highlife",         0x048, 0x00C },  // B36/S23
+    { "seeds",            0x004, 0x000 },  // B2/S
+    { "daynight",         0x1C8, 0x1D8 },  // B3678/S34678
+    { "lifewithoutdeath", 0x008, 0x1FF },  // B3/S012345678
+    { "maze",             0x008, 0x03E },  // B3/S12345
+    { "replicator",       0x0AA, 0x0AA },  // B1357/S1357
+    { "2x2",              0x048, 0x026 },  // B36/S125
+    { "morley",           0x148, 0x034 },  // B368/S245
+    { "anneal",           0x1D0, 0x1E8 },  // B4678/S35678
+};
+
+static const int RULE_PRESET_COUNT = sizeof(rulePresets) / sizeof(rulePresets[0]);
+
+// Regel eines Life-artigen (äußerlich totalistischen) Automaten: eine tote Zelle wird bei einer
+// Nachbarzahl aus der Geburtsmenge lebendig, eine lebende bleibt bei einer Zahl aus der
+// Überlebensmenge am Leben. Geschrieben wird die Regel in B/S-Notation, z.B. "B36/S23" (HighLife).
+// Die Kernel werten keine Tabelle pro Zelle aus: für vorübersetzte Regeln ist die Regel ein
+// Vorlagenparameter, alle anderen verwenden eine allgemeine bitparallele Auswertung der Masken.
+class Rule {
+    private:
+        uint32_t birth;     // Bit n: Geburt bei n Nachbarn (n = 0..8)
+        uint32_t survival;  // Bit n: Überleben bei n Nachbarn
+        int preset;         // Index in rulePresets, -1 = nicht vorübersetzt
+
+    public:
+        Rule();  // Conway, B3/S23
+        Rule(uint32_t birthMask, uint32_t survivalMask);
+
+        // Liest "B36/S23", "b3/s23", "S23/B3", die klassische Form "23/3" (Überleben/Geburt) oder den
+        // Namen einer vorübersetzten Regel ("highlife"); false bei ungültiger Eingabe.
+        static bool parse(const std::string &text, Rule &rule);
+
+        uint32_t birthMask() const { return birth; }
+        uint32_t survivalMask() const { return survival; }
+        int presetIndex() const { return preset; }
+        bool isPrecompiled() const { return preset >= 0; }
+        bool isConway() const { return preset == 0; }
+
+        // Ohne Geburt bei 0 Nachbarn bleibt leerer Raum leer (Voraussetzung für Hashlife).
+        bool keepsEmptySpaceEmpty() const { return (birth & 1u) == 0; }
+
+        // Nächster Zustand einer Zelle, ohne Verzweigung: Bit 9 * alive + count der beiden Masken.
+        bool next(bool alive, int count) const {
+            return ((birth | (survival << 9)) >> (count + 9 * static_cast<int>(alive))) & 1u;
+        }
+
+        // "B36/S23"
+        std::string toString() const;
+        // "highlife (B36/S23)" bzw. nur "B36/S23" für Regeln ohne Namen.
+        std::string describe() const;
+
+        bool operator==(const Rule &other) const { return birth == other.birth && survival == other.survival; }
+        bool operator!=(const Rule &other) const { return !(*this == other); }
+};
+
+#endif // RULE_H
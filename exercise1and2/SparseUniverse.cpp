@@ -0,0 +1,279 @@
+#include "SparseUniverse.h"
+#include "ThreadPool.h"
+#include <cstring>
+
+// Reihenfolge von Chunk::neighbours und die zugehörigen Verschiebungen (Zeile, Spalte).
+enum { NORTH, SOUTH, WEST, EAST, NORTH_WEST, NORTH_EAST, SOUTH_WEST, SOUTH_EAST };
+static const int NEIGHBOUR_OFFSETS[8][2] = {
+    {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
+};
+
+// Chunk, in dem die Koordinate v liegt (abgerundet, auch für negative Werte).
+static int32_t chunkIndex(long long v) {
+    const long long size = SparseUniverse::CHUNK;
+    return static_cast<int32_t>(v >= 0 ? v / size : -((-v + size - 1) / size));
+}
+
+SparseUniverse::SparseUniverse() : parity(0), generation(0) {}
+
+void SparseUniverse::clear() {
+    chunks.clear();
+    live.clear();
+    parity = 0;
+    generation = 0;
+}
+
+SparseUniverse::Chunk* SparseUniverse::find(int32_t chunkRow, int32_t chunkCol) const {
+    auto it = chunks.find(key(chunkRow, chunkCol));
+    return it == chunks.end() ? nullptr : it->second.get();
+}
+
+SparseUniverse::Chunk* SparseUniverse::acquire(int32_t chunkRow, int32_t chunkCol) {
+    std::unique_ptr<Chunk> &slot = chunks[key(chunkRow, chunkCol)];
+    if (!slot) {
+        // Neue Chunks sind in beiden Generationen leer.
+        slot.reset(new Chunk());
+        std::memset(slot.get(), 0, sizeof(Chunk));
+        slot->chunkRow = chunkRow;
+        slot->chunkCol = chunkCol;
+    }
+    return slot.get();
+}
+
+void SparseUniverse::setCell(long long row, long long col, bool state) {
+    int32_t chunkRow = chunkIndex(row), chunkCol = chunkIndex(col);
+    Chunk* chunk = state ? acquire(chunkRow, chunkCol) : find(chunkRow, chunkCol);
+    if (chunk == nullptr) {
+        return;  // tote Zelle in einem nicht angelegten Chunk
+    }
+    uint64_t &word = chunk->cells[parity][row - static_cast<long long>(chunkRow) * CHUNK];
+    uint64_t bit = 1ULL << (col - static_cast<long long>(chunkCol) * CHUNK);
+    word = state ? (word | bit) : (word & ~bit);
+}
+
+bool SparseUniverse::getCell(long long row, long long col) const {
+    int32_t chunkRow = chunkIndex(row), chunkCol = chunkIndex(col);
+    const Chunk* chunk = find(chunkRow, chunkCol);
+    if (chunk == nullptr) {
+        return false;
+    }
+    uint64_t word = chunk->cells[parity][row - static_cast<long long>(chunkRow) * CHUNK];
+    return (word >> (col - static_cast<long long>(chunkCol) * CHUNK)) & 1ULL;
+}
+
+void SparseUniverse::importGrid(const BitGrid &grid, long long row, long long col) {
+    // Jedes Wort des Gitters liegt in höchstens zwei horizontal benachbarten Chunks.
+    for (int x = 0; x < grid.getHeight(); ++x) {
+        const uint64_t* source = grid.row(x);
+        long long y = row + x;
+        int32_t chunkRow = chunkIndex(y);
+        int local = static_cast<int>(y - static_cast<long long>(chunkRow) * CHUNK);
+        for (int k = 0; k < grid.getWordsPerRow(); ++k) {
+            if (source[k] == 0) {
+                continue;
+            }
+            long long first = col + 64LL * k;
+            int32_t chunkCol = chunkIndex(first);
+            int shift = static_cast<int>(first - static_cast<long long>(chunkCol) * CHUNK);
+            acquire(chunkRow, chunkCol)->cells[parity][local] |= source[k] << shift;
+            if (shift > 0 && (source[k] >> (64 - shift)) != 0) {
+                acquire(chunkRow, chunkCol + 1)->cells[parity][local] |= source[k] >> (64 - shift);
+            }
+        }
+    }
+}
+
+void SparseUniverse::exportGrid(BitGrid &grid, long long row, long long col) const {
+    int n = grid.getWordsPerRow();
+    for (int x = 0; x < grid.getHeight(); ++x) {
+        uint64_t* target = grid.row(x);
+        long long y = row + x;
+        int32_t chunkRow = chunkIndex(y);
+        int local = static_cast<int>(y - static_cast<long long>(chunkRow) * CHUNK);
+        for (int k = 0; k < n; ++k) {
+            long long first = col + 64LL * k;
+            int32_t chunkCol = chunkIndex(first);
+            int shift = static_cast<int>(first - static_cast<long long>(chunkCol) * CHUNK);
+            const Chunk* left = find(chunkRow, chunkCol);
+            uint64_t word = left != nullptr ? left->cells[parity][local] >> shift : 0;
+            if (shift > 0) {
+                const Chunk* right = find(chunkRow, chunkCol + 1);
+                word |= right != nullptr ? right->cells[parity][local] << (64 - shift) : 0;
+            }
+            target[k] = word;
+        }
+        target[n - 1] &= grid.tailMask();
+    }
+}
+
+void SparseUniverse::expand() {
+    // Lebende Zellen am Rand eines Chunks wirken in den Nachbarchunk hinein; fehlende Nachbarn
+    // werden vor der Generation angelegt. Neue Chunks sind leer und brauchen selbst keine Nachbarn.
+    std::vector<std::pair<int32_t, int32_t>> missing;
+    for (const auto &entry : chunks) {
+        const Chunk &chunk = *entry.second;
+        const uint64_t* cells = chunk.cells[parity];
+        uint64_t west = 0, east = 0;
+        for (int r = 0; r < CHUNK; ++r) {
+            west |= cells[r] & 1ULL;
+            east |= cells[r] >> 63;
+        }
+        const bool edge[8] = {
+            cells[0] != 0, cells[CHUNK - 1] != 0, west != 0, east != 0,
+            (cells[0] & 1ULL) != 0, (cells[0] >> 63) != 0,
+            (cells[CHUNK - 1] & 1ULL) != 0, (cells[CHUNK - 1] >> 63) != 0
+        };
+        for (int d = 0; d < 8; ++d) {
+            int32_t chunkRow = chunk.chunkRow + NEIGHBOUR_OFFSETS[d][0];
+            int32_t chunkCol = chunk.chunkCol + NEIGHBOUR_OFFSETS[d][1];
+            if (edge[d] && find(chunkRow, chunkCol) == nullptr) {
+                missing.push_back({chunkRow, chunkCol});
+            }
+        }
+    }
+    for (const auto &position : missing) {
+        acquire(position.first, position.second);
+    }
+}
+
+template <class Logic>
+void SparseUniverse::evolveChunk(const Logic &logic, Chunk &chunk) const {
+    // Die 64 Zeilen des Chunks mit je einer Zeile darüber und darunter; center[i] ist Zeile i - 1.
+    // west und east enthalten die um eine Spalte verschobenen Zeilen samt dem Randbit der Nachbarn.
+    uint64_t center[CHUNK + 2], west[CHUNK + 2], east[CHUNK + 2];
+    auto rowOf = [this](const Chunk* c, int r) { return c != nullptr ? c->cells[parity][r] : 0; };
+    Chunk* const* nb = chunk.neighbours;
+    for (int i = 0; i < CHUNK + 2; ++i) {
+        uint64_t mid, left, right;
+        if (i == 0) {
+            mid = rowOf(nb[NORTH], CHUNK - 1);
+            left = rowOf(nb[NORTH_WEST], CHUNK - 1);
+            right = rowOf(nb[NORTH_EAST], CHUNK - 1);
+        } else if (i == CHUNK + 1) {
+            mid = rowOf(nb[SOUTH], 0);
+            left = rowOf(nb[SOUTH_WEST], 0);
+            right = rowOf(nb[SOUTH_EAST], 0);
+        } else {
+            mid = chunk.cells[parity][i - 1];
+            left = rowOf(nb[WEST], i - 1);
+            right = rowOf(nb[EAST], i - 1);
+        }
+        center[i] = mid;
+        west[i] = (mid << 1) | (left >> 63);
+        east[i] = (mid >> 1) | (right << 63);
+    }
+
+    const uint64_t* before = chunk.cells[parity];
+    uint64_t* after = chunk.cells[parity ^ 1];
+    uint64_t base = key(chunk.chunkRow, chunk.chunkCol) * CHUNK;
+    chunk.changed = 0;
+    chunk.population = 0;
+    chunk.hash = 0;
+    for (int r = 0; r < CHUNK; ++r) {
+        uint64_t word = ruleWord(logic, west[r], center[r], east[r], west[r + 1], center[r + 1], east[r + 1],
+                                 west[r + 2], center[r + 2], east[r + 2]);
+        after[r] = word;
+        chunk.changed += __builtin_popcountll(word ^ before[r]);
+        chunk.population += __builtin_popcountll(word);
+        chunk.hash += word != 0 ? hashWord(word, base + r) : 0;
+    }
+}
+
+StepStats SparseUniverse::step(ThreadPool *pool) {
+    expand();
+
+    // Arbeitsliste und Nachbarzeiger; während der Berechnung ändert sich die Tabelle nicht.
+    live.clear();
+    for (const auto &entry : chunks) {
+        Chunk* chunk = entry.second.get();
+        for (int d = 0; d < 8; ++d) {
+            chunk->neighbours[d] = find(chunk->chunkRow + NEIGHBOUR_OFFSETS[d][0], chunk->chunkCol + NEIGHBOUR_OFFSETS[d][1]);
+        }
+        live.push_back(chunk);
+    }
+
+    int total = static_cast<int>(live.size());
+    visitRule(rule, [&](const auto &logic) {
+        auto work = [&](int index) {
+            int parts = pool != nullptr ? pool->size() : 1;
+            std::pair<int, int> range = ThreadPool::band(total, parts, index);
+            for (int i = range.first; i < range.second; ++i) {
+                evolveChunk(logic, *live[i]);
+            }
+        };
+        if (pool != nullptr && pool->size() > 1 && total > 1) {
+            pool->run(work);
+        } else {
+            work(0);
+        }
+    });
+    parity ^= 1;
+    ++generation;
+
+    // Ergebnis einsammeln und leer gewordene Chunks freigeben.
+    StepStats stats;
+    for (auto it = chunks.begin(); it != chunks.end();) {
+        const Chunk &chunk = *it->second;
+        stats.changed += chunk.changed;
+        stats.hash += chunk.hash;
+        if (chunk.population == 0) {
+            it = chunks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    live.clear();
+    return stats;
+}
+
+void SparseUniverse::advance(long long generations, ThreadPool *pool) {
+    for (long long g = 0; g < generations; ++g) {
+        step(pool);
+    }
+}
+
+bool SparseUniverse::boundingBox(long long &top, long long &left, long long &bottom, long long &right) const {
+    bool found = false;
+    for (const auto &entry : chunks) {
+        const Chunk &chunk = *entry.second;
+        const uint64_t* cells = chunk.cells[parity];
+        int first = -1, last = -1;
+        uint64_t columns = 0;
+        for (int r = 0; r < CHUNK; ++r) {
+            if (cells[r] != 0) {
+                first = first < 0 ? r : first;
+                last = r;
+                columns |= cells[r];
+            }
+        }
+        if (first < 0) {
+            continue;
+        }
+        long long rowBase = static_cast<long long>(chunk.chunkRow) * CHUNK;
+        long long colBase = static_cast<long long>(chunk.chunkCol) * CHUNK;
+        long long chunkTop = rowBase + first, chunkBottom = rowBase + last;
+        long long chunkLeft = colBase + __builtin_ctzll(columns), chunkRight = colBase + 63 - __builtin_clzll(columns);
+        if (!found || chunkTop < top) top = chunkTop;
+        if (!found || chunkBottom > bottom) bottom = chunkBottom;
+        if (!found || chunkLeft < left) left = chunkLeft;
+        if (!found || chunkRight > right) right = chunkRight;
+        found = true;
+    }
+    return found;
+}
+
+uint64_t SparseUniverse::population() const {
+    uint64_t count = 0;
+    for (const auto &entry : chunks) {
+        for (int r = 0; r < CHUNK; ++r) {
+            count += __builtin_popcountll(entry.second->cells[parity][r]);
+        }
+    }
+    return count;
+}
+
+size_t SparseUniverse::memoryBytes() const {
+    // Pro Chunk der Chunk selbst und ein Tabelleneintrag (Schlüssel, Zeiger, Verkettung), dazu die Buckets.
+    size_t perChunk = sizeof(Chunk) + sizeof(uint64_t) + 2 * sizeof(void*);
+    return chunks.size() * perChunk + chunks.bucket_count() * sizeof(void*) + live.capacity() * sizeof(Chunk*);
+}
@@ -0,0 +1,84 @@
+#ifndef SPARSEUNIVERSE_H
+#define SPARSEUNIVERSE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include "BitGrid.h"
+#include "LifeKernels.h"
+
+class ThreadPool;
+
+// Unbegrenzte Ebene statt Torus: gespeichert werden nur Chunks aus 64 x 64 Zellen, die lebende
+// Zellen enthalten, in einer Hash-Tabelle mit den Chunk-Koordinaten als Schlüssel. Jede Zeile eines
+// Chunks ist genau ein Wort im Bitlayout von BitGrid (Bit j = Spalte j des Chunks).
+//
+// Vor jeder Generation wird für jeden Chunk mit lebenden Zellen am Rand der angrenzende Chunk
+// angelegt, falls er fehlt; nach der Generation werden leere Chunks freigegeben. Speicher und
+// Rechenzeit hängen so nur vom belebten Bereich ab, nicht von seiner umschließenden Box.
+// Fehlende Nachbarn gelten als tot, deshalb muss leerer Raum leer bleiben (siehe supports()).
+//
+// Koordinaten sind Zeile und Spalte auf der Ebene; Chunk-Koordinaten sind 32 Bit breit, nutzbar
+// ist also jede Richtung bis etwa 2^37 Zellen.
+class SparseUniverse {
+    public:
+        static const int CHUNK = 64;  // Kantenlänge eines Chunks in Zellen
+
+    private:
+        struct Chunk {
+            int32_t chunkRow, chunkCol;
+            uint64_t cells[2][CHUNK];  // aktuelle und nächste Generation, Auswahl über parity
+            Chunk* neighbours[8];      // vor jeder Generation gesetzt, nullptr = nicht angelegt (tot)
+            uint64_t changed;          // veränderte Zellen der letzten Generation
+            uint64_t population;       // lebende Zellen nach der letzten Generation
+            uint64_t hash;             // Beitrag zum Hash der Generation
+        };
+
+        std::unordered_map<uint64_t, std::unique_ptr<Chunk>> chunks;
+        std::vector<Chunk*> live;  // Arbeitsliste der aktuellen Generation
+        int parity;                // Index der aktuellen Generation in Chunk::cells
+        Rule rule;
+        long long generation;
+
+        static uint64_t key(int32_t chunkRow, int32_t chunkCol) {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(chunkRow)) << 32) | static_cast<uint32_t>(chunkCol);
+        }
+        Chunk* find(int32_t chunkRow, int32_t chunkCol) const;
+        Chunk* acquire(int32_t chunkRow, int32_t chunkCol);
+        void expand();
+        template <class Logic>
+        void evolveChunk(const Logic &logic, Chunk &chunk) const;
+
+    public:
+        SparseUniverse();
+
+        // Leerer Raum muss leer bleiben, sonst müsste die ganze Ebene lebendig werden.
+        static bool supports(const Rule &rule) { return rule.keepsEmptySpaceEmpty(); }
+        void setRule(const Rule &newRule) { rule = newRule; }
+
+        void clear();
+        void setCell(long long row, long long col, bool state);
+        bool getCell(long long row, long long col) const;
+
+        // Übernimmt die lebenden Zellen von grid mit der linken oberen Ecke an (row, col).
+        void importGrid(const BitGrid &grid, long long row = 0, long long col = 0);
+        // Schreibt den Ausschnitt der Größe von grid ab (row, col) in grid; Zellen außerhalb fallen weg.
+        void exportGrid(BitGrid &grid, long long row = 0, long long col = 0) const;
+
+        // Berechnet eine Generation; ohne Pool im aufrufenden Thread. Liefert die veränderten Zellen
+        // und einen Hash des neuen Zustands (abhängig von der Lage auf der Ebene).
+        StepStats step(ThreadPool *pool = nullptr);
+        void advance(long long generations, ThreadPool *pool = nullptr);
+
+        // Kleinstes Rechteck um alle lebenden Zellen (Grenzen einschließlich); false, wenn alles tot ist.
+        bool boundingBox(long long &top, long long &left, long long &bottom, long long &right) const;
+        uint64_t population() const;
+        size_t chunkCount() const { return chunks.size(); }
+        // Ungefährer Speicherbedarf der Chunks und der Tabelle in Byte.
+        size_t memoryBytes() const;
+        long long getGeneration() const { return generation; }
+};
+
+#endif // SPARSEUNIVERSE_H
@@ -0,0 +1,416 @@
+#include "StreamingEvolver.h"
+#include "BitGrid.h"
+#include "LifeKernels.h"
+#include "ThreadPool.h"
+#include "WorldFile.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+StreamingEvolver::StreamingEvolver(size_t memoryBytes, int threads)
+    : memoryBudget(memoryBytes), threadCount(threads), overrideRule(false), result() {}
+
+void StreamingEvolver::setRule(const Rule &newRule) {
+    rule = newRule;
+    overrideRule = true;
+}
+
+bool StreamingEvolver::evolve(const std::string &input, const std::string &output, long long generations) {
+    if (generations < 1) {
+        std::cerr << "Error: at least one generation is needed for streaming." << std::endl;
+        return false;
+    }
+    if (input == output) {
+        std::cerr << "Error: streaming needs different input and output files." << std::endl;
+        return false;
+    }
+
+    // Die Durchgänge wechseln zwischen output und einer temporären Datei; der letzte schreibt output.
+    std::string temporary = output + ".tmp";
+    std::string source = input;
+    for (long long pass = 0; pass < generations; ++pass) {
+        std::string target = (generations - 1 - pass) % 2 == 0 ? output : temporary;
+        if (!evolvePass(source, target)) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        source = target;
+    }
+    std::remove(temporary.c_str());
+    return true;
+}
+
+#ifdef _WIN32
+
+bool StreamingEvolver::evolvePass(const std::string &, const std::string &) {
+    std::cerr << "Error: streaming evolution needs mmap and is not available on this platform." << std::endl;
+    return false;
+}
+
+bool StreamingEvolver::createRandom(const std::string &, int, int, double, uint64_t, const Rule &, size_t) {
+    std::cerr << "Error: streaming evolution needs mmap and is not available on this platform." << std::endl;
+    return false;
+}
+
+#else
+
+// Schreibt vollständig ab offset; pwrite darf weniger als verlangt schreiben.
+static bool writeAll(int fd, const void* data, size_t bytes, off_t offset) {
+    const char* next = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = pwrite(fd, next, bytes, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error writing world file: " << strerror(errno) << std::endl;
+            return false;
+        }
+        next += written;
+        bytes -= static_cast<size_t>(written);
+        offset += written;
+    }
+    return true;
+}
+
+// Schreibt die Kopfseite und bringt die Datei auf ganze Seiten (Format wie WorldFile::save()).
+static bool writeHeader(int fd, int height, int width, const WorldFile::Info &info, uint64_t checksum) {
+    std::vector<char> page(WorldFile::PAGE_BYTES, 0);
+    WorldHeader header;
+    WorldFile::fillHeader(header, height, width, info);
+    header.checksum = checksum;
+    std::memcpy(page.data(), &header, sizeof(header));
+    return writeAll(fd, page.data(), page.size(), 0);
+}
+
+static int createWorldFile(const std::string &filename, uint64_t dataBytes) {
+    int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error creating " << filename << ": " << strerror(errno) << std::endl;
+        return -1;
+    }
+    uint64_t pages = (dataBytes + WorldFile::PAGE_BYTES - 1) / WorldFile::PAGE_BYTES;
+    if (ftruncate(fd, static_cast<off_t>((pages + 1) * WorldFile::PAGE_BYTES)) != 0) {
+        std::cerr << "Error sizing " << filename << ": " << strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Zeilen pro Band, wenn bands Bänder gleichzeitig in memoryBytes passen sollen.
+static int rowsPerBand(size_t memoryBytes, size_t rowBytes, int bands, int height) {
+    size_t rows = memoryBytes / (bands * rowBytes);
+    rows = rows < 1 ? 1 : rows;
+    return rows < static_cast<size_t>(height) ? static_cast<int>(rows) : height;
+}
+
+// Schreibt fertige Bänder in einem eigenen Thread der Reihe nach in die Datei.
+// Der Aufrufer füllt zwei Puffer im Wechsel und wartet vor dem Wiederverwenden eines Puffers mit
+// waitFree(), bis er geschrieben ist. Unter Linux wird das Zurückschreiben jedes Bandes sofort
+// angestoßen und das vorige Band danach aus dem Seitencache entfernt, damit sich keine schmutzigen
+// Seiten der ganzen Welt ansammeln.
+class BandWriter {
+    private:
+        struct Job {
+            const uint64_t* words;
+            size_t count;
+            off_t offset;
+            int slot;
+        };
+
+        int fd;
+        std::deque<Job> queue;
+        bool busy[2];
+        bool stopping;
+        bool failed;
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::thread worker;
+
+        void loop() {
+            off_t previousOffset = 0;
+            size_t previousBytes = 0;
+            while (true) {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [this] { return !queue.empty() || stopping; });
+                    if (queue.empty()) {
+                        return;
+                    }
+                    job = queue.front();
+                }
+                size_t bytes = job.count * sizeof(uint64_t);
+                bool ok = writeAll(fd, job.words, bytes, job.offset);
+#ifdef __linux__
+                sync_file_range(fd, job.offset, bytes, SYNC_FILE_RANGE_WRITE);
+                if (previousBytes > 0) {
+                    sync_file_range(fd, previousOffset, previousBytes,
+                                    SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+                    posix_fadvise(fd, previousOffset, previousBytes, POSIX_FADV_DONTNEED);
+                }
+#endif
+                previousOffset = job.offset;
+                previousBytes = bytes;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    queue.pop_front();
+                    busy[job.slot] = false;
+                    failed = failed || !ok;
+                }
+                changed.notify_all();
+            }
+        }
+
+    public:
+        explicit BandWriter(int file) : fd(file), busy{false, false}, stopping(false), failed(false) {
+            worker = std::thread(&BandWriter::loop, this);
+        }
+
+        ~BandWriter() { finish(); }
+
+        void waitFree(int slot) {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this, slot] { return !busy[slot]; });
+        }
+
+        void submit(int slot, const uint64_t* words, size_t count, off_t offset) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                busy[slot] = true;
+                queue.push_back({words, count, offset, slot});
+            }
+            changed.notify_all();
+        }
+
+        // Wartet auf alle Bänder; false, wenn ein Schreibzugriff fehlgeschlagen ist.
+        bool finish() {
+            if (worker.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                changed.notify_all();
+                worker.join();
+            }
+            return !failed;
+        }
+};
+
+bool StreamingEvolver::evolvePass(const std::string &input, const std::string &output) {
+    int in = open(input.c_str(), O_RDONLY);
+    if (in < 0) {
+        std::cerr << "Error opening " << input << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat status;
+    WorldHeader header;
+    if (fstat(in, &status) != 0 || static_cast<uint64_t>(status.st_size) < sizeof(header) ||
+        pread(in, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        !WorldFile::validHeader(header, static_cast<uint64_t>(status.st_size))) {
+        std::cerr << "Error: " << input << " is not a valid world file." << std::endl;
+        close(in);
+        return false;
+    }
+    uint64_t fileBytes = static_cast<uint64_t>(status.st_size);
+
+    // Die Eingabe wird nur gelesen; eingelagert sind immer nur die Seiten des aktuellen Fensters.
+    void* mapping = mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, in, 0);
+    close(in);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error mapping " << input << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    madvise(mapping, fileBytes, MADV_SEQUENTIAL);
+    char* base = static_cast<char*>(mapping);
+    const uint64_t* data = reinterpret_cast<const uint64_t*>(base + header.headerBytes);
+
+    const int height = header.height, width = header.width;
+    const size_t stride = header.strideWords;
+    const size_t rowBytes = stride * sizeof(uint64_t);
+    const int n = (width + 63) / 64;
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    Rule passRule = overrideRule ? rule : Rule(header.birthMask, header.survivalMask);
+
+    int out = createWorldFile(output, header.dataBytes);
+    if (out < 0) {
+        munmap(mapping, fileBytes);
+        return false;
+    }
+
+    // Drei eingelagerte Eingabebänder und zwei Ausgabepuffer teilen sich das Budget.
+    int bandRows = height > 0 ? rowsPerBand(memoryBudget, rowBytes, 5, height) : 0;
+    std::vector<uint64_t> buffers[2];
+    for (std::vector<uint64_t> &buffer : buffers) {
+        buffer.assign(static_cast<size_t>(bandRows) * stride, 0);  // Auffüllung der Zeilen bleibt 0
+    }
+    // Kopien für den toroidalen Rand: die Zeile über Zeile 0 und die unter der letzten Zeile.
+    std::vector<uint64_t> lastRow, firstRow;
+    if (height > 0) {
+        lastRow.assign(data + (height - 1) * stride, data + height * stride);
+        firstRow.assign(data, data + stride);
+    }
+
+    ThreadPool pool(threadCount);
+    std::vector<StepStats> threadStats(pool.size());
+    std::vector<uint64_t> threadPopulation(pool.size());
+    std::vector<uint64_t> threadChecksums(2 * pool.size());  // pro Thread Eingabe und Ausgabe
+    StepStats stats;
+    uint64_t population = 0;
+    uint64_t inputChecksum = 0, outputChecksum = 0;
+    size_t released = 0;  // Eingabe bis zu diesem Byte (seitenweise) bereits freigegeben
+
+    BandWriter writer(out);
+    int slot = 0;
+    for (int bandBegin = 0; bandBegin < height; bandBegin += bandRows) {
+        int bandEnd = bandBegin + bandRows < height ? bandBegin + bandRows : height;
+
+        // Einlesen des nächsten Bandes (samt der Zeile darunter) anstoßen, während dieses gerechnet wird.
+        if (bandEnd < height) {
+            int aheadEnd = bandEnd + bandRows + 1 < height ? bandEnd + bandRows + 1 : height;
+            size_t from = (header.headerBytes + bandEnd * rowBytes) / pageSize * pageSize;
+            size_t to = header.headerBytes + aheadEnd * rowBytes;
+            madvise(base + from, to - from, MADV_WILLNEED);
+        }
+
+        writer.waitFree(slot);
+        uint64_t* target = buffers[slot].data();
+        int parts = pool.size() > 1 && bandEnd - bandBegin > 1 ? pool.size() : 1;
+        auto work = [&](int index) {
+            std::pair<int, int> rows = ThreadPool::band(bandEnd - bandBegin, parts, index);
+            StepStats local;
+            uint64_t alive = 0, inputSum = 0, outputSum = 0;
+            for (int x = bandBegin + rows.first; x < bandBegin + rows.second; ++x) {
+                const uint64_t* up = x > 0 ? data + (x - 1) * stride : lastRow.data();
+                const uint64_t* mid = data + x * stride;
+                const uint64_t* down = x + 1 < height ? data + (x + 1) * stride : firstRow.data();
+                uint64_t* result = target + (x - bandBegin) * stride;
+                evolveRowRange(up, mid, down, result, n, width, 0, n, passRule);
+                accumulateWords(mid, result, n, static_cast<uint64_t>(x) * n, local);
+                for (int k = 0; k < n; ++k) {
+                    alive += __builtin_popcountll(result[k]);
+                }
+                // Die Prüfsummen beider Dateien sind Summen über Zeilen und entstehen, solange diese im Cache liegen.
+                inputSum += WorldFile::checksum(mid, stride, static_cast<uint64_t>(x) * stride);
+                outputSum += WorldFile::checksum(result, stride, static_cast<uint64_t>(x) * stride);
+            }
+            threadStats[index] = local;
+            threadPopulation[index] = alive;
+            threadChecksums[2 * index] = inputSum;
+            threadChecksums[2 * index + 1] = outputSum;
+        };
+        if (parts > 1) {
+            pool.run(work);
+        } else {
+            work(0);
+        }
+        for (int i = 0; i < parts; ++i) {
+            stats += threadStats[i];
+            population += threadPopulation[i];
+            inputChecksum += threadChecksums[2 * i];
+            outputChecksum += threadChecksums[2 * i + 1];
+        }
+
+        size_t bandWords = static_cast<size_t>(bandEnd - bandBegin) * stride;
+        writer.submit(slot, target, bandWords, static_cast<off_t>(header.headerBytes + bandBegin * rowBytes));
+        slot ^= 1;
+
+        // Alles vor der letzten Zeile des Bandes (dem oberen Nachbarn des nächsten Bandes) wird freigegeben.
+        size_t keep = (header.headerBytes + (bandEnd - 1) * rowBytes) / pageSize * pageSize;
+        if (keep > released) {
+            madvise(base + released, keep - released, MADV_DONTNEED);
+            released = keep;
+        }
+    }
+
+    bool ok = writer.finish();
+    munmap(mapping, fileBytes);
+    if (ok && inputChecksum != header.checksum) {
+        std::cerr << "Error: world file checksum mismatch in " << input << "." << std::endl;
+        ok = false;
+    }
+    WorldFile::Info info = {header.generation + 1, passRule.birthMask(), passRule.survivalMask()};
+    ok = ok && writeHeader(out, height, width, info, outputChecksum);
+    close(out);
+    if (!ok) {
+        std::remove(output.c_str());
+        return false;
+    }
+
+    result.generation = info.generation;
+    result.population = population;
+    result.changed = stats.changed;
+    result.bandRows = bandRows;
+    result.windowBytes = (3 * static_cast<size_t>(bandRows) + 2) * rowBytes + 2 * buffers[0].size() * sizeof(uint64_t);
+    return true;
+}
+
+bool StreamingEvolver::createRandom(const std::string &filename, int height, int width, double density, uint64_t seed,
+                                    const Rule &rule, size_t memoryBytes) {
+    if (height < 0 || width < 0) {
+        std::cerr << "Error: invalid world size." << std::endl;
+        return false;
+    }
+    size_t stride = BitGrid::strideForWidth(width);
+    size_t rowBytes = stride * sizeof(uint64_t);
+    uint64_t dataBytes = static_cast<uint64_t>(height) * rowBytes;
+    int fd = createWorldFile(filename, dataBytes);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Dieselbe Zelle wie in DistributedGrid::fillRandom(): Mischung aus Startwert und globaler Position.
+    auto mixBits = [](uint64_t z) {
+        z += 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    };
+    uint64_t threshold = density <= 0 ? 0 : density >= 1 ? ~0ULL : static_cast<uint64_t>(density * 18446744073709551616.0);
+
+    int bandRows = height > 0 ? rowsPerBand(memoryBytes, rowBytes, 1, height) : 0;
+    std::vector<uint64_t> band(static_cast<size_t>(bandRows) * stride);
+    uint64_t checksum = 0;
+    bool ok = true;
+    for (int bandBegin = 0; ok && bandBegin < height; bandBegin += bandRows) {
+        int bandEnd = bandBegin + bandRows < height ? bandBegin + bandRows : height;
+        std::fill(band.begin(), band.end(), 0);
+        for (int x = bandBegin; x < bandEnd; ++x) {
+            uint64_t* row = band.data() + (x - bandBegin) * stride;
+            for (int y = 0; y < width; ++y) {
+                uint64_t index = static_cast<uint64_t>(x) * static_cast<uint64_t>(width) + y;
+                if (mixBits(seed * 0x9E3779B97F4A7C15ULL + index) < threshold) {
+                    row[y >> 6] |= 1ULL << (y & 63);
+                }
+            }
+        }
+        size_t bandWords = static_cast<size_t>(bandEnd - bandBegin) * stride;
+        ok = writeAll(fd, band.data(), bandWords * sizeof(uint64_t),
+                      static_cast<off_t>(WorldFile::PAGE_BYTES + bandBegin * rowBytes));
+        checksum += WorldFile::checksum(band.data(), bandWords, static_cast<uint64_t>(bandBegin) * stride);
+    }
+    WorldFile::Info info = {0, rule.birthMask(), rule.survivalMask()};
+    ok = ok && writeHeader(fd, height, width, info, checksum);
+    close(fd);
+    if (!ok) {
+        std::remove(filename.c_str());
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef STREAMINGEVOLVER_H
+#define STREAMINGEVOLVER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "Rule.h"
+
+// Out-of-core-Berechnung für Welten, die nicht in den Arbeitsspeicher passen (z.B. 200000 x 200000).
+// Gerechnet wird von Datei zu Datei im binären Weltformat (WorldFile): die Eingabe ist eingeblendet
+// und wird in Bändern aus bandRows Zeilen durchlaufen. Zum Berechnen eines Bandes werden nur die
+// Zeilen davor und danach gebraucht, es sind also höchstens drei Bänder gleichzeitig eingelagert:
+// das vorige (für seine letzte Zeile), das aktuelle und das nächste, dessen Einlesen der Kern per
+// Readahead anstößt, während das aktuelle Band gerechnet wird. Bereits abgearbeitete Seiten werden
+// sofort wieder freigegeben. Für den toroidalen Rand werden die erste und die letzte Zeile vorab kopiert.
+//
+// Die Ergebnisbänder schreibt ein eigener Thread in die zweite Datei (zwei Puffer im Wechsel), sodass
+// Platte und Rechnung sich überlappen; die Prüfsummen beider Dateien bilden die Rechenthreads nebenher.
+// Der Speicherbedarf ergibt sich aus memoryBytes und hängt nicht von der Größe der Welt ab.
+// Mehrere Generationen rechnen abwechselnd in die Ausgabe und eine temporäre Datei daneben.
+class StreamingEvolver {
+    public:
+        struct Result {
+            long long generation;  // Generation der Ausgabedatei
+            uint64_t population;   // lebende Zellen der letzten Generation
+            uint64_t changed;      // veränderte Zellen der letzten Generation
+            int bandRows;          // Zeilen pro Band
+            size_t windowBytes;    // belegter Speicher für eingelagerte Bänder und Ausgabepuffer
+        };
+
+        // memoryBytes begrenzt Eingabefenster und Ausgabepuffer zusammen (mindestens eine Zeile pro Band);
+        // threads sind die Rechenthreads, 0 = alle Hardware-Threads.
+        explicit StreamingEvolver(size_t memoryBytes = 256u << 20, int threads = 0);
+
+        // Ersetzt die Regel der Eingabedatei.
+        void setRule(const Rule &newRule);
+
+        // Rechnet generations Generationen von input nach output (verschiedene Dateien).
+        bool evolve(const std::string &input, const std::string &output, long long generations);
+        const Result &getResult() const { return result; }
+
+        // Schreibt eine zufällige h x w Welt bandweise, ohne sie ganz im Speicher zu halten. Die Belegung
+        // hängt nur von seed und der Position ab und entspricht DistributedGrid::fillRandom().
+        static bool createRandom(const std::string &filename, int height, int width, double density, uint64_t seed,
+                                 const Rule &rule = Rule(), size_t memoryBytes = 256u << 20);
+
+    private:
+        size_t memoryBudget;
+        int threadCount;
+        bool overrideRule;
+        Rule rule;
+        Result result;
+
+        bool evolvePass(const std::string &input, const std::string &output);
+};
+
+#endif // STREAMINGEVOLVER_H
@@ -0,0 +1,132 @@
+#include "TemporalBlocking.h"
+#include "LifeKernels.h"
+#include "ThreadPool.h"
+#include <utility>
+
+TemporalBlockEngine::TemporalBlockEngine(int generations, int rowsPerTile, int wordsPerTile)
+    : generationsPerPass(1), tileRows(rowsPerTile > 0 ? rowsPerTile : 1),
+      tileWords(wordsPerTile > 0 ? wordsPerTile : 1), tilesY(0), tilesX(0),
+      nextTile(0) {
+    lastStats.changed = 1;  // vor dem ersten Durchlauf gilt das Gitter nicht als stabil
+    setGenerationsPerPass(generations);
+}
+
+void TemporalBlockEngine::setGenerationsPerPass(int generations) {
+    generationsPerPass = generations > 0 ? generations : 1;
+}
+
+void TemporalBlockEngine::evolveTile(const BitGrid &src, BitGrid &dst, int tile, int generations, uint64_t* buffers,
+                                     StepStats &stats) {
+    int height = src.getHeight();
+    int width = src.getWidth();
+    int n = src.getWordsPerRow();
+    int halo = (generations + 63) / 64;  // Randwörter links und rechts, mindestens 'generations' Spalten
+
+    int rowBegin = (tile / tilesX) * tileRows;
+    int rows = rowBegin + tileRows < height ? tileRows : height - rowBegin;
+    int wordBegin = (tile % tilesX) * tileWords;
+    int words = wordBegin + tileWords < n ? tileWords : n - wordBegin;
+
+    // Lokaler Puffer: Kachel plus 'generations' Zeilen oben und unten und 'halo' Wörter links und rechts.
+    int localRows = rows + 2 * generations;
+    int localWords = words + 2 * halo;
+    uint64_t* current = buffers;
+    uint64_t* next = buffers + static_cast<size_t>(localRows) * localWords;
+
+    // Kachel mit Rand aus dem Gitter kopieren; Zeilen und Spalten werden toroidal fortgesetzt.
+    int firstCol = ((wordBegin - halo) * 64 % width + width) % width;
+    for (int i = 0; i < localRows; ++i) {
+        int x = ((rowBegin - generations + i) % height + height) % height;
+        const uint64_t* line = src.row(x);
+        uint64_t* local = current + static_cast<size_t>(i) * localWords;
+        int col = firstCol;
+        for (int j = 0; j < localWords; ++j) {
+            local[j] = wrappedWord(line, width, col);
+            col = (col + 64) % width;
+        }
+    }
+
+    // k Generationen im lokalen Puffer. Der Rand wird dabei nicht korrekt fortgesetzt, aber die
+    // Fehler wandern pro Generation nur eine Zelle weiter; jede Generation kann deshalb eine
+    // Zeile oben und unten weniger berechnen.
+    for (int g = 1; g <= generations; ++g) {
+        for (int i = g; i < localRows - g; ++i) {
+            const uint64_t* mid = current + static_cast<size_t>(i) * localWords;
+            evolveRowRange(mid - localWords, mid, mid + localWords,
+                           next + static_cast<size_t>(i) * localWords, localWords, 64 * localWords, 0, localWords, rule);
+        }
+        std::swap(current, next);
+    }
+
+    // Mitte zurückschreiben, mit der vorletzten Generation vergleichen und den Hash bilden.
+    uint64_t lastMask = (wordBegin + words == n) ? dst.tailMask() : ~0ULL;
+    for (int i = 0; i < rows; ++i) {
+        const uint64_t* result = current + static_cast<size_t>(i + generations) * localWords + halo;
+        uint64_t* previous = next + static_cast<size_t>(i + generations) * localWords + halo;
+        uint64_t* out = dst.row(rowBegin + i) + wordBegin;
+        for (int j = 0; j < words - 1; ++j) {
+            out[j] = result[j];
+        }
+        out[words - 1] = result[words - 1] & lastMask;
+        previous[words - 1] &= lastMask;  // der lokale Puffer wird danach nicht mehr gebraucht
+        accumulateWords(previous, out, words, static_cast<uint64_t>(rowBegin + i) * n + wordBegin, stats);
+    }
+}
+
+StepStats TemporalBlockEngine::step(const BitGrid &src, BitGrid &dst, int generations, ThreadPool *pool) {
+    int height = src.getHeight();
+    int width = src.getWidth();
+    if (height == 0 || width == 0 || generations <= 0) {
+        return StepStats();
+    }
+    if (generations > generationsPerPass) {
+        generations = generationsPerPass;
+    }
+
+    int n = src.getWordsPerRow();
+    tilesY = (height + tileRows - 1) / tileRows;
+    tilesX = (n + tileWords - 1) / tileWords;
+
+    // Jeder Thread bekommt eigene lokale Puffer, die über die Durchläufe hinweg erhalten bleiben.
+    int threads = pool != nullptr ? pool->size() : 1;
+    int halo = (generationsPerPass + 63) / 64;
+    size_t bufferWords = static_cast<size_t>(tileRows + 2 * generationsPerPass) * (tileWords + 2 * halo);
+    if (static_cast<int>(scratch.size()) < threads) {
+        scratch.resize(threads);
+    }
+    for (int t = 0; t < threads; ++t) {
+        if (scratch[t].size() < 2 * bufferWords) {
+            scratch[t].assign(2 * bufferWords, 0);
+        }
+    }
+    partials.assign(threads, StepStats());
+
+    nextTile.store(0, std::memory_order_relaxed);
+
+    // Kacheln werden einzeln vergeben; jede Kachel ist groß genug, dass sich der Zähler nicht bemerkbar macht.
+    int total = tilesY * tilesX;
+    auto worker = [&](int index) {
+        uint64_t* buffers = scratch[index].data();
+        StepStats local;  // lokal summieren, damit sich die Threads keine Cache-Zeile teilen
+        while (true) {
+            int tile = nextTile.fetch_add(1, std::memory_order_relaxed);
+            if (tile >= total) {
+                break;
+            }
+            evolveTile(src, dst, tile, generations, buffers, local);
+        }
+        partials[index] = local;
+    };
+
+    if (threads > 1 && total > 1) {
+        pool->run(worker);
+    } else {
+        worker(0);
+    }
+
+    lastStats = StepStats();
+    for (const StepStats &partial : partials) {
+        lastStats += partial;
+    }
+    return lastStats;
+}
@@ -0,0 +1,47 @@
+#ifndef TEMPORALBLOCKING_H
+#define TEMPORALBLOCKING_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "BitGrid.h"
+#include "LifeKernels.h"
+
+class ThreadPool;
+
+// CPU-Engine mit zeitlicher Blockung: statt das ganze Gitter pro Generation einmal durch den
+// Hauptspeicher zu schieben, wird jede Kachel samt einem Rand von k Zellen in einen kleinen
+// lokalen Puffer kopiert, der im L1/L2-Cache bleibt, dort k Generationen weitergerechnet und
+// erst dann zurückgeschrieben. Fehler vom Rand des lokalen Puffers wandern pro Generation nur
+// eine Zelle nach innen, die Mitte der Kachel ist nach k Generationen also exakt.
+class TemporalBlockEngine {
+    private:
+        int generationsPerPass;  // k: Generationen pro Durchlauf
+        int tileRows, tileWords;
+        int tilesY, tilesX;
+        Rule rule;
+        std::vector<std::vector<uint64_t>> scratch;  // zwei lokale Puffer pro Thread
+        std::vector<StepStats> partials;             // Statistik pro Thread, am Ende aufsummiert
+        std::atomic<int> nextTile;
+        StepStats lastStats;
+
+        void evolveTile(const BitGrid &src, BitGrid &dst, int tile, int generations, uint64_t* buffers,
+                        StepStats &stats);
+
+    public:
+        TemporalBlockEngine(int generations = 8, int rowsPerTile = 128, int wordsPerTile = 32);
+
+        void setGenerationsPerPass(int generations);
+        int getGenerationsPerPass() const { return generationsPerPass; }
+        void setRule(const Rule &newRule) { rule = newRule; }
+
+        // Berechnet src nach 'generations' Generationen (höchstens getGenerationsPerPass()) in dst.
+        // Die Statistik bezieht sich auf die letzte Generation des Durchlaufs: veränderte Zellen
+        // gegenüber der vorletzten Generation und Hash des Ergebnisses.
+        StepStats step(const BitGrid &src, BitGrid &dst, int generations, ThreadPool *pool);
+
+        // true, wenn sich in der letzten Generation des letzten step() keine Zelle verändert hat.
+        bool lastGenerationStable() const { return lastStats.changed == 0; }
+};
+
+#endif // TEMPORALBLOCKING_H
@@ -0,0 +1,424 @@
+#include "TerminalRenderer.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+
+#ifdef _WIN32
+struct termios {};  // ohne POSIX-Terminal wird der Eingabemodus nicht umgestellt
+#else
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// Unicode-Zeichen der Darstellung.
+static const uint32_t UPPER_HALF = 0x2580;   // ▀
+static const uint32_t LOWER_HALF = 0x2584;   // ▄
+static const uint32_t FULL_BLOCK = 0x2588;   // █
+static const uint32_t BRAILLE_BASE = 0x2800;
+// Bit des Braille-Punkts für Bildpunkt (Zeile, Spalte) innerhalb eines Zeichens von 4 x 2 Punkten.
+static const uint8_t BRAILLE_DOTS[4][2] = { {0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80} };
+
+// Hängt ein Zeichen als UTF-8 an.
+static void appendGlyph(std::string &out, uint32_t glyph) {
+    if (glyph < 0x80) {
+        out += static_cast<char>(glyph);
+    } else if (glyph < 0x800) {
+        out += static_cast<char>(0xC0 | (glyph >> 6));
+        out += static_cast<char>(0x80 | (glyph & 0x3F));
+    } else {
+        out += static_cast<char>(0xE0 | (glyph >> 12));
+        out += static_cast<char>(0x80 | ((glyph >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (glyph & 0x3F));
+    }
+}
+
+// Cursor auf Zeile row, Spalte col (beide ab 1).
+static void appendMove(std::string &out, int row, int col) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "\x1b[%d;%dH", row, col);
+    out.append(buffer, length);
+}
+
+// Prüft, ob eines der Bits [begin, end) in words gesetzt ist.
+static bool anyBit(const uint64_t* words, int begin, int end) {
+    int first = begin >> 6;
+    int last = (end - 1) >> 6;
+    uint64_t lowMask = ~0ULL << (begin & 63);
+    uint64_t highMask = ~0ULL >> (63 - ((end - 1) & 63));
+    if (first == last) {
+        return (words[first] & lowMask & highMask) != 0;
+    }
+    if ((words[first] & lowMask) != 0 || (words[last] & highMask) != 0) {
+        return true;
+    }
+    for (int k = first + 1; k < last; ++k) {
+        if (words[k] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TerminalRenderer::TerminalRenderer()
+    : mode(Mode::Auto), originRow(0), originCol(0), scale(0), termRows(24), termCols(80), ansi(false),
+      active(false), redraw(true), lastScale(0), lastViewRows(0), lastViewCols(0) {}
+
+TerminalRenderer::~TerminalRenderer() {
+    end();
+}
+
+bool TerminalRenderer::parseMode(const std::string &name, Mode &result) {
+    const Mode modes[] = { Mode::Auto, Mode::Text, Mode::Blocks, Mode::Braille };
+    for (Mode m : modes) {
+        if (name == modeName(m)) {
+            result = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* TerminalRenderer::modeName(Mode m) {
+    switch (m) {
+        case Mode::Text:    return "text";
+        case Mode::Blocks:  return "blocks";
+        case Mode::Braille: return "braille";
+        default:            return "auto";
+    }
+}
+
+void TerminalRenderer::setMode(Mode m) {
+    mode = m;
+    redraw = true;
+}
+
+void TerminalRenderer::setViewport(int row, int col, int cellScale) {
+    originRow = row < 0 ? 0 : row;
+    originCol = col < 0 ? 0 : col;
+    scale = cellScale < 0 ? 0 : cellScale;
+}
+
+void TerminalRenderer::pan(int rows, int cols) {
+    // Die Grenzen werden beim nächsten Bild an die Gittergröße angepasst.
+    originRow = std::max(0, originRow + rows);
+    originCol = std::max(0, originCol + cols);
+}
+
+void TerminalRenderer::zoomIn() {
+    // Halbiert die Zellen pro Bildpunkt; die Mitte des Ausschnitts bleibt stehen.
+    int current = lastScale > 0 ? lastScale : 1;
+    if (current == 1) {
+        return;
+    }
+    originRow += lastViewRows / 4;
+    originCol += lastViewCols / 4;
+    scale = current / 2;
+}
+
+void TerminalRenderer::zoomOut() {
+    int current = lastScale > 0 ? lastScale : 1;
+    originRow = std::max(0, originRow - lastViewRows / 2);
+    originCol = std::max(0, originCol - lastViewCols / 2);
+    scale = current * 2;
+}
+
+void TerminalRenderer::fit() {
+    setViewport(0, 0, 0);
+}
+
+void TerminalRenderer::detectTerminalSize() {
+    int rows = 0, cols = 0;
+#ifndef _WIN32
+    struct winsize size;
+    if (ansi && ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) {
+        rows = size.ws_row;
+        cols = size.ws_col;
+    }
+#endif
+    if (rows <= 0 || cols <= 0) {
+        const char* lines = std::getenv("LINES");
+        const char* columns = std::getenv("COLUMNS");
+        rows = lines != nullptr ? std::atoi(lines) : 0;
+        cols = columns != nullptr ? std::atoi(columns) : 0;
+    }
+    rows = rows > 0 ? rows : 24;
+    cols = cols > 0 ? cols : 80;
+    if (rows != termRows || cols != termCols) {
+        termRows = rows;
+        termCols = cols;
+        redraw = true;
+    }
+}
+
+void TerminalRenderer::begin() {
+    if (active) {
+        return;
+    }
+#ifndef _WIN32
+    ansi = isatty(STDOUT_FILENO) != 0;
+#endif
+    detectTerminalSize();
+    frame.reserve(static_cast<size_t>(termRows) * termCols * 3 + 256);
+    redraw = true;
+    active = true;
+
+#ifndef _WIN32
+    if (ansi) {
+        frame.assign("\x1b[?25l");  // Cursor ausblenden
+        writeFrame();
+        // Tasten ohne Zeilenpuffer und Echo lesen, read() wartet nicht.
+        struct termios input;
+        if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &input) == 0) {
+            savedInput.reset(new termios(input));
+            input.c_lflag &= ~(ICANON | ECHO);
+            input.c_cc[VMIN] = 0;
+            input.c_cc[VTIME] = 0;
+            tcsetattr(STDIN_FILENO, TCSANOW, &input);
+        }
+    }
+#endif
+}
+
+void TerminalRenderer::end() {
+    if (!active) {
+        return;
+    }
+    active = false;
+#ifndef _WIN32
+    if (savedInput) {
+        tcsetattr(STDIN_FILENO, TCSANOW, savedInput.get());
+        savedInput.reset();
+    }
+    if (ansi) {
+        frame.assign("\x1b[?25h");  // Cursor wieder einblenden; er steht bereits unter dem Bild
+        writeFrame();
+    }
+#endif
+}
+
+void TerminalRenderer::handleInput() {
+#ifndef _WIN32
+    if (!savedInput) {
+        return;
+    }
+    char keys[64];
+    ssize_t count;
+    while ((count = read(STDIN_FILENO, keys, sizeof(keys))) > 0) {
+        int stepRows = std::max(1, lastViewRows / 4);
+        int stepCols = std::max(1, lastViewCols / 4);
+        for (ssize_t i = 0; i < count; ++i) {
+            char key = keys[i];
+            // Pfeiltasten kommen als ESC [ A..D.
+            if (key == '\x1b' && i + 2 < count && keys[i + 1] == '[') {
+                const char arrows[] = { 'A', 'B', 'C', 'D' };
+                const char letters[] = { 'k', 'j', 'l', 'h' };
+                for (int a = 0; a < 4; ++a) {
+                    if (keys[i + 2] == arrows[a]) {
+                        key = letters[a];
+                    }
+                }
+                i += 2;
+            }
+            switch (key) {
+                case 'k': case 'w': pan(-stepRows, 0); break;
+                case 'j': case 's': pan(stepRows, 0); break;
+                case 'h': case 'a': pan(0, -stepCols); break;
+                case 'l': case 'd': pan(0, stepCols); break;
+                case '+': case '=': zoomIn(); break;
+                case '-': zoomOut(); break;
+                case '0': fit(); break;
+                default: break;
+            }
+        }
+    }
+#endif
+}
+
+void TerminalRenderer::sampleRow(const BitGrid &grid, int firstRow, int rowCount, int firstCol, int colCount,
+                                 int cellScale, uint8_t* out, int pixelCount) {
+    // ODER der Zeilen, die ein Bildpunkt umfasst, nur über die Wörter des Ausschnitts.
+    int firstWord = firstCol >> 6;
+    int lastWord = (firstCol + colCount - 1) >> 6;
+    int words = lastWord - firstWord + 1;
+    rowOr.assign(words, 0);
+    for (int x = firstRow; x < firstRow + rowCount; ++x) {
+        const uint64_t* row = grid.row(x) + firstWord;
+        for (int k = 0; k < words; ++k) {
+            rowOr[k] |= row[k];
+        }
+    }
+
+    int base = firstCol - (firstWord << 6);  // erste Spalte relativ zu rowOr
+    int limit = base + colCount;
+    for (int p = 0; p < pixelCount; ++p) {
+        int begin = base + p * cellScale;
+        int end = std::min(begin + cellScale, limit);
+        out[p] = cellScale == 1 ? static_cast<uint8_t>((rowOr[begin >> 6] >> (begin & 63)) & 1ULL)
+                                : static_cast<uint8_t>(anyBit(rowOr.data(), begin, end));
+    }
+}
+
+void TerminalRenderer::compose(const BitGrid &grid, long long generation) {
+    int height = grid.getHeight();
+    int width = grid.getWidth();
+    int rowsAvailable = std::max(1, termRows - 3);  // Kopfzeile, Zeile für Meldungen, Eingabezeile
+    int colsAvailable = std::max(1, termCols);
+
+    Mode m = mode;
+    if (m == Mode::Auto) {
+        m = scale <= 1 && height <= rowsAvailable && width <= colsAvailable ? Mode::Text : Mode::Braille;
+    }
+    int pixelsPerRow = m == Mode::Braille ? 4 : (m == Mode::Blocks ? 2 : 1);  // Bildpunkte pro Zeichen
+    int pixelsPerCol = m == Mode::Braille ? 2 : 1;
+
+    int s = scale;
+    if (s <= 0) {
+        s = std::max((height + rowsAvailable * pixelsPerRow - 1) / (rowsAvailable * pixelsPerRow),
+                     (width + colsAvailable * pixelsPerCol - 1) / (colsAvailable * pixelsPerCol));
+        s = std::max(s, 1);
+    }
+    int viewRows = std::min<long long>(height, static_cast<long long>(rowsAvailable) * pixelsPerRow * s);
+    int viewCols = std::min<long long>(width, static_cast<long long>(colsAvailable) * pixelsPerCol * s);
+    originRow = std::max(0, std::min(originRow, height - viewRows));
+    originCol = std::max(0, std::min(originCol, width - viewCols));
+    lastScale = s;
+    lastViewRows = viewRows;
+    lastViewCols = viewCols;
+
+    int pixelRows = (viewRows + s - 1) / s;
+    int pixelCols = (viewCols + s - 1) / s;
+    int charRows = (pixelRows + pixelsPerRow - 1) / pixelsPerRow;
+    int charCols = (pixelCols + pixelsPerCol - 1) / pixelsPerCol;
+
+    composed.resize(1 + charRows);
+    char header[256];
+    int length = std::snprintf(header, sizeof(header), "Generation %lld   rows %d-%d of %d, cols %d-%d of %d, 1:%d %s%s",
+                               generation, originRow, originRow + viewRows - 1, height, originCol,
+                               originCol + viewCols - 1, width, s, modeName(m),
+                               savedInput ? "   [arrows pan, +/- zoom, 0 fit]" : "");
+    length = std::min(std::max(length, 0), std::min(static_cast<int>(sizeof(header)) - 1, termCols));
+    composed[0].assign(header, header + length);
+
+    pixels.resize(static_cast<size_t>(pixelsPerRow) * pixelCols);
+    for (int c = 0; c < charRows; ++c) {
+        for (int k = 0; k < pixelsPerRow; ++k) {
+            uint8_t* out = &pixels[static_cast<size_t>(k) * pixelCols];
+            int pixelRow = c * pixelsPerRow + k;
+            if (pixelRow < pixelRows && viewCols > 0) {
+                int first = originRow + pixelRow * s;
+                sampleRow(grid, first, std::min(s, originRow + viewRows - first), originCol, viewCols, s, out, pixelCols);
+            } else {
+                std::fill(out, out + pixelCols, 0);
+            }
+        }
+
+        std::vector<uint32_t> &line = composed[1 + c];
+        line.resize(charCols);
+        for (int j = 0; j < charCols; ++j) {
+            if (m == Mode::Text) {
+                line[j] = pixels[j] ? 'O' : '.';
+            } else if (m == Mode::Blocks) {
+                bool top = pixels[j] != 0;
+                bool bottom = pixels[pixelCols + j] != 0;
+                line[j] = top ? (bottom ? FULL_BLOCK : UPPER_HALF) : (bottom ? LOWER_HALF : ' ');
+            } else {
+                uint32_t dots = 0;
+                for (int r = 0; r < 4; ++r) {
+                    for (int q = 0; q < 2 && 2 * j + q < pixelCols; ++q) {
+                        dots |= pixels[static_cast<size_t>(r) * pixelCols + 2 * j + q] ? BRAILLE_DOTS[r][q] : 0;
+                    }
+                }
+                line[j] = dots != 0 ? BRAILLE_BASE + dots : ' ';
+            }
+        }
+    }
+}
+
+void TerminalRenderer::emit() {
+    frame.clear();
+    if (!ansi) {
+        // Ohne Terminal: jedes Bild vollständig, ohne Steuerzeichen.
+        for (const std::vector<uint32_t> &line : composed) {
+            for (uint32_t glyph : line) {
+                appendGlyph(frame, glyph);
+            }
+            frame += '\n';
+        }
+        writeFrame();
+        return;
+    }
+
+    if (redraw) {
+        frame += "\x1b[H\x1b[2J";
+        screen.clear();
+        redraw = false;
+    }
+    // Pro Zeile nur den Abschnitt vom ersten bis zum letzten veränderten Zeichen schreiben.
+    static const std::vector<uint32_t> empty;
+    for (size_t r = 0; r < composed.size(); ++r) {
+        const std::vector<uint32_t> &now = composed[r];
+        const std::vector<uint32_t> &before = r < screen.size() ? screen[r] : empty;
+        size_t common = std::min(now.size(), before.size());
+        size_t first = 0;
+        while (first < common && now[first] == before[first]) {
+            ++first;
+        }
+        if (first == now.size() && now.size() == before.size()) {
+            continue;  // unverändert
+        }
+        size_t last = std::max(now.size(), before.size());
+        while (last > first && last <= common && now[last - 1] == before[last - 1]) {
+            --last;
+        }
+        appendMove(frame, static_cast<int>(r) + 1, static_cast<int>(first) + 1);
+        for (size_t j = first; j < std::min(last, now.size()); ++j) {
+            appendGlyph(frame, now[j]);
+        }
+        if (now.size() < before.size()) {
+            frame += "\x1b[K";  // Rest der alten, längeren Zeile löschen
+        }
+    }
+    if (composed.size() < screen.size()) {
+        appendMove(frame, static_cast<int>(composed.size()) + 1, 1);
+        frame += "\x1b[J";  // das Bild ist kürzer geworden
+    }
+    // Cursor unter das Bild, damit Meldungen dort erscheinen.
+    appendMove(frame, static_cast<int>(composed.size()) + 1, 1);
+    screen.swap(composed);
+    writeFrame();
+}
+
+void TerminalRenderer::writeFrame() {
+    std::cout.flush();  // vorher mit std::cout geschriebene Meldungen zuerst
+#ifdef _WIN32
+    std::fwrite(frame.data(), 1, frame.size(), stdout);
+    std::fflush(stdout);
+#else
+    size_t written = 0;
+    while (written < frame.size()) {
+        ssize_t count = write(STDOUT_FILENO, frame.data() + written, frame.size() - written);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;  // Ausgabe geschlossen; das Bild geht verloren, die Simulation läuft weiter
+        }
+        written += static_cast<size_t>(count);
+    }
+#endif
+}
+
+void TerminalRenderer::render(const BitGrid &grid, long long generation) {
+    begin();
+    detectTerminalSize();
+    handleInput();
+    if (grid.getHeight() <= 0 || grid.getWidth() <= 0) {
+        composed.assign(1, std::vector<uint32_t>());
+    } else {
+        compose(grid, generation);
+    }
+    emit();
+}
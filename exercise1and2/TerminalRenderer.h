@@ -0,0 +1,77 @@
+#ifndef TERMINALRENDERER_H
+#define TERMINALRENDERER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "BitGrid.h"
+
+struct termios;
+
+// Gibt ein BitGrid im Terminal aus. Jedes Bild wird in einem vorab reservierten Puffer aufgebaut
+// und mit einem einzigen write() ausgegeben. Im Terminal werden nach dem ersten Bild nur die
+// veränderten Abschnitte jeder Zeile per ANSI-Cursorsteuerung neu geschrieben; ohne Terminal
+// (Umleitung in eine Datei) wird jedes Bild vollständig und ohne Steuerzeichen geschrieben.
+//
+// Dargestellt wird ein Ausschnitt des Gitters: Ein Bildpunkt fasst scale x scale Zellen zusammen
+// und ist gesetzt, wenn darin eine Zelle lebt. Je nach Modus ist ein Zeichen ein Bildpunkt ('O'/'.'),
+// zwei übereinanderliegende (Halbblöcke) oder 2 x 4 Bildpunkte (Braille). Mit scale = 0 wird das
+// ganze Gitter in das Terminal eingepasst. Im Terminal verschieben Pfeiltasten oder hjkl/wasd den
+// Ausschnitt, '+' und '-' zoomen und '0' passt wieder ein.
+class TerminalRenderer {
+    public:
+        enum class Mode { Auto, Text, Blocks, Braille };
+
+    private:
+        Mode mode;
+        int originRow, originCol;  // linke obere Zelle des Ausschnitts
+        int scale;                 // Zellen pro Bildpunkt und Richtung, 0 = einpassen
+        int termRows, termCols;
+        bool ansi;                 // die Ausgabe ist ein Terminal
+        bool active;               // zwischen begin() und end()
+        bool redraw;               // das nächste Bild wird vollständig geschrieben
+        std::unique_ptr<termios> savedInput;  // Eingabemodus vor begin(), falls umgestellt
+
+        // Zustand des letzten Bildes, für Tasten und Differenzen.
+        int lastScale, lastViewRows, lastViewCols;
+        std::vector<std::vector<uint32_t>> screen;    // Zeichen pro Zeile, wie sie im Terminal stehen
+        std::vector<std::vector<uint32_t>> composed;  // Zeichen des neuen Bildes
+        std::string frame;                            // Ausgabepuffer
+        std::vector<uint64_t> rowOr;                  // ODER der Gitterzeilen eines Bildpunkts
+        std::vector<uint8_t> pixels;                  // Bildpunkte einer Zeichenzeile
+
+        void detectTerminalSize();
+        void handleInput();
+        void compose(const BitGrid &grid, long long generation);
+        void sampleRow(const BitGrid &grid, int firstRow, int rowCount, int firstCol, int colCount,
+                       int cellScale, uint8_t* out, int pixelCount);
+        void emit();
+        void writeFrame();
+
+    public:
+        TerminalRenderer();
+        ~TerminalRenderer();  // stellt das Terminal wieder her
+
+        static bool parseMode(const std::string &name, Mode &mode);
+        static const char* modeName(Mode mode);
+
+        void setMode(Mode mode);
+        Mode getMode() const { return mode; }
+        // Ausschnitt ab Zelle (row, col) mit scale Zellen pro Bildpunkt (0 = ganzes Gitter).
+        void setViewport(int row, int col, int scale);
+        void pan(int rows, int cols);
+        void zoomIn();
+        void zoomOut();
+        void fit();
+
+        // Vor dem ersten Bild eines Laufs: Terminalgröße ermitteln, Cursor ausblenden, Tasten
+        // ohne Zeilenpuffer lesen. end() stellt alles wieder her und setzt den Cursor unter das Bild.
+        void begin();
+        void end();
+
+        // Gibt das Gitter mit einer Kopfzeile aus (ruft begin() selbst auf, falls nötig).
+        void render(const BitGrid &grid, long long generation);
+};
+
+#endif // TERMINALRENDERER_H
@@ -0,0 +1,89 @@
+#include "ThreadPool.h"
+
+Barrier::Barrier(int count) : threshold(count), waiting(0), phase(0) {}
+
+void Barrier::arriveAndWait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    unsigned long long myPhase = phase;
+    if (++waiting == threshold) {
+        // Der letzte ankommende Thread öffnet die Barriere für die nächste Phase.
+        waiting = 0;
+        ++phase;
+        cv.notify_all();
+        return;
+    }
+    cv.wait(lock, [&] { return phase != myPhase; });
+}
+
+int ThreadPool::resolveThreadCount(int threads) {
+    if (threads > 0) {
+        return threads;
+    }
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? static_cast<int>(hardware) : 1;
+}
+
+ThreadPool::ThreadPool(int threads)
+    : doneBarrier(resolveThreadCount(threads)),
+      job(nullptr),
+      epoch(0),
+      stopping(false) {
+    // Der aufrufende Thread arbeitet selbst mit, daher werden nur threads - 1 Arbeiter gestartet.
+    int count = resolveThreadCount(threads);
+    for (int i = 1; i < count; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        ++epoch;
+    }
+    startSignal.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop(int index) {
+    unsigned long long seen = 0;
+    while (true) {
+        const std::function<void(int)>* task;
+        {
+            // Warte auf den nächsten Auftrag (neue Epoche) oder auf das Beenden des Pools.
+            std::unique_lock<std::mutex> lock(mutex);
+            startSignal.wait(lock, [&] { return epoch != seen; });
+            seen = epoch;
+            if (stopping) {
+                return;
+            }
+            task = job;
+        }
+        (*task)(index);
+        doneBarrier.arriveAndWait();
+    }
+}
+
+void ThreadPool::run(const std::function<void(int)> &task) {
+    if (workers.empty()) {
+        task(0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &task;
+        ++epoch;
+    }
+    startSignal.notify_all();
+    task(0);
+    // Einziger Synchronisationspunkt pro Auftrag: alle Bänder sind fertig.
+    doneBarrier.arriveAndWait();
+}
+
+std::pair<int, int> ThreadPool::band(int total, int parts, int index) {
+    long long begin = static_cast<long long>(total) * index / parts;
+    long long end = static_cast<long long>(total) * (index + 1) / parts;
+    return { static_cast<int>(begin), static_cast<int>(end) };
+}
@@ -0,0 +1,59 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+
+// Wiederverwendbare Barriere für eine feste Anzahl von Threads (std::barrier gibt es erst ab C++20).
+class Barrier {
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        int threshold;
+        int waiting;
+        unsigned long long phase;
+
+    public:
+        explicit Barrier(int count);
+        void arriveAndWait();
+};
+
+// Persistenter Thread-Pool: die Arbeiter werden einmal gestartet und leben so lange wie der Pool
+// (z.B. für die gesamte Dauer von Grid::run()). Pro Generation wird nur ein Auftrag verteilt
+// und am Ende einmal an der Barriere synchronisiert, statt jedes Mal neue Threads zu erzeugen.
+class ThreadPool {
+    private:
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable startSignal;
+        Barrier doneBarrier;
+        const std::function<void(int)>* job;
+        unsigned long long epoch;
+        bool stopping;
+
+        void workerLoop(int index);
+
+    public:
+        // threads == 0 wählt die Anzahl der Hardware-Threads.
+        explicit ThreadPool(int threads);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        int size() const { return static_cast<int>(workers.size()) + 1; }
+
+        // Führt job(index) auf allen Threads aus; der aufrufende Thread übernimmt Index 0.
+        // Kehrt erst zurück, wenn alle Threads ihren Teil erledigt haben.
+        void run(const std::function<void(int)> &task);
+
+        // Liefert Band index von parts gleich großen, zusammenhängenden Bändern des Bereichs [0, total).
+        static std::pair<int, int> band(int total, int parts, int index);
+
+        static int resolveThreadCount(int threads);
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,202 @@
+#include "WorldFile.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static_assert(sizeof(WorldHeader) == 64, "WorldHeader must keep its on-disk size");
+
+static const char WORLD_MAGIC[8] = {'G', 'O', 'L', 'W', 'O', 'R', 'L', 'D'};
+
+// Beitrag eines Wortes zur Prüfsumme. Die Mischfunktion (Finalisierer von SplitMix64) ist für jede
+// Position umkehrbar, ein einzelnes verändertes Wort ändert die Summe also immer.
+static inline uint64_t checksumWord(uint64_t word, uint64_t position) {
+    uint64_t x = word ^ (position * 0x9E3779B97F4A7C15ULL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t WorldFile::checksum(const uint64_t* words, size_t count, uint64_t position) {
+    // Die Beiträge hängen nicht voneinander ab, beim Laden begrenzt nur das Lesen der Seiten.
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += checksumWord(words[i], position + i);
+    }
+    return sum;
+}
+
+bool WorldFile::isWorldFile(const std::string &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[8];
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+    return std::memcmp(magic, WORLD_MAGIC, sizeof(magic)) == 0;
+}
+
+void WorldFile::fillHeader(WorldHeader &header, int height, int width, const Info &info) {
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, WORLD_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.headerBytes = PAGE_BYTES;
+    header.height = height;
+    header.width = width;
+    header.strideWords = static_cast<uint32_t>(BitGrid::strideForWidth(width));
+    header.birthMask = info.birthMask;
+    header.survivalMask = info.survivalMask;
+    header.generation = info.generation;
+    header.dataBytes = static_cast<uint64_t>(height) * header.strideWords * sizeof(uint64_t);
+}
+
+bool WorldFile::save(const std::string &filename, const BitGrid &grid, const Info &info) {
+    size_t dataWords = static_cast<size_t>(grid.getHeight()) * grid.getStride();
+    const uint64_t* data = grid.getHeight() > 0 ? grid.row(0) : nullptr;
+
+    // Die Kopfseite ist mit Nullen aufgefüllt, damit spätere Versionen Felder ergänzen können.
+    std::vector<char> page(PAGE_BYTES, 0);
+    WorldHeader header;
+    fillHeader(header, grid.getHeight(), grid.getWidth(), info);
+    header.checksum = checksum(data, dataWords);
+    std::memcpy(page.data(), &header, sizeof(header));
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file!" << std::endl;
+        return false;
+    }
+    file.write(page.data(), page.size());
+
+    // Zeilen in großen Blöcken aus ganzen Seiten schreiben; nur der letzte Block wird aufgefüllt.
+    const size_t chunkBytes = 256 * PAGE_BYTES;
+    const char* bytes = reinterpret_cast<const char*>(data);
+    size_t remaining = header.dataBytes;
+    while (remaining >= chunkBytes) {
+        file.write(bytes, chunkBytes);
+        bytes += chunkBytes;
+        remaining -= chunkBytes;
+    }
+    size_t wholePages = remaining / PAGE_BYTES * PAGE_BYTES;
+    if (wholePages > 0) {
+        file.write(bytes, wholePages);
+        bytes += wholePages;
+        remaining -= wholePages;
+    }
+    if (remaining > 0) {
+        std::memset(page.data(), 0, page.size());
+        std::memcpy(page.data(), bytes, remaining);
+        file.write(page.data(), page.size());
+    }
+
+    if (!file) {
+        std::cerr << "Error writing file!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WorldFile::validHeader(const WorldHeader &header, uint64_t fileBytes) {
+    if (std::memcmp(header.magic, WORLD_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << "Error: not a binary world file." << std::endl;
+        return false;
+    }
+    if (header.version != VERSION) {
+        std::cerr << "Error: unsupported world file version " << header.version << "." << std::endl;
+        return false;
+    }
+    if (header.height < 0 || header.width < 0 || header.headerBytes != PAGE_BYTES ||
+        header.strideWords != static_cast<uint32_t>(BitGrid::strideForWidth(header.width)) ||
+        header.dataBytes != static_cast<uint64_t>(header.height) * header.strideWords * sizeof(uint64_t) ||
+        header.headerBytes + header.dataBytes > fileBytes) {
+        std::cerr << "Error: corrupt world file header." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WorldFile::load(const std::string &filename, BitGrid &grid, Info &info) {
+    WorldHeader header;
+#ifdef _WIN32
+    // Ohne mmap wird die Datei in eigenen Speicher gelesen.
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file!" << std::endl;
+        return false;
+    }
+    uint64_t fileBytes = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+    if (fileBytes < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        !validHeader(header, fileBytes)) {
+        return false;
+    }
+    BitGrid loaded(header.height, header.width);
+    file.seekg(header.headerBytes);
+    if (header.dataBytes > 0 && !file.read(reinterpret_cast<char*>(loaded.row(0)), header.dataBytes)) {
+        std::cerr << "Error reading file!" << std::endl;
+        return false;
+    }
+    const uint64_t* data = header.dataBytes > 0 ? loaded.row(0) : nullptr;
+    if (checksum(data, header.dataBytes / sizeof(uint64_t)) != header.checksum) {
+        std::cerr << "Error: world file checksum mismatch." << std::endl;
+        return false;
+    }
+    grid.swap(loaded);
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error opening file!" << std::endl;
+        std::cerr << "Error code: " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || static_cast<uint64_t>(status.st_size) < sizeof(header)) {
+        std::cerr << "Error: world file too small." << std::endl;
+        close(fd);
+        return false;
+    }
+    uint64_t fileBytes = static_cast<uint64_t>(status.st_size);
+
+    // Privat einblenden: die Simulation darf das Gitter verändern, ohne die Datei zu überschreiben.
+    void* mapping = mmap(nullptr, fileBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);  // die Einblendung bleibt auch nach dem Schließen gültig
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error mapping file: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::memcpy(&header, mapping, sizeof(header));
+    uint64_t* data = reinterpret_cast<uint64_t*>(static_cast<char*>(mapping) + WorldFile::PAGE_BYTES);
+    if (!validHeader(header, fileBytes)) {
+        munmap(mapping, fileBytes);
+        return false;
+    }
+
+    // Die Prüfsumme liest jede Seite einmal der Reihe nach.
+    madvise(mapping, fileBytes, MADV_SEQUENTIAL);
+    if (checksum(data, header.dataBytes / sizeof(uint64_t)) != header.checksum) {
+        std::cerr << "Error: world file checksum mismatch." << std::endl;
+        munmap(mapping, fileBytes);
+        return false;
+    }
+    madvise(mapping, fileBytes, MADV_NORMAL);
+
+    size_t mappedBytes = static_cast<size_t>(fileBytes);
+    grid.adopt(header.height, header.width, header.dataBytes > 0 ? data : nullptr,
+               [mapping, mappedBytes]() { munmap(mapping, mappedBytes); });
+#endif
+
+    info.generation = header.generation;
+    info.birthMask = header.birthMask;
+    info.survivalMask = header.survivalMask;
+    return true;
+}
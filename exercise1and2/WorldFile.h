@@ -0,0 +1,63 @@
+#ifndef WORLDFILE_H
+#define WORLDFILE_H
+
+#include <cstdint>
+#include <string>
+#include "BitGrid.h"
+
+// Binäres, versioniertes Weltformat.
+// Aufbau: eine Kopfseite (4096 Byte) mit WorldHeader, danach die Zeilen bitgepackt im Layout von
+// BitGrid (jede Zeile auf 64 Byte ausgerichtet, Auffüllung 0), aufgefüllt auf ganze Seiten.
+// Weil das Layout dem Speicher entspricht, kann die Datei beim Laden direkt eingeblendet werden.
+struct WorldHeader {
+    char magic[8];          // "GOLWORLD"
+    uint32_t version;       // Formatversion, derzeit 2 (1: verkettete Prüfsumme)
+    uint32_t headerBytes;   // Beginn der Zeilen in der Datei
+    int32_t height;
+    int32_t width;
+    uint32_t strideWords;   // Wörter pro Zeile inklusive Auffüllung
+    uint32_t birthMask;     // Bit n: Geburt bei n Nachbarn
+    uint32_t survivalMask;  // Bit n: Überleben bei n Nachbarn
+    uint32_t reserved;
+    int64_t generation;     // Generation, in der der Zustand gespeichert wurde
+    uint64_t dataBytes;     // Größe der Zeilen ohne Auffüllung auf ganze Seiten
+    uint64_t checksum;      // Prüfsumme über die Zeilen (siehe WorldFile::checksum())
+};
+
+class WorldFile {
+    public:
+        static const uint32_t VERSION = 2;
+        static const uint32_t PAGE_BYTES = 4096;
+        static const uint32_t CONWAY_BIRTH = 1u << 3;                   // B3
+        static const uint32_t CONWAY_SURVIVAL = (1u << 2) | (1u << 3);  // S23
+
+        // Metadaten, die zusammen mit dem Gitter gespeichert werden.
+        struct Info {
+            long long generation;
+            uint32_t birthMask;
+            uint32_t survivalMask;
+        };
+
+        // Prüft anhand der Kennung, ob die Datei im binären Format vorliegt.
+        static bool isWorldFile(const std::string &filename);
+
+        // Schreibt Kopfseite und Zeilen in ganzen Seiten.
+        static bool save(const std::string &filename, const BitGrid &grid, const Info &info);
+
+        // Blendet die Datei privat ein (Copy-on-Write) und verwendet sie ohne Kopie als Speicher von grid.
+        // Kennung, Version, Größe und Prüfsumme werden geprüft; bei Fehlern bleibt grid unverändert.
+        static bool load(const std::string &filename, BitGrid &grid, Info &info);
+
+        // Füllt alle Felder des Kopfes außer der Prüfsumme für ein h x w Gitter.
+        static void fillHeader(WorldHeader &header, int height, int width, const Info &info);
+        // Prüft den Kopf gegen die Dateigröße und das erwartete Layout (mit Fehlermeldung).
+        static bool validHeader(const WorldHeader &header, uint64_t fileBytes);
+
+        // Prüfsumme über count Wörter, die in der Datei ab dem Wortindex position (gezählt ab der ersten
+        // Zeile) liegen: die Summe modulo 2^64 der Beiträge aller Wörter, jeder abhängig von Wert und
+        // Position. Die Teilsummen beliebiger Abschnitte, z.B. der Blöcke mehrerer Prozesse oder der
+        // Bänder beim Streamen, werden einfach addiert; die Reihenfolge der Berechnung spielt keine Rolle.
+        static uint64_t checksum(const uint64_t* words, size_t count, uint64_t position = 0);
+};
+
+#endif // WORLDFILE_H
@@ -1,27 +1,322 @@
-__kernel void evolve(__global char* current, __global char* next, int height, int width, __global char* debug) {
-    int x = get_global_id(0);
-    int y = get_global_id(1);
-
-    int count = 0;
-    for (int dx = -1; dx <= 1; ++dx) {
-        for (int dy = -1; dy <= 1; ++dy) {
-            if (dx != 0 || dy != 0) {
-                int nx = (x + dx + height) % height;
-                int ny = (y + dy + width) % width;
-                count += (current[nx * width + ny] == '0');
-            }
+// Abstimmbare Parameter, werden vom Host pro Gerät per -D gesetzt (siehe OpenCLEngine::Tuning).
+// LOCAL_X x LOCAL_Y Work-Items bilden eine Gruppe, jedes Work-Item berechnet CELLS_PER_ITEM
+// nebeneinanderliegende Zellen einer Zeile.
+#ifndef LOCAL_X
+#define LOCAL_X 16
+#endif
+#ifndef LOCAL_Y
+#define LOCAL_Y 8
+#endif
+#ifndef CELLS_PER_ITEM
+#define CELLS_PER_ITEM 4
+#endif
+
+// Regel in B/S-Notation als Bitmasken (Bit n: Geburt bzw. Überleben bei n Nachbarn), vom Host per
+// -D gesetzt (siehe Rule.h); ohne Angabe Conway B3/S23. Als Konstanten faltet der Compiler die
+// Regel in die Kernel, es bleibt weder eine Tabelle noch eine Verzweigung pro Zelle.
+#ifndef BIRTH_MASK
+#define BIRTH_MASK 0x008
+#endif
+#ifndef SURVIVAL_MASK
+#define SURVIVAL_MASK 0x00C
+#endif
+
+#define TILE_W (LOCAL_X * CELLS_PER_ITEM)
+#define TILE_H LOCAL_Y
+#define HALO_W (TILE_W + 2)
+#define HALO_H (TILE_H + 2)
+#define GROUP_SIZE (LOCAL_X * LOCAL_Y)
+
+// Beitrag einer lebenden Zelle zum Zustands-Hash (Mischfunktion nach splitmix64).
+// Der Hash ist eine Summe über die Zellen und hängt daher nicht von der Aufteilung in Gruppen ab.
+inline ulong cellHash(ulong index) {
+    ulong h = (index + 1) * 0x9E3779B97F4A7C15UL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9UL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBUL;
+    return h ^ (h >> 31);
+}
+
+// Zellen sind Bytes mit 0 (tot) oder 1 (lebendig), zeilenweise gespeichert.
+// Jede Gruppe lädt ihre Kachel samt einem Zellen breiten Rand einmal in den lokalen Speicher;
+// die toroidale Modulo-Rechnung wird nur für Kacheln am Rand des Gitters gebraucht.
+// Als Nebenprodukt schreibt jede Gruppe nach stats[2 * Gruppe] die Anzahl ihrer veränderten Zellen
+// und nach stats[2 * Gruppe + 1] ihren Anteil am Zustands-Hash; der Host summiert die Gruppen.
+// Mit -D GOL_DEBUG schreibt der Kernel zusätzlich 6 Debug-Zeichen pro Zelle.
+__kernel __attribute__((reqd_work_group_size(LOCAL_X, LOCAL_Y, 1)))
+void evolve(__global const uchar* current, __global uchar* next, int height, int width,
+            __global ulong* stats
+#ifdef GOL_DEBUG
+            , __global char* debug
+#endif
+            ) {
+    __local uchar tile[HALO_H][HALO_W];
+    __local ulong changedSums[GROUP_SIZE];
+    __local ulong hashSums[GROUP_SIZE];
+
+    int lx = get_local_id(0);
+    int ly = get_local_id(1);
+    int col0 = get_group_id(0) * TILE_W;  // erste Spalte der Kachel
+    int row0 = get_group_id(1) * TILE_H;  // erste Zeile der Kachel
+
+    // Liegt die Kachel samt Rand vollständig im Gitter, wird ohne Modulo geladen.
+    bool interior = row0 >= 1 && col0 >= 1 && row0 + TILE_H < height && col0 + TILE_W < width;
+
+    for (int i = ly * LOCAL_X + lx; i < HALO_H * HALO_W; i += LOCAL_X * LOCAL_Y) {
+        int tr = i / HALO_W;
+        int tc = i - tr * HALO_W;
+        int r = row0 + tr - 1;
+        int c = col0 + tc - 1;
+        if (!interior) {
+            r = (r + height) % height;
+            c = (c + width) % width;
+        }
+        tile[tr][tc] = current[r * width + c];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // Work-Items unterhalb des Gitters rechnen nichts, müssen aber die Barrieren der Reduktion erreichen.
+    int x = row0 + ly;
+    bool rowValid = x < height;
+    ulong changed = 0;
+    ulong hash = 0;
+
+    // Gleitende Spaltensummen: jede Spalte der drei Zeilen wird nur einmal addiert.
+    int tr = ly + 1;
+    int tcBase = lx * CELLS_PER_ITEM + 1;
+    int left = tile[tr - 1][tcBase - 1] + tile[tr][tcBase - 1] + tile[tr + 1][tcBase - 1];
+    int middle = tile[tr - 1][tcBase] + tile[tr][tcBase] + tile[tr + 1][tcBase];
+
+    for (int k = 0; k < CELLS_PER_ITEM; ++k) {
+        int tc = tcBase + k;
+        int right = tile[tr - 1][tc + 1] + tile[tr][tc + 1] + tile[tr + 1][tc + 1];
+        int y = col0 + tc - 1;
+        int alive = tile[tr][tc];
+        int count = left + middle + right - alive;
+
+        if (rowValid && y < width) {
+            int index = x * width + y;
+            uchar result = (uchar)(((BIRTH_MASK | (SURVIVAL_MASK << 9)) >> (count + 9 * alive)) & 1);
+            next[index] = result;
+            changed += result != alive;
+            hash += result ? cellHash((ulong)index) : 0;
+#ifdef GOL_DEBUG
+            debug[index * 6] = 'C';
+            debug[index * 6 + 1] = (char)('0' + x / 10);
+            debug[index * 6 + 2] = (char)('0' + x % 10);
+            debug[index * 6 + 3] = (char)('0' + y / 10);
+            debug[index * 6 + 4] = (char)('0' + y % 10);
+            debug[index * 6 + 5] = next[index] ? '0' : '.';
+#endif
+        }
+
+        left = middle;
+        middle = right;
+    }
+
+    // Baumreduktion im lokalen Speicher; funktioniert auch für Gruppengrößen, die keine Zweierpotenz sind.
+    int id = ly * LOCAL_X + lx;
+    changedSums[id] = changed;
+    hashSums[id] = hash;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int active = GROUP_SIZE; active > 1; ) {
+        int half = (active + 1) / 2;
+        if (id < active - half) {
+            changedSums[id] += changedSums[id + half];
+            hashSums[id] += hashSums[id + half];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+        active = half;
+    }
+    if (id == 0) {
+        int group = get_group_id(1) * get_num_groups(0) + get_group_id(0);
+        stats[2 * group] = changedSums[0];
+        stats[2 * group + 1] = hashSums[0];
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// Ensemble: viele unabhängige Welten in zwei Puffern (siehe Ensemble.h). Zeilen-Welten liegen
+// bitgepackt (64 Zellen pro ulong, Bit j von Wort k ist Spalte 64 * k + j) und ohne Auffüllung
+// hintereinander; gleich große Welten liegen zu je 64 bitweise verschränkt im Scheibenpuffer.
+
+// Wahrheitstabelle der Regel für die Nachbarzahlen 0..7: Eintrag ones + 2 * twos + 4 * fours + 8 * mid.
+#define RULE_TABLE ((BIRTH_MASK & 0xFF) | ((SURVIVAL_MASK & 0xFF) << 8))
+#define RULE_ENTRY(i) (((RULE_TABLE >> (i)) & 1) ? ~0UL : 0UL)
+
+// Wählt bitweise high, wo select gesetzt ist; mit konstanten Eingängen bleibt davon meist nur
+// select, ~select, eine Konstante oder einer der Eingänge übrig.
+inline ulong muxBits(ulong low, ulong high, ulong select) {
+    return (low & ~select) | (high & select);
+}
+
+// Volladdierer-Netz wie ruleWord() auf dem Host: die Nachbarzahl als Bits ones, twos, fours und
+// eights (nur bei 8), ausgewertet über einen Multiplexer-Baum aus den Konstanten der Regel.
+inline ulong ruleWord(ulong upW, ulong upC, ulong upE, ulong midW, ulong mid, ulong midE,
+                      ulong downW, ulong downC, ulong downE) {
+    ulong u0 = upW ^ upC ^ upE;
+    ulong u1 = (upW & upC) | (upE & (upW ^ upC));
+    ulong m0 = midW ^ midE;
+    ulong m1 = midW & midE;
+    ulong d0 = downW ^ downC ^ downE;
+    ulong d1 = (downW & downC) | (downE & (downW ^ downC));
+    ulong ones = u0 ^ m0 ^ d0;
+    ulong c0 = (u0 & m0) | (d0 & (u0 ^ m0));
+    ulong p = u1 ^ m1;
+    ulong q = d1 ^ c0;
+    ulong pp = u1 & m1;
+    ulong qq = d1 & c0;
+    ulong twos = p ^ q;
+    ulong fours = pp ^ qq ^ (p & q);
+    ulong eights = pp & qq;
+
+    ulong byOnes[8];
+    for (int i = 0; i < 8; ++i) {
+        byOnes[i] = muxBits(RULE_ENTRY(2 * i), RULE_ENTRY(2 * i + 1), ones);
+    }
+    ulong byTwos[4];
+    for (int i = 0; i < 4; ++i) {
+        byTwos[i] = muxBits(byOnes[2 * i], byOnes[2 * i + 1], twos);
+    }
+    ulong result = muxBits(muxBits(byTwos[0], byTwos[1], fours), muxBits(byTwos[2], byTwos[3], fours), mid);
+
+    // Bei 8 Nachbarn sind ones, twos und fours 0 wie bei 0 Nachbarn; unterscheiden sich die beiden
+    // Einträge, wird das Ergebnis dort umgedreht.
+    if (((BIRTH_MASK >> 8) ^ BIRTH_MASK) & 1) {
+        result ^= eights & ~mid;
+    }
+    if (((SURVIVAL_MASK >> 8) ^ SURVIVAL_MASK) & 1) {
+        result ^= eights & mid;
+    }
+    return result;
+}
+
+// Westnachbarn von Wort k einer Zeile mit n Wörtern; am linken Rand toroidal aus der letzten Spalte.
+inline ulong westWord(__global const ulong* r, int k, int n, int tailBits) {
+    ulong carry = k > 0 ? r[k - 1] >> 63 : (r[n - 1] >> (tailBits - 1)) & 1UL;
+    return (r[k] << 1) | carry;
+}
+
+// Ostnachbarn von Wort k; im letzten Wort landet Spalte 0 an der Position der letzten Spalte.
+inline ulong eastWord(__global const ulong* r, int k, int n, int tailBits) {
+    if (k < n - 1) {
+        return (r[k] >> 1) | (r[k + 1] << 63);
+    }
+    return (r[k] >> 1) | ((r[0] & 1UL) << (tailBits - 1));
+}
+
+// Ein Work-Item pro Zeile über alle Zeilen-Welten. Jede Welt wird mit ihrer eigenen Größe
+// toroidal umgebrochen; Zeilen stabiler Welten werden übersprungen. Pro Zeile wird nur vermerkt,
+// ob sich etwas verändert hat; ensemble_reduce fasst das pro Welt zusammen.
+__kernel void ensemble_rows(__global const ulong* current, __global ulong* next,
+                            __global const uint* rowWorld, __global const uint* worldFirstRow,
+                            __global const int* worldHeight, __global const int* worldWidth,
+                            __global const ulong* worldOffset, __global const uchar* status,
+                            __global uint* rowChanged, uint rowCount) {
+    uint g = get_global_id(0);
+    if (g >= rowCount) {
+        return;
+    }
+    uint world = rowWorld[g];
+    if (status[world]) {
+        return;
+    }
+
+    int height = worldHeight[world];
+    int width = worldWidth[world];
+    int n = (width + 63) / 64;
+    int tailBits = width - 64 * (n - 1);
+    ulong tailMask = tailBits == 64 ? ~0UL : ((1UL << tailBits) - 1);
+    int x = (int)(g - worldFirstRow[world]);
+
+    __global const ulong* base = current + worldOffset[world];
+    __global const ulong* up = base + (size_t)((x - 1 + height) % height) * n;
+    __global const ulong* mid = base + (size_t)x * n;
+    __global const ulong* down = base + (size_t)((x + 1) % height) * n;
+    __global ulong* out = next + worldOffset[world] + (size_t)x * n;
+
+    ulong changed = 0;
+    for (int k = 0; k < n; ++k) {
+        ulong result = ruleWord(westWord(up, k, n, tailBits), up[k], eastWord(up, k, n, tailBits),
+                                westWord(mid, k, n, tailBits), mid[k], eastWord(mid, k, n, tailBits),
+                                westWord(down, k, n, tailBits), down[k], eastWord(down, k, n, tailBits));
+        if (k == n - 1) {
+            result &= tailMask;  // Bits hinter der letzten Spalte bleiben 0
         }
+        out[k] = result;
+        changed |= result ^ mid[k];
+    }
+    rowChanged[g] = changed != 0;
+}
+
+// Ein Work-Item pro Wort des Scheiben-Layouts: Bit i von Wort (x, y) einer Gruppe ist Zelle (x, y)
+// der i-ten Welt, die Nachbarn sind die Nachbarwörter. Die Gruppe eines Wortes wird binär über die
+// aufsteigenden Anfänge gesucht. Veränderte Bits werden pro Gruppe in batchChanged (zwei uint, da
+// 64-Bit-Atomics optional sind) gesammelt; der Puffer wird vor jedem Schritt vom Host geleert.
+__kernel void ensemble_slices(__global const ulong* current, __global ulong* next,
+                              __global const ulong* batchOffset, __global const int* batchHeight,
+                              __global const int* batchWidth, uint batchCount, ulong sliceWords,
+                              __global uint* batchChanged) {
+    ulong g = get_global_id(0);
+    if (g >= sliceWords) {
+        return;
     }
+    uint lo = 0;
+    uint hi = batchCount - 1;
+    while (lo < hi) {
+        uint probe = (lo + hi + 1) / 2;
+        if (batchOffset[probe] <= g) {
+            lo = probe;
+        } else {
+            hi = probe - 1;
+        }
+    }
+
+    int height = batchHeight[lo];
+    int width = batchWidth[lo];
+    int cell = (int)(g - batchOffset[lo]);
+    int x = cell / width;
+    int y = cell - x * width;
+    int west = y == 0 ? width - 1 : y - 1;
+    int east = y + 1 == width ? 0 : y + 1;
 
-    int index = x * width + y;
-    int cell_state = (current[index] == '0');
-    next[index] = (cell_state ? (count == 2 || count == 3) : (count == 3)) ? '0' : '.';
+    __global const ulong* base = current + batchOffset[lo];
+    __global const ulong* up = base + (size_t)(x == 0 ? height - 1 : x - 1) * width;
+    __global const ulong* mid = base + (size_t)x * width;
+    __global const ulong* down = base + (size_t)(x + 1 == height ? 0 : x + 1) * width;
 
-    // Write debug information
-    debug[index * 6] = 'C';
-    debug[index * 6 + 1] = (char)('0' + x / 10);
-    debug[index * 6 + 2] = (char)('0' + x % 10);
-    debug[index * 6 + 3] = (char)('0' + y / 10);
-    debug[index * 6 + 4] = (char)('0' + y % 10);
-    debug[index * 6 + 5] = next[index];
+    ulong result = ruleWord(up[west], up[y], up[east], mid[west], mid[y], mid[east],
+                            down[west], down[y], down[east]);
+    next[g] = result;
+    ulong changed = result ^ mid[y];
+    if (changed != 0) {
+        atomic_or(&batchChanged[2 * lo], (uint)changed);
+        atomic_or(&batchChanged[2 * lo + 1], (uint)(changed >> 32));
+    }
+}
+
+// Ein Work-Item pro Welt: liest, ob sich die Welt verändert hat (Zeilen-Welten über ihre Zeilen,
+// verschränkte Welten über ihr Bit der Gruppe), zählt die Generation und markiert sie sonst als stabil.
+__kernel void ensemble_reduce(__global const uint* rowChanged, __global const uint* batchChanged,
+                              __global const int* worldBatch, __global const int* worldLane,
+                              __global const uint* worldFirstRow, __global const int* worldHeight,
+                              __global uchar* status, __global long* generations, uint worldCount) {
+    uint world = get_global_id(0);
+    if (world >= worldCount || status[world]) {
+        return;
+    }
+    uint changed = 0;
+    int batch = worldBatch[world];
+    if (batch >= 0) {
+        int lane = worldLane[world];
+        changed = (batchChanged[2 * batch + lane / 32] >> (lane % 32)) & 1;
+    } else {
+        uint first = worldFirstRow[world];
+        for (int x = 0; x < worldHeight[world]; ++x) {
+            changed |= rowChanged[first + x];
+        }
+    }
+    generations[world] += 1;
+    if (changed == 0) {
+        status[world] = 1;
+    }
 }
@@ -3,6 +3,7 @@
 #include <vector>
 #include <chrono>
 #include <fstream>
+#include <thread>
 
 
 void CLI::run() {
@@ -23,12 +24,8 @@ void CLI::run() {
                 world.addBeacon(5, 5);
             }
 
-            auto start_time = std::chrono::high_resolution_clock::now();
-            world.evolve(); 
-            auto end_time = std::chrono::high_resolution_clock::now();
-
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-            total_time += duration.count();
+            // Eine Generation über die öffentliche Schnittstelle; run() liefert die Rechenzeit in ms.
+            total_time += world.run(1, 0);
         }
 
         long long average_time = total_time / num_runs;
@@ -37,9 +34,49 @@ void CLI::run() {
         std::cout << "Average time for grid size (" << height << ", " << width << "): " << average_time << " ms\n";
     }
 
+    // Skalierung der CPU-Version über die Anzahl der Threads (1, 2, 4, ... bis alle Hardware-Threads).
+    std::vector<std::pair<int, int>> scaling_sizes = {{1000, 1000}, {10000, 10000}};
+    int scaling_generations = 20;
+    int max_threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::vector<std::vector<long long>> scaling_times;
+    for (auto& size : scaling_sizes) {
+        std::vector<long long> row;
+        for (int threads : thread_counts) {
+            long long total_time = 0;
+            for (int run = 0; run < num_runs; ++run) {
+                Grid world(size.first, size.second);
+                world.setPrintEnabled(false);
+                world.setThreadCount(threads);
+                total_time += world.run(scaling_generations, 0);
+            }
+            row.push_back(total_time / num_runs);
+            std::cout << "Average CPU time for grid size (" << size.first << ", " << size.second << ") with "
+                      << threads << " threads: " << row.back() << " ms\n";
+        }
+        scaling_times.push_back(row);
+    }
+
+    // Beide Reihen stehen in times.txt; die Kopfzeile nennt die Hardware-Threads, auf denen gemessen wurde.
     std::ofstream outfile("times.txt");
     for (size_t i = 0; i < sizes.size(); ++i) {
         outfile << sizes[i].first << " " << sizes[i].second << " " << times[i] << "\n";
     }
+    outfile << "\n# CPU thread scaling, " << scaling_generations << " generations, " << max_threads
+            << " hardware threads: height width threads ms\n";
+    for (size_t i = 0; i < scaling_sizes.size(); ++i) {
+        for (size_t t = 0; t < thread_counts.size(); ++t) {
+            outfile << scaling_sizes[i].first << " " << scaling_sizes[i].second << " "
+                    << thread_counts[t] << " " << scaling_times[i][t] << "\n";
+        }
+    }
     outfile.close();
 }